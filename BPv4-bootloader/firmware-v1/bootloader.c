@@ -7,6 +7,7 @@ void usbbufservice(void);
 void bootloader(void);
 void usb_handler(void);
 void WritePage(void);
+void PageCRC(void);
 void __builtin_write_NVM(void);
 void __builtin_tblwtl(unsigned int offset, unsigned int data);
 void __builtin_tblwth(unsigned int offset, unsigned int data);
@@ -22,7 +23,7 @@ BYTE bldone = 0;
 extern BYTE cdc_In_buffer[64];
 extern BYTE cdc_Out_buffer[64];
 #define VER_H 0x04
-#define VER_L 0x0a
+#define VER_L 0x0c
 
 unsigned int userversion  __attribute__((space(prog),address(BLENDADDR-9))) = ((VER_H<<8)|VER_L); 
 
@@ -37,7 +38,10 @@ struct _bootstruct {
     BYTE cmd;
     BYTE datasize;
     BYTE checksum;
-    BYTE data[64 * 3];
+    BYTE replysize;
+    BYTE reply[2];
+    BYTE rowsize;
+    BYTE data[(64 * 3) + 2]; //row, plus sequence and flags of command 4
 
 } bootstruct;
 
@@ -70,6 +74,7 @@ void bootloader(void) {
 
 	//if no errors below we return K for OK
     bootstruct.blreturn = 'K';
+    bootstruct.replysize = 1;
 
     // MAIN BOOTLOADER LOOP HERE
     do {
@@ -77,7 +82,13 @@ error:
         	usb_handler();
         	WaitInReady();
             cdc_In_buffer[0] = bootstruct.blreturn; //answer OK
-            putUnsignedCharArrayUsbUsart(cdc_In_buffer, 1);
+            cdc_In_buffer[1] = bootstruct.reply[0]; //extra reply bytes of commands 3 and 4
+            cdc_In_buffer[2] = bootstruct.reply[1];
+            putUnsignedCharArrayUsbUsart(cdc_In_buffer, bootstruct.replysize);
+
+			//status is reported once, start the next command clean
+            bootstruct.blreturn = 'K';
+            bootstruct.replysize = 1;
 			
 			crc=0;
 
@@ -98,8 +109,10 @@ error:
 			//get data, if any
             if (bootstruct.datasize > 1) {
                 for (i = 0; i < bootstruct.datasize - 1; i++) {
-                    usbbufgetbyte(&bootstruct.data[i]);
-					crc+=bootstruct.data[i];
+                    usbbufgetbyte(&inbyte);
+					crc+=inbyte;
+                    if (i < sizeof(bootstruct.data)) //never overrun on a garbled length
+                        bootstruct.data[i] = inbyte;
                 }
             }
 	
@@ -109,6 +122,10 @@ error:
             // TODO add checksum computation and check
 			if(crc!=0){
 				bootstruct.blreturn='N';//return checksum error
+				if(bootstruct.cmd==4){//echo the sequence so the loader can resend the row
+					bootstruct.reply[0]=bootstruct.data[64 * 3];
+					bootstruct.replysize=2;
+				}
 				goto error;
 
 			}
@@ -127,7 +144,24 @@ error:
 	                bootstruct.enableerase = 1;        
 	                break;
 	            case 2: //protect the bootloader and write the row
+	                bootstruct.rowsize = bootstruct.datasize - 1;
+	                WritePage();
+	                break;
+	            case 3: //return the CRC of the page, lets the loader skip unchanged pages
+	                PageCRC();
+	                bootstruct.replysize = 3;
+	                break;
+	            case 4: //sequenced row write, data is row, sequence, flags (bit 0 erase page first)
+	                bootstruct.reply[0] = bootstruct.data[64 * 3];
+	                bootstruct.replysize = 2;
+	                if (bootstruct.datasize != ((64 * 3) + 3)) {
+	                    bootstruct.blreturn = 'U';
+	                    break;
+	                }
+	                bootstruct.rowsize = 64 * 3;
+	                bootstruct.enableerase = bootstruct.data[(64 * 3) + 1] & 0x01;
 	                WritePage();
+	                bootstruct.enableerase = 0; //never carried over, a protected row skips the erase
 	                break;
 				case 0xff:
 					 U1CONbits.USBEN=0; //USB off
@@ -145,6 +179,46 @@ error:
     } while (!bldone);
 }
 
+//CRC16-CCITT (0x1021, init 0xFFFF) of one page, bytes in the same
+//order the loader sends them: upper, low, high byte of each word
+void PageCRC() {
+    unsigned int pagecrc;
+    unsigned int offset;
+    unsigned int i;
+    unsigned int dataword;
+    BYTE b, k;
+
+    pagecrc = 0xFFFF;
+    offset = (unsigned int) fulladdress;
+
+    for (i = 0; i < (3 * PAGESIZER * ROWSIZEW); i++) {
+        switch (i % 3) {
+            case 0:
+                dataword = __builtin_tblrdl(offset);
+                b = (BYTE) __builtin_tblrdh(offset);
+                break;
+            case 1:
+                b = (BYTE) dataword;
+                break;
+            default:
+                b = (BYTE) (dataword >> 8);
+                offset += 2;
+                break;
+        }
+
+        pagecrc ^= ((unsigned int) b << 8);
+        for (k = 0; k < 8; k++) {
+            if (pagecrc & 0x8000)
+                pagecrc = (pagecrc << 1) ^ 0x1021;
+            else
+                pagecrc = pagecrc << 1;
+        }
+    }
+
+    bootstruct.reply[0] = (BYTE) (pagecrc >> 8);
+    bootstruct.reply[1] = (BYTE) pagecrc;
+}
+
 void WritePage() {
     BYTE i;
     int dataword;
@@ -217,7 +291,7 @@ void WritePage() {
 
         NVMCON = 0x4001; //setup row writes
 		//write data to buffer
-        for (i = 0; i < (bootstruct.datasize-1);)
+        for (i = 0; i < bootstruct.rowsize;)
         {
             dataword = bootstruct.data[i];
             __builtin_tblwth(offset, dataword);
@@ -237,7 +311,7 @@ void WritePage() {
         offset = (unsigned int) fulladdress;
         bootstruct.blreturn = 'K';
 		//read data back and compare
-        for (i = 0; i < (bootstruct.datasize-1);)
+        for (i = 0; i < bootstruct.rowsize;)
         {
             dataword = __builtin_tblrdh((unsigned int) (offset));
             dataword &= 0xFF;
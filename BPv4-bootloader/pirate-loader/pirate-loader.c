@@ -2,10 +2,22 @@
 
  Pirate-Loader for Bootloader v4
 
- Version  : 1.0.3
+ Version  : 1.3.0
 
  Changelog:
 
+  + 2026-10-19 - Table-driven single pass HEX parser over a memory mapped file,
+                 decoded image cache ( --cache=/path/to/dir ) keyed by the HEX
+                 file path and checked against the hash of its contents,
+                 parser benchmark ( --benchmark )
+
+  + 2026-10-19 - Added windowed row writes ( --window=N ), up to N sequenced rows
+                 in flight with per-row resend (needs bootloader 4.12+),
+                 programming speed is reported in rows/sec
+
+  + 2026-10-19 - Added differential flashing ( --diff ), pages whose CRC matches
+                 the HEX image are not erased or rewritten (needs bootloader 4.11+)
+
   + 2016-08-22 - Migrated to CMake, minor fixes.
 
   + 2010-06-28 - Made HEX parser case-insensitive
@@ -54,10 +66,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <memory.h>
+#include <string.h>
 #include <fcntl.h>
 #include <errno.h>
 
-#define PIRATE_LOADER_VERSION "1.0.3"
+#define PIRATE_LOADER_VERSION "1.3.0"
 
 #define STR_EXPAND(tok) #tok
 #define OS_NAME(tok) STR_EXPAND(tok)
@@ -182,6 +195,8 @@ unsigned int sleep(unsigned int sec)
 #include <sys/select.h>
 #include <sys/types.h>
 #include <sys/time.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 #endif
 
 /* macro definitions */
@@ -199,11 +214,25 @@ typedef unsigned long  uint32;
 #define BOOTLOADER_HELLO_STR "\xC1"
 #define BOOTLOADER_OK 0x4B
 #define BOOTLOADER_PROT 'P'
+#define BOOTLOADER_CMD_ERASE 0x01
+#define BOOTLOADER_CMD_WRITE 0x02
+#define BOOTLOADER_CMD_PAGE_CRC 0x03
+#define BOOTLOADER_CMD_WRITE_SEQ 0x04
+#define BOOTLOADER_PAGE_CRC_VERSION 0x040B //first bootloader answering BOOTLOADER_CMD_PAGE_CRC
+#define BOOTLOADER_WRITE_SEQ_VERSION 0x040C //first bootloader answering BOOTLOADER_CMD_WRITE_SEQ
+#define BOOTLOADER_CRC_ERROR 'N'
+#define BOOTLOADER_VERIFY_ERROR 'V'
+#define WRITE_SEQ_ERASE 0x01
+#define MAX_WINDOW 64
+#define MAX_RESENDS 16
 #define PIC_WORD_SIZE  (3)
 #define PIC_NUM_ROWS_IN_PAGE  8
 #define PIC_NUM_WORDS_IN_ROW 64
 #define PIC_ROW_SIZE  (PIC_NUM_WORDS_IN_ROW * PIC_WORD_SIZE)
 #define PIC_PAGE_SIZE (PIC_NUM_ROWS_IN_PAGE  * PIC_ROW_SIZE)
+
+//a failed reply queues at most a page of rows, for every row in the window
+#define RESEND_QUEUE_SIZE (MAX_WINDOW * PIC_NUM_ROWS_IN_PAGE)
 #define PIC_ROW_ADDR(p,r)		(((p) * PIC_PAGE_SIZE) + ((r) * PIC_ROW_SIZE))
 #define PIC_WORD_ADDR(p,r,w)	(PIC_ROW_ADDR(p,r) + ((w) * PIC_WORD_SIZE))
 #define PIC_PAGE_ADDR(p)		(PIC_PAGE_SIZE * (p))
@@ -231,8 +260,13 @@ unsigned long blendaddr = 0x23FFL; // not currently used
 uint8		g_verbose = 0;
 uint8		g_hello_only = 0;
 uint8		g_simulate = 0;
+uint8		g_diff = 0;
+uint32		g_window = 0;
+uint16		g_bootloader_version = 0;
 const char* g_device_path  = NULL;
 const char* g_hexfile_path = NULL;
+const char* g_cache_dir = NULL;
+uint8		g_benchmark = 0;
 
 /* functions */
 
@@ -275,62 +309,135 @@ int readWithTimeout(int fd, uint8* out, int length, int timeout)
     return got;
 }
 
-unsigned char hexdec(const char* pc)
+uint32 getMilliseconds(void)
+{
+#ifdef WIN32
+    return GetTickCount();
+#else
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
+#endif
+}
+
+/* ASCII to nibble, 0xFF for anything that is not a hex digit */
+uint8 g_hex_table[256];
+
+void initHexTable(void)
 {
-    unsigned char temp;
+    int i = 0;
+
+    memset(g_hex_table, 0xFF, sizeof(g_hex_table));
 
-    if(pc[0]>='a')
+    for(i=0; i<10; i++)
     {
-        temp=pc[0]-'a'+10;
+        g_hex_table['0' + i] = i;
     }
-    else if(pc[0] >= 'A')
+
+    for(i=0; i<6; i++)
     {
-        temp=pc[0]-'A'+10;
+        g_hex_table['A' + i] = 10 + i;
+        g_hex_table['a' + i] = 10 + i;
     }
-    else
+}
+
+void dumpHex(uint8* buf, uint32 len)
+{
+    uint32 i=0;
+
+    for(i=0; i<len; i++)
     {
-        temp=pc[0] - '0';
+        printf("%02X ", buf[i]);
     }
-    temp=temp<<4;
+    putchar('\n');
+}
 
-    if(pc[1]>='a')
+/* maps the whole file read-only, returns NULL on error or empty file */
+const uint8* mapFile(const char* file, unsigned long* size)
+{
+#ifdef WIN32
+    HANDLE hFile = NULL, hMap = NULL;
+    const uint8* view = NULL;
+
+    hFile = CreateFileA(file, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if( hFile == INVALID_HANDLE_VALUE )
     {
-        temp|=pc[1]-'a'+10;
+        return NULL;
     }
-    else if(pc[1] >= 'A')
+
+    *size = GetFileSize(hFile, NULL);
+
+    if( *size > 0 && *size != INVALID_FILE_SIZE )
     {
-        temp|=pc[1]-'A'+10;
+        hMap = CreateFileMapping(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+        if( hMap )
+        {
+            view = (const uint8*)MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(hMap);
+        }
     }
-    else
+
+    CloseHandle(hFile);
+    return view;
+#else
+    struct stat st;
+    void* view = NULL;
+    int fd = open(file, O_RDONLY);
+
+    if( fd < 0 )
     {
-        temp|=pc[1] - '0';
+        return NULL;
     }
 
-    return(temp & 0x0FF);
+    if( fstat(fd, &st) < 0 || st.st_size == 0 )
+    {
+        close(fd);
+        return NULL;
+    }
 
+    *size = st.st_size;
+    view  = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
 
-    //return (((pc[0] >= 'A') ? ( pc[0] - 'A' + 10 ) : ( pc[0] - '0' ) ) << 4 |
-    //		((pc[1] >= 'A') ? ( pc[1] - 'A' + 10 ) : ( pc[1] - '0' ) )) & 0x0FF;
+    return (view == MAP_FAILED) ? NULL : (const uint8*)view;
+#endif
+}
 
+void unmapFile(const uint8* view, unsigned long size)
+{
+#ifdef WIN32
+    UnmapViewOfFile(view);
+#else
+    munmap((void*)view, size);
+#endif
 }
 
-void dumpHex(uint8* buf, uint32 len)
+/* FNV-1a, keys the image cache */
+unsigned long long hashBuffer(const uint8* buf, unsigned long len)
 {
-    uint32 i=0;
+    unsigned long long hash = 0xCBF29CE484222325ULL;
+    unsigned long i = 0;
 
     for(i=0; i<len; i++)
     {
-        printf("%02X ", buf[i]);
+        hash ^= buf[i];
+        hash *= 0x100000001B3ULL;
     }
-    putchar('\n');
+
+    return hash;
 }
 
-int readHEX(const char* file, uint8* bout, unsigned long max_length, uint8* pages_used)
+/*
+ * Single pass over the HEX text: every record is decoded through
+ * g_hex_table and its checksum is checked before the data is placed.
+ */
+int parseHEX(const uint8* text, unsigned long size, uint8* bout, uint8* pages_used)
 {
     static const uint32 HEX_DATA_OFFSET = 4;
     uint8  linebin[256] = {0};
     uint8* data = (linebin + HEX_DATA_OFFSET);
-    uint8  hex_crc, hex_type, hex_len;
+    uint8  hex_crc, hex_type, hex_len, hi, lo;
     uint32 hex_addr;
     uint32 hex_base_addr = 0;
     uint32 hex_words     = 0;
@@ -340,38 +447,28 @@ int readHEX(const char* file, uint8* bout, unsigned long max_length, uint8* page
 
     uint32 num_words = 0;
 
-    char  line[512] = {0};
-    char  *pc;
-    char  *pline = line + 1;
+    const uint8* pc  = text;
+    const uint8* end = text + size;
+    const uint8* eol = NULL;
     int   res = 0;
     int	  binlen = 0;
     int   line_no = 0;
     int   i = 0;
 
-    FILE* fp = fopen(file, "rb");
-
-    if( !fp )
-    {
-        return -1;
-    }
-
-    while( !feof(fp) && fgets(line, sizeof(line) - 1, fp) )
+    while( pc < end )
     {
         line_no++;
 
-        if( line[0] != ':' )
+        if( *pc != ':' )
         {
             break;
         }
 
-        res = strlen(pline);
-        pc  = pline + res - 1;
+        pc++;
 
-        while( pc > pline && *pc <= ' ' )
-        {
-            *pc-- = 0;
-            res--;
-        }
+        for( eol = pc; eol < end && g_hex_table[*eol] != 0xFF; eol++ );
+
+        res = eol - pc;
 
         if( res & 0x01 || res > 512 || res < 10)
         {
@@ -380,14 +477,30 @@ int readHEX(const char* file, uint8* bout, unsigned long max_length, uint8* page
         }
 
         hex_crc = 0;
+        binlen  = res / 2;
 
-        for( pc = pline, i = 0; i<res; i+=2, pc+=2 )
+        for( i = 0; i<binlen; i++, pc+=2 )
         {
-            linebin[i >> 1] = hexdec(pc);
-            hex_crc += linebin[i >> 1];
+            hi = g_hex_table[pc[0]];
+            lo = g_hex_table[pc[1]];
+            linebin[i] = (hi << 4) | lo;
+            hex_crc += linebin[i];
         }
 
-        binlen = res / 2;
+        //only whitespace may follow the record
+        for( ; pc < end && *pc != '\n'; pc++ )
+        {
+            if( *pc > ' ' )
+            {
+                fprintf(stderr, "Invalid character on line %d\n", line_no);
+                return -1;
+            }
+        }
+
+        if( pc < end )
+        {
+            pc++;
+        }
 
         if( hex_crc != 0 )
         {
@@ -452,10 +565,319 @@ int readHEX(const char* file, uint8* bout, unsigned long max_length, uint8* page
 
     }
 
+    return num_words;
+}
+
+/*
+ * Image cache: one file per HEX path holding the file size and hash, the
+ * word count, the pages_used map and the decoded contents of each used
+ * page. The HEX is hashed on every load and the entry is only used if the
+ * contents did not change; the file time is not trusted, a rebuild within
+ * the same second or a copy with its time kept would go unnoticed.
+ */
+#define IMAGE_CACHE_MAGIC "PLC3"
+#define IMAGE_CACHE_HEADER_SIZE 24
+
+void putCache64(uint8* buf, unsigned long long value)
+{
+    int i = 0;
+
+    for(i=0; i<8; i++)
+    {
+        buf[i] = (uint8)(value >> (56 - (i * 8)));
+    }
+}
+
+unsigned long long getCache64(const uint8* buf)
+{
+    unsigned long long value = 0;
+    int i = 0;
+
+    for(i=0; i<8; i++)
+    {
+        value = (value << 8) | buf[i];
+    }
+
+    return value;
+}
+
+void makeCachePath(char* path, unsigned long len, const char* file)
+{
+    unsigned long long key = hashBuffer((const uint8*)file, strlen(file));
+
+    snprintf(path, len, "%s/%08lx%08lx.bin", g_cache_dir, (unsigned long)(key >> 32), (unsigned long)(key & 0xFFFFFFFF));
+}
+
+/*
+ * Takes the entry if the size and hash of the HEX match.
+ * Returns the word count, or -1 if there is no usable entry.
+ */
+int loadImageCache(const char* file, unsigned long size, unsigned long long hash, uint8* bout, uint8* pages_used)
+{
+    char   path[512] = {0};
+    uint8  header[IMAGE_CACHE_HEADER_SIZE] = {0};
+    uint8  used[PIC_NUM_PAGES] = {0};
+    uint32 num_words = 0;
+    uint32 page = 0;
+    FILE*  fp = NULL;
+
+    makeCachePath(path, sizeof(path), file);
+
+    if( !(fp = fopen(path, "rb")) )
+    {
+        return -1;
+    }
+
+    //header is the magic, hash, size and word count, all big endian
+    if( fread(header, 1, sizeof(header), fp) != sizeof(header) ||
+        memcmp(header, IMAGE_CACHE_MAGIC, 4) ||
+        fread(used, 1, sizeof(used), fp) != sizeof(used) )
+    {
+        fclose(fp);
+        return -1;
+    }
+
+    if( getCache64(&header[4]) != hash || getCache64(&header[12]) != size )
+    {
+        fclose(fp);
+        return -1;
+    }
+
+    num_words = (header[20] << 24) | (header[21] << 16) | (header[22] << 8) | header[23];
+
+    for( page=0; page<PIC_NUM_PAGES; page++)
+    {
+        if( used[page] != 1 )
+        {
+            continue;
+        }
+
+        if( fread(&bout[PIC_PAGE_ADDR(page)], 1, PIC_PAGE_SIZE, fp) != PIC_PAGE_SIZE )
+        {
+            fclose(fp);
+            return -1;
+        }
+    }
+
     fclose(fp);
+    memcpy(pages_used, used, sizeof(used));
+
     return num_words;
 }
 
+void saveImageCache(const char* file, unsigned long size, unsigned long long hash, uint8* bout, uint8* pages_used, uint32 num_words)
+{
+    char   path[512] = {0};
+    uint8  header[IMAGE_CACHE_HEADER_SIZE] = {0};
+    uint32 page = 0;
+    FILE*  fp = NULL;
+
+    makeCachePath(path, sizeof(path), file);
+
+    if( !(fp = fopen(path, "wb")) )
+    {
+        fprintf(stderr, "Could not write image cache %s\n", path);
+        return;
+    }
+
+    memcpy(header, IMAGE_CACHE_MAGIC, 4);
+    putCache64(&header[4], hash);
+    putCache64(&header[12], size);
+
+    header[20] = (num_words >> 24) & 0xFF;
+    header[21] = (num_words >> 16) & 0xFF;
+    header[22] = (num_words >>  8) & 0xFF;
+    header[23] = (num_words >>  0) & 0xFF;
+
+    fwrite(header, 1, sizeof(header), fp);
+    fwrite(pages_used, 1, PIC_NUM_PAGES, fp);
+
+    for( page=0; page<PIC_NUM_PAGES; page++)
+    {
+        if( pages_used[page] == 1 )
+        {
+            fwrite(&bout[PIC_PAGE_ADDR(page)], 1, PIC_PAGE_SIZE, fp);
+        }
+    }
+
+    if( fclose(fp) != 0 )
+    {
+        remove(path);
+    }
+}
+
+int readHEX(const char* file, uint8* bout, unsigned long max_length, uint8* pages_used)
+{
+    unsigned long long hash = 0;
+    unsigned long size = 0;
+    const uint8* text = NULL;
+    int   res = 0;
+
+    text = mapFile(file, &size);
+
+    if( !text )
+    {
+        return -1;
+    }
+
+    if( g_cache_dir )
+    {
+        //hashing the mapped file is cheap next to parsing it
+        hash = hashBuffer(text, size);
+        res  = loadImageCache(file, size, hash, bout, pages_used);
+
+        if( res > 0 )
+        {
+            if( !g_benchmark )
+            {
+                printf("Loaded image from cache\n");
+            }
+            unmapFile(text, size);
+            return res;
+        }
+    }
+
+    res = parseHEX(text, size, bout, pages_used);
+    unmapFile(text, size);
+
+    if( res > 0 && g_cache_dir )
+    {
+        saveImageCache(file, size, hash, bout, pages_used, res);
+    }
+
+    return res;
+}
+
+/* writes a HEX file filling the whole flash, 16 data bytes per record like the XC16 output */
+int writeSyntheticHEX(const char* file)
+{
+    uint32 addr = 0, base = 0xFFFFFFFF, seed = 1;
+    uint8  rec[4 + 16 + 1] = {0};
+    uint8  crc = 0;
+    int    i = 0;
+    FILE*  fp = fopen(file, "wb");
+
+    if( !fp )
+    {
+        return -1;
+    }
+
+    for( addr = 0; addr < (flashsize * 2); addr += 16 )
+    {
+        if( (addr >> 16) != base )
+        {
+            base = addr >> 16;
+            crc  = (uint8)(0 - (0x02 + 0x04 + (base >> 8) + base));
+            fprintf(fp, ":02000004%04lX%02X\n", base, crc);
+        }
+
+        rec[0] = 16;
+        rec[1] = (addr >> 8) & 0xFF;
+        rec[2] = addr & 0xFF;
+        rec[3] = 0x00;
+
+        for( i=0; i<16; i++ )
+        {
+            seed = seed * 1103515245 + 12345;
+            rec[4 + i] = ((i & 3) == 3) ? 0x00 : (uint8)(seed >> 16); //phantom byte is zero
+        }
+
+        crc = 0;
+        fputc(':', fp);
+        for( i=0; i<4 + 16; i++ )
+        {
+            crc += rec[i];
+            fprintf(fp, "%02X", rec[i]);
+        }
+        fprintf(fp, "%02X\n", (uint8)(0 - crc));
+    }
+
+    fputs(":00000001FF\n", fp);
+
+    return fclose(fp);
+}
+
+int runBenchmark(void)
+{
+    static const int ITERATIONS = 20;
+    const char* path = g_hexfile_path;
+    const uint8* text = NULL;
+    unsigned long size = 0;
+    uint8  pages_used[PIC_NUM_PAGES] = {0};
+    uint8* bin_buff = NULL;
+    uint32 started = 0, elapsed = 0;
+    int    res = -1, i = 0;
+
+    if( !path )
+    {
+        path = "pirate-loader-bench.hex";
+        printf("Writing synthetic HEX file [%s]\n", path);
+
+        if( writeSyntheticHEX(path) != 0 )
+        {
+            fprintf(stderr, "Could not write %s\n", path);
+            return -1;
+        }
+    }
+
+    bin_buff = (uint8*)malloc(0xFFFFFF * sizeof(uint8));
+    text = mapFile(path, &size);
+
+    if( !bin_buff || !text )
+    {
+        fprintf(stderr, "Could not load %s\n", path);
+        goto Finished;
+    }
+
+    started = getMilliseconds();
+
+    for( i=0; i<ITERATIONS; i++ )
+    {
+        if( (res = parseHEX(text, size, bin_buff, pages_used)) <= 0 )
+        {
+            goto Finished;
+        }
+    }
+
+    elapsed = getMilliseconds() - started;
+
+    printf("Parsed %lu bytes, %d words, %d times in %lu ms", size, res, ITERATIONS, elapsed);
+    if( elapsed > 0 )
+    {
+        printf(", %lu kB/s", (size / 1024) * ITERATIONS * 1000 / elapsed);
+    }
+    putchar('\n');
+
+    if( g_cache_dir )
+    {
+        readHEX(path, bin_buff, (0xFFFFFF * sizeof(uint8)), pages_used); //make sure the cache is filled
+
+        started = getMilliseconds();
+        for( i=0; i<ITERATIONS; i++ )
+        {
+            res = readHEX(path, bin_buff, (0xFFFFFF * sizeof(uint8)), pages_used);
+        }
+        elapsed = getMilliseconds() - started;
+
+        printf("Loaded from cache %d times in %lu ms\n", ITERATIONS, elapsed);
+    }
+
+Finished:
+    if( text )
+    {
+        unmapFile(text, size);
+    }
+    if( bin_buff )
+    {
+        free( bin_buff );
+    }
+    if( !g_hexfile_path )
+    {
+        remove(path);
+    }
+    return (res > 0) ? 0 : -1;
+}
+
 uint8 makeCrc(uint8* buf, uint32 len)
 {
     uint8 crc = 0, i = 0;
@@ -468,6 +890,46 @@ uint8 makeCrc(uint8* buf, uint32 len)
     return crc;
 }
 
+uint16 updateCrc16(uint16 crc, const uint8* buf, uint32 len)
+{
+    uint32 i = 0;
+    uint8  k = 0;
+
+    for(i=0; i<len; i++)
+    {
+        crc ^= (uint16)(buf[i] << 8);
+
+        for(k=0; k<8; k++)
+        {
+            crc = (crc & 0x8000) ? (uint16)((crc << 1) ^ 0x1021) : (uint16)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/* CRC of a page as the bootloader will read it back after programming */
+uint16 makePageCrc(const uint8* data, uint32 page)
+{
+    uint8  jump[6] = {0};
+    uint16 crc = 0xFFFF;
+    const uint8* p = &data[PIC_PAGE_ADDR(page)];
+
+    if( page == 0 )
+    {
+        //the bootloader replaces the reset vector with a jump to itself
+        jump[0] = 0x04;
+        jump[1] = (blstartaddr & 0x0000FF) >>  0;
+        jump[2] = (blstartaddr & 0x00FF00) >>  8;
+        jump[4] = (blstartaddr & 0xFF0000) >> 16;
+
+        crc = updateCrc16(crc, jump, sizeof(jump));
+        return updateCrc16(crc, p + sizeof(jump), PIC_PAGE_SIZE - sizeof(jump));
+    }
+
+    return updateCrc16(crc, p, PIC_PAGE_SIZE);
+}
+
 int sendCommandAndWaitForResponse(int fd, uint8 *command)
 {
     uint8  response[4] = {0};
@@ -505,6 +967,246 @@ int sendCommandAndWaitForResponse(int fd, uint8 *command)
 }
 
 
+int readPageCrc(int fd, uint32 u_addr, uint16* crc)
+{
+    uint8  command[8]  = {0};
+    uint8  response[4] = {0};
+    int    res = 0;
+
+    command[0] = (u_addr & 0x00FF0000) >> 16;
+    command[1] = (u_addr & 0x0000FF00) >>  8;
+    command[2] = (u_addr & 0x000000FF) >>  0;
+    command[COMMAND_OFFSET] = BOOTLOADER_CMD_PAGE_CRC;
+    command[LENGTH_OFFSET ] = 0x01; //1 byte, CRC
+    command[PAYLOAD_OFFSET] = makeCrc(command, 5);
+
+    if( g_verbose )
+    {
+        dumpHex(command, HEADER_LENGTH + command[LENGTH_OFFSET]);
+    }
+
+    res = write(fd, command, HEADER_LENGTH + command[LENGTH_OFFSET]);
+
+    if( res <= 0 )
+    {
+        puts("ERROR");
+        return -1;
+    }
+
+    res = readWithTimeout(fd, response, 1, 5);
+    if( res != 1 )
+    {
+        puts("ERROR");
+        return -1;
+    }
+    else if ( response[0] != BOOTLOADER_OK )
+    {
+        printf("ERROR [%02x]\n", response[0]);
+        return -1;
+    }
+
+    res = readWithTimeout(fd, response + 1, 2, 5);
+    if( res != 2 )
+    {
+        puts("ERROR");
+        return -1;
+    }
+
+    *crc = (response[1] << 8) | response[2];
+    return 0;
+}
+
+int sendSequencedRow(int fd, uint8* data, uint32 page, uint32 row, uint8 seq, uint8 flags)
+{
+    uint8  command[256] = {0};
+    uint32 u_addr = page * ( PIC_NUM_WORDS_IN_ROW * 2 * PIC_NUM_ROWS_IN_PAGE ) + row * ( PIC_NUM_WORDS_IN_ROW * 2 );
+
+    command[0] = (u_addr & 0x00FF0000) >> 16;
+    command[1] = (u_addr & 0x0000FF00) >>  8;
+    command[2] = (u_addr & 0x000000FF) >>  0;
+    command[COMMAND_OFFSET] = BOOTLOADER_CMD_WRITE_SEQ;
+    command[LENGTH_OFFSET ] = PIC_ROW_SIZE + 0x03; //DATA_LENGTH + SEQ + FLAGS + CRC
+
+    memcpy(&command[PAYLOAD_OFFSET], &data[PIC_ROW_ADDR(page, row)], PIC_ROW_SIZE);
+
+    command[PAYLOAD_OFFSET + PIC_ROW_SIZE + 0] = seq;
+    command[PAYLOAD_OFFSET + PIC_ROW_SIZE + 1] = flags;
+    command[PAYLOAD_OFFSET + PIC_ROW_SIZE + 2] = makeCrc(command, HEADER_LENGTH + PIC_ROW_SIZE + 2);
+
+    if( g_verbose )
+    {
+        printf("Sending page %ld row %ld, %04lx, seq %d\n", page, row + page*PIC_NUM_ROWS_IN_PAGE, u_addr, seq);
+        dumpHex(command, HEADER_LENGTH + command[LENGTH_OFFSET]);
+    }
+
+    if( write(fd, command, HEADER_LENGTH + command[LENGTH_OFFSET]) <= 0 )
+    {
+        puts("ERROR");
+        return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * Streams the rows of every page marked in pages_write with up to g_window
+ * commands in flight. The bootloader answers each row with its status and
+ * sequence number, in order. A row that fails the checksum is sent again on
+ * its own. A failed verify, or a failed row carrying the page erase, sends
+ * the whole page again and the replies of the older attempt are ignored.
+ */
+int sendPagesWindowed(int fd, uint8* data, uint8* pages_write)
+{
+    uint32 slot_page[MAX_WINDOW], slot_row[MAX_WINDOW], slot_gen[MAX_WINDOW];
+    uint8  slot_seq[MAX_WINDOW], slot_flags[MAX_WINDOW];
+    uint32 resend_page[RESEND_QUEUE_SIZE], resend_row[RESEND_QUEUE_SIZE];
+    uint32 page_gen[PIC_NUM_PAGES] = {0};
+    uint32 head = 0, inflight = 0, resends = 0, failures = 0;
+    uint32 page = 0, row = 0, rows_done = 0;
+    uint32 i = 0, s = 0;
+    uint8  seq = 0, flags = 0;
+    uint8  response[2] = {0};
+
+    //find the first page to write
+    while( page < PIC_NUM_PAGES && pages_write[page] != 1 )
+    {
+        page++;
+    }
+
+    while( page < PIC_NUM_PAGES || resends > 0 || inflight > 0 )
+    {
+        //fill the window, resends first
+        while( inflight < g_window && (resends > 0 || page < PIC_NUM_PAGES) )
+        {
+            s = (head + inflight) % MAX_WINDOW;
+
+            if( resends > 0 )
+            {
+                slot_page[s] = resend_page[0];
+                slot_row[s]  = resend_row[0];
+                resends--;
+                memmove(resend_page, resend_page + 1, resends * sizeof(resend_page[0]));
+                memmove(resend_row, resend_row + 1, resends * sizeof(resend_row[0]));
+            }
+            else
+            {
+                slot_page[s] = page;
+                slot_row[s]  = row;
+
+                if( ++row == PIC_NUM_ROWS_IN_PAGE )
+                {
+                    row = 0;
+                    do
+                    {
+                        page++;
+                    }
+                    while( page < PIC_NUM_PAGES && pages_write[page] != 1 );
+                }
+            }
+
+            flags = (slot_row[s] == 0) ? WRITE_SEQ_ERASE : 0;
+
+            slot_seq[s]   = seq;
+            slot_flags[s] = flags;
+            slot_gen[s]   = page_gen[slot_page[s]];
+
+            if( sendSequencedRow(fd, data, slot_page[s], slot_row[s], seq, flags) < 0 )
+            {
+                return -1;
+            }
+
+            seq++;
+            inflight++;
+        }
+
+        //collect the oldest reply
+        s = head;
+
+        if( readWithTimeout(fd, response, 2, 5) != 2 )
+        {
+            puts("ERROR");
+            fprintf(stderr, "No reply for page %ld row %ld\n", slot_page[s], slot_row[s] + slot_page[s]*PIC_NUM_ROWS_IN_PAGE);
+            return -1;
+        }
+
+        head = (head + 1) % MAX_WINDOW;
+        inflight--;
+
+        if( response[1] != slot_seq[s] )
+        {
+            fprintf(stderr, "Sequence mismatch, expected %d got %d [%02x]\n", slot_seq[s], response[1], response[0]);
+            return -1;
+        }
+
+        if( response[0] == BOOTLOADER_OK || response[0] == BOOTLOADER_PROT )
+        {
+            if( slot_gen[s] == page_gen[slot_page[s]] )
+            {
+                rows_done++;
+            }
+            continue;
+        }
+
+        if( response[0] != BOOTLOADER_CRC_ERROR && response[0] != BOOTLOADER_VERIFY_ERROR )
+        {
+            printf("ERROR [%02x]\n", response[0]);
+            return -1;
+        }
+
+        if( slot_gen[s] != page_gen[slot_page[s]] )
+        {
+            continue; //superseded by a resend of the whole page
+        }
+
+        if( ++failures > MAX_RESENDS )
+        {
+            fprintf(stderr, "Too many failed rows, giving up\n");
+            return -1;
+        }
+
+        printf("Page %ld row %ld failed [%c], resending\n", slot_page[s], slot_row[s] + slot_page[s]*PIC_NUM_ROWS_IN_PAGE, response[0]);
+
+        if( resends + PIC_NUM_ROWS_IN_PAGE > RESEND_QUEUE_SIZE )
+        {
+            puts("ERROR");
+            fprintf(stderr, "Resend queue full, giving up\n");
+            return -1;
+        }
+
+        if( (slot_flags[s] & WRITE_SEQ_ERASE) || response[0] == BOOTLOADER_VERIFY_ERROR )
+        {
+            //the erase did not happen or the row is half programmed, rewrite the page from the start
+            page_gen[slot_page[s]]++;
+
+            for( i=0; i<PIC_NUM_ROWS_IN_PAGE; i++ )
+            {
+                resend_page[resends] = slot_page[s];
+                resend_row[resends]  = i;
+                resends++;
+            }
+
+            //rows of this page not yet sent are covered by the resend
+            if( page == slot_page[s] )
+            {
+                row = 0;
+                do
+                {
+                    page++;
+                }
+                while( page < PIC_NUM_PAGES && pages_write[page] != 1 );
+            }
+        }
+        else
+        {
+            resend_page[resends] = slot_page[s];
+            resend_row[resends]  = slot_row[s];
+            resends++;
+        }
+    }
+
+    return rows_done * PIC_ROW_SIZE;
+}
+
 int sendFirmware(int fd, uint8* data, uint8* pages_used)
 {
     uint32 u_addr;
@@ -513,7 +1215,13 @@ int sendFirmware(int fd, uint8* data, uint8* pages_used)
     uint32 page  = 0;
     uint32 done  = 0;
     uint32 row   = 0;
+    uint32 skipped = 0;
+    uint32 started = getMilliseconds();
+    uint32 elapsed = 0;
+    uint16 crc   = 0;
     uint8  command[256] = {0};
+    uint8  pages_write[PIC_NUM_PAGES] = {0};
+    int    res = 0;
 
 
     for( page=0; page<PIC_NUM_PAGES; page++)
@@ -536,11 +1244,36 @@ int sendFirmware(int fd, uint8* data, uint8* pages_used)
             return -1;
         }
 
+        if( g_diff && g_simulate == 0 )
+        {
+            printf("Checking page %ld, %04lx...", page, u_addr);
+
+            if( readPageCrc(fd, u_addr, &crc) < 0 )
+            {
+                return -1;
+            }
+
+            if( crc == makePageCrc(data, page) )
+            {
+                puts("unchanged");
+                skipped++;
+                continue;
+            }
+
+            printf("differs [%04x]\n", crc);
+        }
+
+        if( g_window && g_simulate == 0 )
+        {
+            pages_write[page] = 1; //streamed below
+            continue;
+        }
+
         //erase page
         command[0] = (u_addr & 0x00FF0000) >> 16;
         command[1] = (u_addr & 0x0000FF00) >>  8;
         command[2] = (u_addr & 0x000000FF) >>  0;
-        command[COMMAND_OFFSET] = 0x01; //erase command
+        command[COMMAND_OFFSET] = BOOTLOADER_CMD_ERASE;
         command[LENGTH_OFFSET ] = 0x01; //1 byte, CRC
         command[PAYLOAD_OFFSET] = makeCrc(command, 5);
 
@@ -564,7 +1297,7 @@ int sendFirmware(int fd, uint8* data, uint8* pages_used)
             command[0] = (u_addr & 0x00FF0000) >> 16;
             command[1] = (u_addr & 0x0000FF00) >>  8;
             command[2] = (u_addr & 0x000000FF) >>  0;
-            command[COMMAND_OFFSET] = 0x02; //write command
+            command[COMMAND_OFFSET] = BOOTLOADER_CMD_WRITE;
             command[LENGTH_OFFSET ] = PIC_ROW_SIZE + 0x01; //DATA_LENGTH + CRC
 
             memcpy(&command[PAYLOAD_OFFSET], &data[PIC_ROW_ADDR(page, row)], PIC_ROW_SIZE);
@@ -592,6 +1325,36 @@ int sendFirmware(int fd, uint8* data, uint8* pages_used)
         }
     }
 
+    if( g_window && g_simulate == 0 )
+    {
+        printf("Writing with up to %ld rows in flight...", g_window);
+
+        if( (res = sendPagesWindowed(fd, data, pages_write)) < 0 )
+        {
+            return -1;
+        }
+
+        puts("OK");
+        done = res;
+    }
+
+    if( g_diff && g_simulate == 0 )
+    {
+        printf("Skipped %ld unchanged pages\n", skipped);
+    }
+
+    if( g_simulate == 0 )
+    {
+        elapsed = getMilliseconds() - started;
+        printf("Wrote %ld rows in %ld.%03ld s", done / PIC_ROW_SIZE, elapsed / 1000, elapsed % 1000);
+
+        if( elapsed > 0 )
+        {
+            printf(", %ld rows/sec", ((done / PIC_ROW_SIZE) * 1000) / elapsed);
+        }
+        putchar('\n');
+    }
+
     return done;
 }
 
@@ -673,6 +1436,28 @@ int parseCommandLine(int argc, const char** argv)
         {
             g_simulate = 1;
         }
+        else if ( !strncmp(argv[i], "--cache=", 8) )
+        {
+            g_cache_dir = argv[i] + 8;
+        }
+        else if ( !strcmp(argv[i], "--benchmark") )
+        {
+            g_benchmark = 1;
+        }
+        else if ( !strcmp(argv[i], "--diff") )
+        {
+            g_diff = 1;
+        }
+        else if ( !strncmp(argv[i], "--window=", 9) )
+        {
+            g_window = strtoul(argv[i] + 9, NULL, 10);
+
+            if( g_window < 1 || g_window > MAX_WINDOW )
+            {
+                fprintf(stderr, "Window must be between 1 and %d rows\n", MAX_WINDOW);
+                return -1;
+            }
+        }
         else if ( !strcmp(argv[i], "--help") )
         {
             argc = 1; //that's not pretty, but it works :)
@@ -690,8 +1475,11 @@ int parseCommandLine(int argc, const char** argv)
         //print usage
         puts("pirate-loader usage:\n");
         puts(" ./pirate-loader --dev=/path/to/device --hello");
-        puts(" ./pirate-loader --dev=/path/to/device --hex=/path/to/hexfile.hex [ --verbose ]");
+        puts(" ./pirate-loader --dev=/path/to/device --hex=/path/to/hexfile.hex [ --verbose ] [ --diff ] [ --window=N ]");
         puts(" ./pirate-loader --simulate --hex=/path/to/hexfile.hex [ --verbose ] ");
+        puts(" ./pirate-loader --benchmark [ --hex=/path/to/hexfile.hex ] [ --cache=/path/to/dir ]");
+        puts("");
+        puts(" --cache=/path/to/dir keeps decoded HEX images in dir, checked against the HEX contents");
         puts("");
 
         return 0;
@@ -724,6 +1512,13 @@ int main (int argc, const char** argv)
         return 0;
     }
 
+    initHexTable();
+
+    if( g_benchmark )
+    {
+        return runBenchmark();
+    }
+
     if( !g_hello_only )
     {
 
@@ -811,6 +1606,20 @@ int main (int argc, const char** argv)
 
     printf("Bootloader version: %d,%02d\n", buffer[1], buffer[2]);
 
+    g_bootloader_version = (buffer[1] << 8) | buffer[2];
+
+    if( g_diff && g_bootloader_version < BOOTLOADER_PAGE_CRC_VERSION )
+    {
+        puts("Bootloader cannot report page CRCs, writing all pages");
+        g_diff = 0;
+    }
+
+    if( g_window && g_bootloader_version < BOOTLOADER_WRITE_SEQ_VERSION )
+    {
+        puts("Bootloader cannot take sequenced rows, writing one row at a time");
+        g_window = 0;
+    }
+
     printf("Device ID [%02x]:",buffer[0]);
     switch(buffer[0])
     {
@@ -1233,7 +2042,7 @@ int main (int argc, const char** argv)
 
         res = sendFirmware(dev_fd, bin_buff, pages_used);
 
-        if( res > 0 )
+        if( res > 0 || (res == 0 && g_diff) )
         {
             puts("\nFirmware updated successfully :)!");
             //printf("Use screen %s 115200 to verify\n", g_device_path);
@@ -0,0 +1,764 @@
+/*
+ * This file is part of the Bus Pirate project
+ * (http://code.google.com/p/the-bus-pirate/).
+ *
+ * Written and maintained by the Bus Pirate project.
+ *
+ * To the extent possible under law, the project has
+ * waived all copyright and related or neighboring rights to Bus Pirate. This
+ * work is published from United States.
+ *
+ * For details see: http://creativecommons.org/publicdomain/zero/1.0/.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/*
+ * Host test of pirate-loader against a simulated v4 bootloader on a pty.
+ *
+ * The loader given on the command line is run with --dev set to the slave
+ * side of a pty, the master side is served the way firmware-v1/bootloader.c
+ * does: hello, erase (1), row write (2), page CRC (3) and sequenced row
+ * write (4), with the jump vector of page 0 replaced by a jump to the
+ * bootloader and its pages protected. Flash is programmed like the real
+ * thing, bits only go from 1 to 0 until the page is erased, and every row is
+ * read back.
+ *
+ * Faults can be attached to a row, for its first attempt only: a bad
+ * checksum ('N'), a failed verify ('V', half the row programmed), or a reply
+ * that is lost or sent after the next one. At the end the simulated flash
+ * is compared with the HEX image and the loader's exit code and output are
+ * checked.
+ */
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#define DEVICE_ID       18      //PIC24FJ256GB206
+#define VERSION_H       0x04
+#define VERSION_L       0x0C
+#define FLASH_SIZE      0x2AC00 //program addresses, as flashsize in the loader
+#define BL_START        0x400
+#define BL_END          0x23FF
+
+#define WORD_SIZE       3
+#define ROW_WORDS       64
+#define PAGE_ROWS       8
+#define ROW_SIZE        (ROW_WORDS * WORD_SIZE)
+#define PAGE_SIZE       (PAGE_ROWS * ROW_SIZE)
+#define PAGE_ADDRS      (PAGE_ROWS * ROW_WORDS * 2)
+#define NUM_PAGES       (FLASH_SIZE / PAGE_ADDRS)
+
+#define MAX_RESENDS     16      //as in pirate-loader.c
+#define RUN_TIMEOUT     60      //seconds
+
+enum
+{
+    FAULT_NONE = 0,
+    FAULT_CHECKSUM,             //reply 'N', nothing written
+    FAULT_VERIFY,               //half the row written, reply 'V'
+    FAULT_SWAP,                 //reply sent after the next one
+    FAULT_DROP                  //no reply
+};
+
+typedef struct
+{
+    uint32_t page;
+    uint32_t row;
+    int      kind;
+} fault_t;
+
+static const fault_t NO_FAULTS[] = { { 0, 0, FAULT_NONE } };
+
+static struct
+{
+    uint8_t  flash[NUM_PAGES * PAGE_SIZE];
+    const fault_t* faults;
+    int      fail_all;          //every sequenced row fails its checksum
+    int      enable_erase;
+    int      hello;
+    uint8_t  held[2];
+    int      holding;
+
+    //what the test looks at
+    int      attempts[NUM_PAGES][PAGE_ROWS];
+    int      erases[NUM_PAGES];
+    int      row_writes;
+    int      crc_reads;
+    int      seq_rows;
+} sim;
+
+/* pages of the test image, 1 to 8 hold the bootloader and are left out */
+static const uint32_t PAGES[] = { 0, 9, 10, 11, 12, 13, 14, 15, 16, 20 };
+#define NUM_IMAGE_PAGES (sizeof(PAGES) / sizeof(PAGES[0]))
+
+static uint8_t image[NUM_PAGES * PAGE_SIZE];
+static char    output[65536];
+static int     failures = 0;
+
+#define CHECK(cond, ...)                                                    \
+    do                                                                      \
+    {                                                                       \
+        if( !(cond) )                                                       \
+        {                                                                   \
+            printf(" FAIL: " __VA_ARGS__);                                  \
+            printf("\n");                                                   \
+            failures++;                                                     \
+        }                                                                   \
+    }                                                                       \
+    while( 0 )
+
+/* contents of a page, never 0x00 or 0xFF so any lost write shows */
+static void fillPage(uint8_t* p, uint32_t page, uint32_t version)
+{
+    uint32_t seed = (page * 7919) + (version * 104729) + 1;
+    int i = 0;
+
+    for( i=0; i<PAGE_SIZE; i++ )
+    {
+        seed = seed * 1103515245 + 12345;
+        p[i] = 0x11 + (uint8_t)((seed >> 16) % 0xDD);
+    }
+}
+
+/* the bootloader writes a jump to itself over the reset vector */
+static void putJump(uint8_t* p)
+{
+    p[0] = 0x04;
+    p[1] = BL_START & 0xFF;
+    p[2] = (BL_START >> 8) & 0xFF;
+    p[3] = 0x00;
+    p[4] = (BL_START >> 16) && 0xFF;  //sic, as in bootloader.c
+    p[5] = 0x00;
+}
+
+/* the image as it should end up in flash */
+static void expectedPage(uint8_t* p, uint32_t page, uint32_t version)
+{
+    fillPage(p, page, version);
+
+    if( page == 0 )
+    {
+        putJump(p);
+    }
+}
+
+/* XC16 style HEX of the image pages, words as low, high, upper, phantom */
+static void writeHex(const char* file, uint32_t version)
+{
+    uint8_t  rec[4 + 16] = {0};
+    uint8_t  page_data[PAGE_SIZE];
+    uint32_t base = 0xFFFFFFFF;
+    uint32_t addr = 0, n = 0, w = 0;
+    uint8_t  crc = 0;
+    FILE*    fp = fopen(file, "wb");
+    int      i = 0;
+
+    if( !fp )
+    {
+        perror(file);
+        exit(1);
+    }
+
+    for( n=0; n<NUM_IMAGE_PAGES; n++ )
+    {
+        fillPage(page_data, PAGES[n], version);
+
+        for( w=0; w<PAGE_SIZE / WORD_SIZE; w+=4 )
+        {
+            addr = ((PAGES[n] * PAGE_ADDRS) + (w * 2)) * 2;
+
+            if( (addr >> 16) != base )
+            {
+                base = addr >> 16;
+                crc  = (uint8_t)(0 - (0x02 + 0x04 + (base >> 8) + base));
+                fprintf(fp, ":02000004%04X%02X\n", (unsigned)base, crc);
+            }
+
+            rec[0] = 16;
+            rec[1] = (addr >> 8) & 0xFF;
+            rec[2] = addr & 0xFF;
+            rec[3] = 0x00;
+
+            for( i=0; i<4; i++ )
+            {
+                rec[4 + (i * 4) + 0] = page_data[((w + i) * WORD_SIZE) + 1];
+                rec[4 + (i * 4) + 1] = page_data[((w + i) * WORD_SIZE) + 2];
+                rec[4 + (i * 4) + 2] = page_data[((w + i) * WORD_SIZE) + 0];
+                rec[4 + (i * 4) + 3] = 0x00;
+            }
+
+            crc = 0;
+            fputc(':', fp);
+            for( i=0; i<(int)sizeof(rec); i++ )
+            {
+                crc += rec[i];
+                fprintf(fp, "%02X", rec[i]);
+            }
+            fprintf(fp, "%02X\n", (uint8_t)(0 - crc));
+        }
+    }
+
+    fputs(":00000001FF\n", fp);
+    fclose(fp);
+
+    memset(image, 0xFF, sizeof(image));
+    for( n=0; n<NUM_IMAGE_PAGES; n++ )
+    {
+        expectedPage(&image[PAGES[n] * PAGE_SIZE], PAGES[n], version);
+    }
+}
+
+/* simulated bootloader */
+
+static void simReset(const fault_t* faults)
+{
+    memset(&sim, 0, sizeof(sim));
+    memset(sim.flash, 0xFF, sizeof(sim.flash));
+    sim.faults = faults;
+}
+
+static int simFault(uint32_t addr)
+{
+    uint32_t page = addr / PAGE_ADDRS;
+    uint32_t row  = (addr % PAGE_ADDRS) / (ROW_WORDS * 2);
+    const fault_t* f = NULL;
+
+    if( sim.attempts[page][row] != 1 )
+    {
+        return FAULT_NONE;
+    }
+
+    for( f = sim.faults; f->kind != FAULT_NONE; f++ )
+    {
+        if( f->page == page && f->row == row )
+        {
+            return f->kind;
+        }
+    }
+
+    return FAULT_NONE;
+}
+
+static void simWrite(int fd, const uint8_t* reply, int len)
+{
+    if( write(fd, reply, len) != len )
+    {
+        perror("pty write");
+        exit(1);
+    }
+}
+
+static void simReply(int fd, const uint8_t* reply, int len, int fault)
+{
+    if( fault == FAULT_DROP )
+    {
+        return;
+    }
+
+    if( fault == FAULT_SWAP && len == 2 )
+    {
+        memcpy(sim.held, reply, 2);
+        sim.holding = 1;
+        return;
+    }
+
+    simWrite(fd, reply, len);
+
+    if( sim.holding )
+    {
+        simWrite(fd, sim.held, 2);
+        sim.holding = 0;
+    }
+}
+
+static uint8_t simWriteRow(uint32_t addr, uint8_t* data, int fault)
+{
+    uint32_t page = addr / PAGE_ADDRS;
+    uint32_t offset = (addr / 2) * WORD_SIZE;
+    int i = 0, count = ROW_SIZE;
+
+    if( addr == 0 )
+    {
+        putJump(data);
+    }
+
+    if( (addr <= BL_END && addr >= BL_START) || addr >= (FLASH_SIZE - PAGE_ADDRS) )
+    {
+        return 'P';
+    }
+
+    if( sim.enable_erase )
+    {
+        memset(&sim.flash[page * PAGE_SIZE], 0xFF, PAGE_SIZE);
+        sim.erases[page]++;
+        sim.enable_erase = 0;
+    }
+
+    if( fault == FAULT_VERIFY )
+    {
+        count = ROW_SIZE / 2;
+    }
+
+    for( i=0; i<count; i++ )
+    {
+        sim.flash[offset + i] &= data[i];
+    }
+    sim.row_writes++;
+
+    return memcmp(&sim.flash[offset], data, ROW_SIZE) ? 'V' : 'K';
+}
+
+static uint16_t simPageCrc(uint32_t addr)
+{
+    const uint8_t* p = &sim.flash[(addr / 2) * WORD_SIZE];
+    uint16_t crc = 0xFFFF;
+    int i = 0, k = 0;
+
+    for( i=0; i<PAGE_SIZE; i++ )
+    {
+        crc ^= (uint16_t)(p[i] << 8);
+        for( k=0; k<8; k++ )
+        {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/* one whole command, header, data and checksum */
+static void simCommand(int fd, uint8_t* cmd, int len)
+{
+    uint32_t addr = ((uint32_t)cmd[0] << 16) | (cmd[1] << 8) | cmd[2];
+    uint8_t  reply[3] = { 'K', 0, 0 };
+    uint8_t* data = &cmd[5];
+    uint8_t  crc = 0;
+    uint16_t page_crc = 0;
+    int      fault = FAULT_NONE;
+    int      i = 0;
+
+    for( i=0; i<len; i++ )
+    {
+        crc += cmd[i];
+    }
+
+    if( cmd[3] == 2 || cmd[3] == 4 )
+    {
+        sim.attempts[addr / PAGE_ADDRS][(addr % PAGE_ADDRS) / (ROW_WORDS * 2)]++;
+        fault = simFault(addr);
+    }
+
+    if( cmd[3] == 4 )
+    {
+        sim.seq_rows++;
+        if( sim.fail_all )
+        {
+            fault = FAULT_CHECKSUM;
+        }
+    }
+
+    if( crc != 0 || fault == FAULT_CHECKSUM )
+    {
+        reply[0] = 'N';
+        reply[1] = data[ROW_SIZE];
+        simReply(fd, reply, (cmd[3] == 4) ? 2 : 1, fault);
+        return;
+    }
+
+    switch( cmd[3] )
+    {
+    case 1:
+        sim.enable_erase = 1;
+        simReply(fd, reply, 1, fault);
+        break;
+
+    case 2:
+        reply[0] = simWriteRow(addr, data, fault);
+        simReply(fd, reply, 1, fault);
+        break;
+
+    case 3:
+        sim.crc_reads++;
+        page_crc = simPageCrc(addr);
+        reply[1] = page_crc >> 8;
+        reply[2] = page_crc & 0xFF;
+        simReply(fd, reply, 3, fault);
+        break;
+
+    case 4:
+        reply[1] = data[ROW_SIZE];
+        if( cmd[4] != ROW_SIZE + 3 )
+        {
+            reply[0] = 'U';
+        }
+        else
+        {
+            sim.enable_erase = data[ROW_SIZE + 1] & 0x01;
+            reply[0] = simWriteRow(addr, data, fault);
+            sim.enable_erase = 0;
+        }
+        simReply(fd, reply, 2, fault);
+        break;
+
+    default:
+        reply[0] = 'U';
+        simReply(fd, reply, 1, fault);
+        break;
+    }
+}
+
+/* takes what the loader sent, returns how much was used */
+static int simReceive(int fd, uint8_t* buf, int len)
+{
+    static const uint8_t hello[4] = { DEVICE_ID, VERSION_H, VERSION_L, 'K' };
+    int used = 0;
+
+    while( used < len )
+    {
+        if( !sim.hello )
+        {
+            if( buf[used++] == 0xC1 )
+            {
+                sim.hello = 1;
+                simWrite(fd, hello, sizeof(hello));
+            }
+            continue;
+        }
+
+        if( len - used < 5 || len - used < 5 + buf[used + 4] )
+        {
+            break;
+        }
+
+        simCommand(fd, &buf[used], 5 + buf[used + 4]);
+        used += 5 + buf[used + 4];
+    }
+
+    return used;
+}
+
+/* runs the loader on the simulator, returns its exit code */
+static int runLoader(const char* loader, const char* hex, const char* options)
+{
+    static uint8_t buf[65536];
+    char     dev[256] = {0}, dev_arg[300] = {0}, hex_arg[300] = {0};
+    char     opts[256] = {0}, log[] = "/tmp/loader_testXXXXXX";
+    char*    argv[16] = {0};
+    struct termios tio;
+    struct pollfd pfd;
+    time_t   started = time(NULL);
+    pid_t    pid = 0;
+    int      master = -1, slave = -1, log_fd = -1;
+    int      len = 0, res = 0, used = 0, status = 0, argc = 0;
+    char*    tok = NULL;
+
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if( master < 0 || grantpt(master) < 0 || unlockpt(master) < 0 )
+    {
+        perror("pty");
+        exit(1);
+    }
+    snprintf(dev, sizeof(dev), "%s", ptsname(master));
+
+    //kept open so the master never sees a hangup between loader opens
+    slave = open(dev, O_RDWR | O_NOCTTY);
+    tcgetattr(slave, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(slave, TCSANOW, &tio);
+
+    log_fd = mkstemp(log);
+
+    snprintf(dev_arg, sizeof(dev_arg), "--dev=%s", dev);
+    snprintf(hex_arg, sizeof(hex_arg), "--hex=%s", hex);
+    snprintf(opts, sizeof(opts), "%s", options);
+
+    argv[argc++] = (char*)loader;
+    argv[argc++] = dev_arg;
+    argv[argc++] = hex_arg;
+    for( tok = strtok(opts, " "); tok && argc < 15; tok = strtok(NULL, " ") )
+    {
+        argv[argc++] = tok;
+    }
+
+    pid = fork();
+    if( pid == 0 )
+    {
+        dup2(log_fd, 1);
+        dup2(log_fd, 2);
+        close(master);
+        close(slave);
+        execv(loader, argv);
+        perror(loader);
+        _exit(127);
+    }
+
+    pfd.fd = master;
+    pfd.events = POLLIN;
+
+    for( ;; )
+    {
+        if( poll(&pfd, 1, 20) > 0 && (pfd.revents & POLLIN) )
+        {
+            res = read(master, buf + len, sizeof(buf) - len);
+            if( res > 0 )
+            {
+                len += res;
+                used = simReceive(master, buf, len);
+                memmove(buf, buf + used, len - used);
+                len -= used;
+            }
+        }
+
+        if( waitpid(pid, &status, WNOHANG) == pid )
+        {
+            break;
+        }
+
+        if( time(NULL) - started > RUN_TIMEOUT )
+        {
+            kill(pid, SIGKILL);
+            waitpid(pid, &status, 0);
+            printf(" FAIL: loader did not finish in %d s\n", RUN_TIMEOUT);
+            failures++;
+            break;
+        }
+    }
+
+    close(master);
+    close(slave);
+
+    lseek(log_fd, 0, SEEK_SET);
+    res = read(log_fd, output, sizeof(output) - 1);
+    output[(res > 0) ? res : 0] = '\0';
+    close(log_fd);
+    unlink(log);
+
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+static int imageMatches(void)
+{
+    uint32_t n = 0;
+
+    for( n=0; n<NUM_IMAGE_PAGES; n++ )
+    {
+        if( memcmp(&sim.flash[PAGES[n] * PAGE_SIZE], &image[PAGES[n] * PAGE_SIZE], PAGE_SIZE) )
+        {
+            printf(" page %u differs\n", (unsigned)PAGES[n]);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static int totalErases(void)
+{
+    int page = 0, total = 0;
+
+    for( page=0; page<NUM_PAGES; page++ )
+    {
+        total += sim.erases[page];
+    }
+
+    return total;
+}
+
+static int g_failed_before = 0;
+
+/* loader output of a run with failed checks */
+static void showOutput(void)
+{
+    if( failures != g_failed_before )
+    {
+        printf("--- loader output ---\n%s---\n", output);
+    }
+    g_failed_before = failures;
+}
+
+/* tests */
+
+static const char* g_loader = NULL;
+static char g_hex[64] = {0};
+
+/* flash written from scratch, one row at a time, page 0 gets the jump */
+static void testFullWrite(void)
+{
+    int res = 0;
+
+    printf("full write\n");
+    simReset(NO_FAULTS);
+    res = runLoader(g_loader, g_hex, "");
+
+    CHECK(res == 0, "exit code %d", res);
+    CHECK(imageMatches(), "flash differs from the image");
+    CHECK(totalErases() == (int)NUM_IMAGE_PAGES, "%d erases", totalErases());
+    CHECK(sim.row_writes == (int)NUM_IMAGE_PAGES * PAGE_ROWS, "%d rows written", sim.row_writes);
+    CHECK(sim.crc_reads == 0, "%d CRC reads without --diff", sim.crc_reads);
+    showOutput();
+}
+
+/* --diff reads every page CRC and writes only the pages that differ */
+static void testDiff(const char* options)
+{
+    uint8_t page[PAGE_SIZE];
+    char    skipped[64];
+    int     res = 0;
+
+    printf("diff %s\n", options);
+    simReset(NO_FAULTS);
+
+    //pages 0 and 10 already programmed, page 9 holds an older build
+    memcpy(&sim.flash[0], &image[0], PAGE_SIZE);
+    memcpy(&sim.flash[10 * PAGE_SIZE], &image[10 * PAGE_SIZE], PAGE_SIZE);
+    expectedPage(page, 9, 2);
+    memcpy(&sim.flash[9 * PAGE_SIZE], page, PAGE_SIZE);
+
+    res = runLoader(g_loader, g_hex, options);
+
+    CHECK(res == 0, "exit code %d", res);
+    CHECK(imageMatches(), "flash differs from the image");
+    CHECK(sim.crc_reads == (int)NUM_IMAGE_PAGES, "%d CRC reads", sim.crc_reads);
+    CHECK(sim.erases[0] == 0 && sim.erases[10] == 0, "unchanged pages erased %d %d",
+          sim.erases[0], sim.erases[10]);
+    CHECK(sim.erases[9] == 1, "changed page erased %d times", sim.erases[9]);
+    CHECK(totalErases() == (int)NUM_IMAGE_PAGES - 2, "%d erases", totalErases());
+    snprintf(skipped, sizeof(skipped), "Skipped %d unchanged pages", 2);
+    CHECK(strstr(output, skipped) != NULL, "no '%s'", skipped);
+    showOutput();
+
+    //page 0 as programmed, with the jump, matches the CRC of the HEX
+    simReset(NO_FAULTS);
+    memcpy(sim.flash, image, sizeof(sim.flash));
+    res = runLoader(g_loader, g_hex, options);
+
+    CHECK(res == 0, "second run exit code %d", res);
+    CHECK(totalErases() == 0 && sim.row_writes == 0, "second run erased %d pages, wrote %d rows",
+          totalErases(), sim.row_writes);
+    snprintf(skipped, sizeof(skipped), "Skipped %d unchanged pages", (int)NUM_IMAGE_PAGES);
+    CHECK(strstr(output, skipped) != NULL, "second run, no '%s'", skipped);
+    showOutput();
+}
+
+/* rows in flight, the given faults are resent and the image comes out right */
+static void testWindow(const char* name, const char* options, const fault_t* faults,
+                       int extra_rows, const char* message)
+{
+    int res = 0;
+
+    printf("window, %s\n", name);
+    simReset(faults);
+    res = runLoader(g_loader, g_hex, options);
+
+    CHECK(res == 0, "exit code %d", res);
+    CHECK(imageMatches(), "flash differs from the image");
+    CHECK(sim.seq_rows == ((int)NUM_IMAGE_PAGES * PAGE_ROWS) + extra_rows,
+          "%d sequenced rows, expected %d", sim.seq_rows,
+          ((int)NUM_IMAGE_PAGES * PAGE_ROWS) + extra_rows);
+    CHECK(!message || strstr(output, message) != NULL, "no '%s'", message);
+    CHECK(strstr(output, "successfully") != NULL, "not reported as updated");
+    showOutput();
+}
+
+/* the loader gives up, and says so */
+static void testWindowAbort(const char* name, const fault_t* faults, int fail_all,
+                            const char* message)
+{
+    int res = 0;
+
+    printf("window, %s\n", name);
+    simReset(faults);
+    sim.fail_all = fail_all;
+    res = runLoader(g_loader, g_hex, "--window=8");
+
+    CHECK(res != 0, "exit code %d", res);
+    CHECK(strstr(output, message) != NULL, "no '%s'", message);
+    CHECK(strstr(output, "successfully") == NULL, "reported as updated");
+    if( fail_all )
+    {
+        //a failed first row sends its whole page again
+        CHECK(sim.seq_rows <= ((MAX_RESENDS + 1) * PAGE_ROWS) + 8, "%d rows sent after failing",
+              sim.seq_rows);
+    }
+    showOutput();
+}
+
+int main(int argc, char** argv)
+{
+    static const fault_t row_checksum[] = {
+        { 10, 3, FAULT_CHECKSUM }, { 0, 0, FAULT_NONE } };
+    static const fault_t erase_checksum[] = {
+        { 11, 0, FAULT_CHECKSUM }, { 0, 0, FAULT_NONE } };
+    static const fault_t row_verify[] = {
+        { 12, 5, FAULT_VERIFY }, { 0, 0, FAULT_NONE } };
+    static const fault_t many_verify[] = {
+        { 9, 1, FAULT_VERIFY }, { 10, 1, FAULT_VERIFY }, { 11, 1, FAULT_VERIFY },
+        { 12, 1, FAULT_VERIFY }, { 13, 1, FAULT_VERIFY }, { 14, 1, FAULT_VERIFY },
+        { 15, 1, FAULT_VERIFY }, { 16, 1, FAULT_VERIFY }, { 0, 0, FAULT_NONE } };
+    static const fault_t swapped[] = {
+        { 10, 2, FAULT_SWAP }, { 0, 0, FAULT_NONE } };
+    static const fault_t lost[] = {
+        { 10, 2, FAULT_DROP }, { 0, 0, FAULT_NONE } };
+    char dir[] = "/tmp/loader_test_hexXXXXXX";
+
+    if( argc != 2 )
+    {
+        fprintf(stderr, "usage: %s path/to/pirate-loader\n", argv[0]);
+        return 1;
+    }
+    g_loader = argv[1];
+
+    if( !mkdtemp(dir) )
+    {
+        perror("mkdtemp");
+        return 1;
+    }
+    snprintf(g_hex, sizeof(g_hex), "%s/image.hex", dir);
+    writeHex(g_hex, 1);
+
+    testFullWrite();
+    testDiff("--diff");
+    testDiff("--diff --window=8");
+
+    testWindow("no faults", "--window=8", NO_FAULTS, 0, NULL);
+    testWindow("bad checksum", "--window=8", row_checksum, 1, "row 83 failed [N]");
+    //the page erase did not happen, the whole page goes again
+    testWindow("bad checksum on the erase row", "--window=8", erase_checksum, PAGE_ROWS,
+               "row 88 failed [N]");
+    testWindow("failed verify", "--window=8", row_verify, PAGE_ROWS, "row 101 failed [V]");
+    //eight pages queued for resending at once
+    testWindow("failed verify on eight pages", "--window=64", many_verify, 8 * PAGE_ROWS,
+               "row 129 failed [V]");
+
+    testWindowAbort("reply out of order", swapped, 0, "Sequence mismatch");
+    testWindowAbort("lost reply", lost, 0, "Sequence mismatch");
+    testWindowAbort("every row fails", NO_FAULTS, 1, "Too many failed rows");
+
+    unlink(g_hex);
+    rmdir(dir);
+
+    if( failures )
+    {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+
+    printf("pirate-loader tests passed\n");
+    return 0;
+}
@@ -58,6 +58,12 @@ static const uint8_t ONEWIRE_MODE_IDENTIFIER[] = {'1', 'W', '0', '1'};
  */
 #define ROM_BYTES_SIZE 8
 
+/**
+ * How many times a search step is repeated when it hits a bus error, like a ROM
+ * number failing its CRC8 check, before giving up on the enumeration.
+ */
+#define SEARCH_RETRIES 3
+
 /**
  * Data line pin assignment.
  */
@@ -98,6 +104,44 @@ static const uint8_t ONEWIRE_MODE_IDENTIFIER[] = {'1', 'W', '0', '1'};
  */
 #define MACRO_ID_SEARCH_ROM 0xF0
 
+/**
+ * Identifier for the "Overdrive Skip ROM" macro entry.
+ *
+ * Puts all overdrive capable devices in overdrive mode, and switches the bus
+ * timing to overdrive speed.
+ */
+#define MACRO_ID_OVERDRIVE_SKIP_ROM 0x3C
+
+/**
+ * Identifier for the "Overdrive Match ROM" macro entry.
+ *
+ * Puts the device whose ROM number follows in overdrive mode, and switches the
+ * bus timing to overdrive speed.
+ */
+#define MACRO_ID_OVERDRIVE_MATCH_ROM 0x69
+
+/**
+ * Identifier for the "Standard speed" macro entry.
+ *
+ * Switches the bus timing back to standard speed and resets the bus, which
+ * takes all devices out of overdrive mode.
+ */
+#define MACRO_ID_STANDARD_SPEED 0x53
+
+/**
+ * Waits for a quarter of a microsecond, when running at 16 MIPS.
+ *
+ * Overdrive time slots need sub-microsecond timing that bp_delay_us cannot
+ * provide, as its call overhead alone is bigger than that.
+ */
+#define ONEWIRE_QUARTER_US_DELAY()                                             \
+  do {                                                                         \
+    Nop();                                                                     \
+    Nop();                                                                     \
+    Nop();                                                                     \
+    Nop();                                                                     \
+  } while (0)
+
 /**
  * Sends and receives 1-bit values on/from the bus.
  *
@@ -208,7 +252,7 @@ typedef struct {
   /**
    * Device roster slots.
    */
-  uint8_t roster_entries[ROM_BYTES_SIZE][BP_1WIRE_DEVICE_DEV_ROSTER_SLOTS];
+  uint8_t roster_entries[BP_1WIRE_DEVICE_DEV_ROSTER_SLOTS][ROM_BYTES_SIZE];
 
   /**
    * The command byte to send on the bus.
@@ -230,6 +274,24 @@ typedef struct {
    */
   uint8_t last_device_flag : 1;
 
+  /**
+   * Flag indicating if the bus is being driven with overdrive timing.
+   */
+  uint8_t overdrive : 1;
+
+  /**
+   * Flag indicating if the last search was cut short by a bus error: either
+   * the ROM number read back failed its CRC8 check, or no device answered
+   * past the first ROM bit.
+   */
+  uint8_t search_error : 1;
+
+  /**
+   * Flag indicating if a binary I/O roster search filled the roster with more
+   * devices left, the next one being in rom_bytes.
+   */
+  uint8_t roster_search_pending : 1;
+
 } __attribute__((packed)) onewire_state_t;
 
 /**
@@ -245,6 +307,19 @@ static onewire_state_t onewire_state = {.command_byte = MACRO_ID_SEARCH_ROM};
  */
 static onewire_bus_reset_result_t perform_bus_reset(void);
 
+/**
+ * Performs a standard speed bus reset followed by an overdrive ROM command,
+ * then switches the bus timing to overdrive speed.
+ *
+ * @param[in] command either MACRO_ID_OVERDRIVE_SKIP_ROM or
+ *                    MACRO_ID_OVERDRIVE_MATCH_ROM.
+ *
+ * @return an appropriate state from onewire_bus_reset_result_t describing
+ * the standard speed reset result.  Timing is left at standard speed unless
+ * the reset was successful.
+ */
+static onewire_bus_reset_result_t enter_overdrive(uint8_t command);
+
 /**
  * 1-wire protocol precalculated CRC table.
  *
@@ -313,6 +388,14 @@ static bool device_find_first(void);
  */
 static bool device_find_next(void);
 
+/**
+ * Runs a search step, repeating it from the same search state if it hits a
+ * bus error, like the ROM number read back failing its CRC8 check.
+ *
+ * @return true if a device was found, false otherwise.
+ */
+static bool device_find_checked(void);
+
 /**
  * Discovers the next device in the chain on a 1-Wire bus.
  *
@@ -370,6 +453,9 @@ void onewire_setup(void) {
   /* Clear the saved device roster entries. */
   onewire_state.used_roster_entries = 0;
 
+  /* Devices start at standard speed. */
+  onewire_state.overdrive = false;
+
   /* Set up pins. */
   ONEWIRE_DATA_DIRECTION = INPUT;
   ONEWIRE_DATA_LINE = LOW;
@@ -531,6 +617,26 @@ void onewire_run_macro(uint16_t macro) {
     ONEWIRE_WRITE_BYTE(MACRO_ID_SKIP_ROM);
     break;
 
+  case MACRO_ID_OVERDRIVE_SKIP_ROM:
+  case MACRO_ID_OVERDRIVE_MATCH_ROM:
+    /* Devices only listen for overdrive commands after a standard reset. */
+    onewire_state.overdrive = false;
+    onewire_reset();
+    if (macro == MACRO_ID_OVERDRIVE_SKIP_ROM) {
+      BPMSG1288;
+    } else {
+      BPMSG1289;
+    }
+    ONEWIRE_WRITE_BYTE(macro);
+    onewire_state.overdrive = true;
+    break;
+
+  case MACRO_ID_STANDARD_SPEED:
+    onewire_state.overdrive = false;
+    onewire_reset();
+    BPMSG1290;
+    break;
+
   default:
     BPMSG1016;
   }
@@ -568,15 +674,49 @@ void onewire_reset(void) {
 onewire_bus_reset_result_t perform_bus_reset(void) {
   onewire_bus_reset_result_t result;
   size_t delay;
+  int saved_ipl;
 
   result = ONEWIRE_BUS_RESET_OK;
 
+  if (onewire_state.overdrive) {
+    /*
+     * An interrupt would stretch the reset pulse or move the presence sample
+     * out of its window, mask them all as sump_asm.s does.
+     */
+    SET_AND_SAVE_CPU_IPL(saved_ipl, 7);
+  }
+
   /* Pull the bus line LOW. */
 
   ONEWIRE_DATA_DIRECTION = INPUT;
   ONEWIRE_DATA_LINE = LOW;
   ONEWIRE_DATA_DIRECTION = OUTPUT;
 
+  if (onewire_state.overdrive) {
+
+    /*
+     * Overdrive reset: 70us low, presence sampled 8us after the release and
+     * the bus checked again once the 48us minimum high time has passed.
+     */
+
+    bp_delay_us(70);
+    ONEWIRE_DATA_DIRECTION = INPUT;
+    bp_delay_us(8);
+
+    if (ONEWIRE_DATA_LINE) {
+      result = ONEWIRE_BUS_RESET_NO_DEVICE;
+    }
+
+    RESTORE_CPU_IPL(saved_ipl);
+    bp_delay_us(45);
+
+    if (ONEWIRE_DATA_LINE == LOW) {
+      result = ONEWIRE_BUS_RESET_SHORT;
+    }
+
+    return result;
+  }
+
   /*
    * According to specification a minimum of 480us need to be waited before
    * reading the line.
@@ -615,6 +755,19 @@ onewire_bus_reset_result_t perform_bus_reset(void) {
   return result;
 }
 
+onewire_bus_reset_result_t enter_overdrive(uint8_t command) {
+  onewire_bus_reset_result_t result;
+
+  onewire_state.overdrive = false;
+  result = perform_bus_reset();
+  if (result == ONEWIRE_BUS_RESET_OK) {
+    ONEWIRE_WRITE_BYTE(command);
+    onewire_state.overdrive = true;
+  }
+
+  return result;
+}
+
 #ifdef BP_1WIRE_LOOKUP_FAMILY_ID
 
 /* TODO: Expand this table from the data at
@@ -659,11 +812,42 @@ bool device_find_first() {
   onewire_state.last_device_discrepancy = 0;
   onewire_state.last_family_discrepancy = 0;
   onewire_state.last_device_flag = false;
+  onewire_state.roster_search_pending = false;
 
-  return perform_device_search();
+  return device_find_checked();
 }
 
-bool device_find_next() { return perform_device_search(); }
+bool device_find_next() { return device_find_checked(); }
+
+bool device_find_checked(void) {
+  uint8_t rom_bytes[ROM_BYTES_SIZE];
+  uint8_t last_device_discrepancy;
+  uint8_t last_family_discrepancy;
+  bool last_device_flag;
+  uint8_t retries;
+
+  /* A failed search clears the search state, so keep a copy to retry from. */
+
+  memcpy(rom_bytes, onewire_state.rom_bytes, sizeof(rom_bytes));
+  last_device_discrepancy = onewire_state.last_device_discrepancy;
+  last_family_discrepancy = onewire_state.last_family_discrepancy;
+  last_device_flag = onewire_state.last_device_flag;
+
+  for (retries = 0;; retries++) {
+    if (perform_device_search()) {
+      return true;
+    }
+
+    if (!onewire_state.search_error || (retries == SEARCH_RETRIES)) {
+      return false;
+    }
+
+    memcpy(onewire_state.rom_bytes, rom_bytes, sizeof(rom_bytes));
+    onewire_state.last_device_discrepancy = last_device_discrepancy;
+    onewire_state.last_family_discrepancy = last_family_discrepancy;
+    onewire_state.last_device_flag = last_device_flag;
+  }
+}
 
 bool perform_device_search() {
   bool id_bit;
@@ -682,6 +866,7 @@ bool perform_device_search() {
   rom_byte_mask = 1;
   search_result = 0;
   onewire_state.crc8 = 0;
+  onewire_state.search_error = false;
 
   /* Check if the bus enumeration is still in progress. */
 
@@ -710,7 +895,14 @@ bool perform_device_search() {
 
       if ((id_bit == ON) && (cmp_id_bit == ON)) {
 
-        /* No devices on the line, bail out. */
+        /*
+         * No devices on the line, bail out.  Past the first bit this means the
+         * devices being followed dropped out, which is a bus error.
+         */
+
+        if (id_bit_number > 1) {
+          onewire_state.search_error = true;
+        }
 
         break;
       }
@@ -797,6 +989,11 @@ bool perform_device_search() {
       /* Found a device. */
 
       search_result = true;
+    } else if (id_bit_number == 65) {
+
+      /* All 64 bits were read, but the CRC8 does not match. */
+
+      onewire_state.search_error = true;
     }
   }
 
@@ -912,6 +1109,55 @@ uint8_t update_crc8(uint8_t value) {
  */
 #define BINARY_IO_ONEWIRE_COMMAND_READ_PERIPHERALS 0x05
 
+/**
+ * Binary I/O 1-Wire Speed configuration command.
+ *
+ * Selects the bus timing used by all following resets, reads, and bulk
+ * transfers.  The overdrive entry actions perform a standard speed bus reset
+ * and send the relevant overdrive ROM command before switching timing; for
+ * Overdrive Match ROM the ROM number is then sent with a bulk transfer, at
+ * overdrive speed.  The board responds with a SUCCESS value, or with a
+ * FAILURE value if the speed is unknown or no device answered the reset - in
+ * which case timing stays at standard speed.
+ *
+ * Current format is as follows:
+ *
+ * MSB
+ * 0110xxxx
+ *     ||||
+ *     ++++--> 0000: standard speed.
+ *             0001: overdrive speed.
+ *             0010: standard reset, Overdrive Skip ROM (0x3C), overdrive speed.
+ *             0011: standard reset, Overdrive Match ROM (0x69), overdrive
+ *                   speed.
+ *
+ * Interaction flow is as follows:
+ *
+ * PC         -> 0b0110xxxx
+ * Bus Pirate <- 0b00000001 (SUCCESS)
+ */
+#define BINARY_IO_ONEWIRE_COMMAND_SET_SPEED 0x06
+
+/**
+ * Binary I/O 1-Wire standard speed timing selection.
+ */
+#define BINARY_IO_ONEWIRE_SPEED_STANDARD 0x00
+
+/**
+ * Binary I/O 1-Wire overdrive speed timing selection.
+ */
+#define BINARY_IO_ONEWIRE_SPEED_OVERDRIVE 0x01
+
+/**
+ * Binary I/O 1-Wire Overdrive Skip ROM speed selection.
+ */
+#define BINARY_IO_ONEWIRE_SPEED_OVERDRIVE_SKIP_ROM 0x02
+
+/**
+ * Binary I/O 1-Wire Overdrive Match ROM speed selection.
+ */
+#define BINARY_IO_ONEWIRE_SPEED_OVERDRIVE_MATCH_ROM 0x03
+
 /**
  * Binary I/O 1-Wire Action command to exit 1-Wire mode.
  *
@@ -1044,6 +1290,105 @@ uint8_t update_crc8(uint8_t value) {
  */
 #define BINARY_IO_ONEWIRE_ACTION_ALARM_SEARCH_MACRO 0x09
 
+/**
+ * Binary I/O 1-Wire Action command to build a device roster with a "ROM
+ * search".
+ *
+ * This action enumerates the devices on the bus, stores their ROM numbers in
+ * the device roster, and sends the roster back at once when done.  Every ROM
+ * number is checked against its CRC8, and search steps returning a bad ROM
+ * number, or losing all devices half way, are repeated on the board before the
+ * enumeration is given up.
+ *
+ * The roster holds BP_1WIRE_DEVICE_DEV_ROSTER_SLOTS devices: on busier buses
+ * the reply carries the first batch, with the "more" status bit set, and the
+ * search state is kept on the board so that
+ * BINARY_IO_ONEWIRE_ACTION_CONTINUE_SEARCH_ROSTER sends the following batches.
+ *
+ * The response starts with a SUCCESS value, followed by a status byte and by
+ * the number of devices in this batch, then by the eight ROM bytes of each
+ * device.  Status bits are:
+ *
+ * MSB
+ * 000000xy
+ *       ||
+ *       |+--> More devices were found, send a continue action to get them.
+ *       +---> A search step kept hitting bus errors, like a ROM number
+ *             failing its CRC8 check; the search was stopped there.
+ *
+ * Current format is as follows:
+ *
+ * MSB
+ * 00001010
+ * ||||||||
+ * ||||++++--> ROM search roster action.
+ * ++++------> Action command.
+ *
+ * Interaction flow is as follows:
+ *
+ * PC         -> 0b00001010
+ * Bus Pirate <- 0b00000001 (SUCCESS)
+ * Bus Pirate <- 0b000000xy (Status)
+ * Bus Pirate <- 0bxxxxxxxx (Number of devices)
+ * Bus Pirate <- 0bxxxxxxxx 0bxxxxxxxx ... (8 ROM bytes per device)
+ */
+#define BINARY_IO_ONEWIRE_ACTION_ROM_SEARCH_ROSTER 0x0A
+
+/**
+ * Binary I/O 1-Wire Action command to build a device roster with an "ALARM
+ * search".
+ *
+ * Behaves like BINARY_IO_ONEWIRE_ACTION_ROM_SEARCH_ROSTER, but only devices in
+ * ALARM state are enumerated.
+ *
+ * Current format is as follows:
+ *
+ * MSB
+ * 00001011
+ * ||||||||
+ * ||||++++--> ALARM search roster action.
+ * ++++------> Action command.
+ */
+#define BINARY_IO_ONEWIRE_ACTION_ALARM_SEARCH_ROSTER 0x0B
+
+/**
+ * Binary I/O 1-Wire Action command to get the next batch of a roster search.
+ *
+ * Resumes a ROM or ALARM roster search whose last reply had the "more" status
+ * bit set, and replies in the same format with the following devices.  If
+ * there is no search to resume, like when the previous batch was the last one
+ * or another search was run in between, FAILURE is sent instead.
+ *
+ * Current format is as follows:
+ *
+ * MSB
+ * 00001100
+ * ||||||||
+ * ||||++++--> Continue search roster action.
+ * ++++------> Action command.
+ *
+ * Interaction flow is as follows:
+ *
+ * PC         -> 0b00001100
+ * Bus Pirate <- 0b00000001 (SUCCESS)
+ * Bus Pirate <- 0b000000xy (Status)
+ * Bus Pirate <- 0bxxxxxxxx (Number of devices)
+ * Bus Pirate <- 0bxxxxxxxx 0bxxxxxxxx ... (8 ROM bytes per device)
+ */
+#define BINARY_IO_ONEWIRE_ACTION_CONTINUE_SEARCH_ROSTER 0x0C
+
+/**
+ * Roster search status bit set when more devices are left for a continue
+ * action.
+ */
+#define BINARY_IO_ONEWIRE_ROSTER_MORE 0x01
+
+/**
+ * Roster search status bit set when a search step hit bus errors more than
+ * SEARCH_RETRIES times.
+ */
+#define BINARY_IO_ONEWIRE_ROSTER_SEARCH_ERROR 0x02
+
 void print_1wire_version_string(void) {
   bp_write_buffer(&ONEWIRE_MODE_IDENTIFIER[0], sizeof(ONEWIRE_MODE_IDENTIFIER));
 }
@@ -1063,6 +1408,8 @@ void binary_io_enter_1wire_mode(void) {
   /* Just in case. */
 
   mode_configuration.lsbEN = false;
+  onewire_state.overdrive = false;
+  onewire_state.roster_search_pending = false;
 
   /* Send version string. */
 
@@ -1123,6 +1470,59 @@ void binary_io_enter_1wire_mode(void) {
         break;
       }
 
+      case BINARY_IO_ONEWIRE_ACTION_ROM_SEARCH_ROSTER:
+      case BINARY_IO_ONEWIRE_ACTION_ALARM_SEARCH_ROSTER:
+      case BINARY_IO_ONEWIRE_ACTION_CONTINUE_SEARCH_ROSTER: {
+        uint8_t header[3];
+        bool next;
+
+        if (input_byte == BINARY_IO_ONEWIRE_ACTION_CONTINUE_SEARCH_ROSTER) {
+          if (!onewire_state.roster_search_pending) {
+            UART1TX(BP_BINARY_IO_RESULT_FAILURE);
+            break;
+          }
+
+          /* The device found past the previous batch is still here. */
+          next = true;
+        } else {
+          onewire_state.command_byte =
+              (input_byte == BINARY_IO_ONEWIRE_ACTION_ALARM_SEARCH_ROSTER)
+                  ? MACRO_ID_ALARM_SEARCH
+                  : MACRO_ID_SEARCH_ROM;
+          next = device_find_first();
+        }
+
+        header[0] = BP_BINARY_IO_RESULT_SUCCESS;
+        header[1] = 0;
+        onewire_state.used_roster_entries = 0;
+        onewire_state.roster_search_pending = false;
+
+        while (next) {
+          if (onewire_state.used_roster_entries ==
+              BP_1WIRE_DEVICE_DEV_ROSTER_SLOTS) {
+            header[1] |= BINARY_IO_ONEWIRE_ROSTER_MORE;
+            onewire_state.roster_search_pending = true;
+            break;
+          }
+
+          memcpy(
+              onewire_state.roster_entries[onewire_state.used_roster_entries],
+              onewire_state.rom_bytes, sizeof(onewire_state.rom_bytes));
+          onewire_state.used_roster_entries++;
+          next = device_find_next();
+        }
+
+        if (!next && onewire_state.search_error) {
+          header[1] |= BINARY_IO_ONEWIRE_ROSTER_SEARCH_ERROR;
+        }
+
+        header[2] = onewire_state.used_roster_entries;
+        bp_write_buffer(header, sizeof(header));
+        bp_write_buffer(&onewire_state.roster_entries[0][0],
+                        onewire_state.used_roster_entries * ROM_BYTES_SIZE);
+        break;
+      }
+
       default:
         UART1TX(BP_BINARY_IO_RESULT_FAILURE);
         break;
@@ -1154,6 +1554,38 @@ void binary_io_enter_1wire_mode(void) {
       break;
 #endif /* BUSPIRATEV4 */
 
+    case BINARY_IO_ONEWIRE_COMMAND_SET_SPEED:
+      switch (input_byte & 0x0F) {
+      case BINARY_IO_ONEWIRE_SPEED_STANDARD:
+        onewire_state.overdrive = false;
+        UART1TX(BP_BINARY_IO_RESULT_SUCCESS);
+        break;
+
+      case BINARY_IO_ONEWIRE_SPEED_OVERDRIVE:
+        onewire_state.overdrive = true;
+        UART1TX(BP_BINARY_IO_RESULT_SUCCESS);
+        break;
+
+      case BINARY_IO_ONEWIRE_SPEED_OVERDRIVE_SKIP_ROM:
+      case BINARY_IO_ONEWIRE_SPEED_OVERDRIVE_MATCH_ROM: {
+        uint8_t rom_command;
+
+        rom_command = ((input_byte & 0x0F) ==
+                       BINARY_IO_ONEWIRE_SPEED_OVERDRIVE_SKIP_ROM)
+                          ? MACRO_ID_OVERDRIVE_SKIP_ROM
+                          : MACRO_ID_OVERDRIVE_MATCH_ROM;
+        UART1TX((enter_overdrive(rom_command) == ONEWIRE_BUS_RESET_OK)
+                    ? BP_BINARY_IO_RESULT_SUCCESS
+                    : BP_BINARY_IO_RESULT_FAILURE);
+        break;
+      }
+
+      default:
+        UART1TX(BP_BINARY_IO_RESULT_FAILURE);
+        break;
+      }
+      break;
+
     default:
       UART1TX(BP_BINARY_IO_RESULT_FAILURE);
       break;
@@ -1162,10 +1594,45 @@ void binary_io_enter_1wire_mode(void) {
 }
 
 bool onewire_internal_bit_io(bool bit_value) {
+  int saved_ipl;
+
+  if (onewire_state.overdrive) {
+    /* Interrupts are masked across the slot, it has no room for them. */
+    SET_AND_SAVE_CPU_IPL(saved_ipl, 7);
+  }
+
   ONEWIRE_DATA_DIRECTION = INPUT;
   ONEWIRE_DATA_LINE = LOW;
   ONEWIRE_DATA_DIRECTION = OUTPUT;
 
+  if (onewire_state.overdrive) {
+
+    /*
+     * Overdrive slot: 1us low for a 1 or a read, with the line sampled well
+     * within the 2us window, or 7.5us low for a 0.  Either way the slot plus
+     * recovery takes about 10us.
+     */
+
+    ONEWIRE_QUARTER_US_DELAY();
+    ONEWIRE_QUARTER_US_DELAY();
+    ONEWIRE_QUARTER_US_DELAY();
+    if (bit_value) {
+      ONEWIRE_DATA_DIRECTION = INPUT;
+      ONEWIRE_QUARTER_US_DELAY();
+      ONEWIRE_QUARTER_US_DELAY();
+      bit_value = ONEWIRE_DATA_LINE;
+      RESTORE_CPU_IPL(saved_ipl);
+      bp_delay_us(7);
+    } else {
+      bp_delay_us(6);
+      ONEWIRE_DATA_DIRECTION = INPUT;
+      RESTORE_CPU_IPL(saved_ipl);
+      bp_delay_us(2);
+    }
+
+    return bit_value;
+  }
+
   bp_delay_us(4);
   if (bit_value) {
     ONEWIRE_DATA_DIRECTION = INPUT;
@@ -1220,7 +1687,9 @@ uint8_t onewire_internal_byte_io(uint8_t byte_value) {
     }
   }
 
-  bp_delay_us(8);
+  if (!onewire_state.overdrive) {
+    bp_delay_us(8);
+  }
 
   return byte_value;
 }
@@ -13,8 +13,11 @@
  *    but WITHOUT ANY WARRANTY; without even the implied warranty of
  *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
  */
+#include <string.h>
+
 #include "base.h"
 #include "bus_pirate_core.h"
+#include "perf_counters.h"
 
 static const uint8_t HEX_PREFIX[] = {
     '0', 'x'
@@ -25,6 +28,21 @@ static const unsigned char HEXASCII[] = {
     '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'
 };
 
+static const uint8_t LINE_END[] = {
+    0x0D, 0x0A
+};
+
+//the decimal formatters find each digit by repeated subtraction of these
+//rather than with a 32 bit division
+static const unsigned long DECIMAL_POWERS[] = {
+    100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10
+};
+
+#define DECIMAL_POWERS_LONG 0 //first power for 32 bit values
+#define DECIMAL_POWERS_INT 4 //16 bit
+#define DECIMAL_POWERS_BYTE 6 //8 bit
+#define DECIMAL_LENGTH_MAX 10
+
 extern bus_pirate_configuration_t bus_pirate_configuration;
 
 #if defined (BUSPIRATEV4)
@@ -46,67 +64,90 @@ void bpEchoState(unsigned int c) {
 //
 
 void bp_write_buffer(const uint8_t *buffer, size_t length) {
+#if defined(BUSPIRATEV4) && !defined(BPV4_DEBUG)
+    if (bus_pirate_configuration.quiet) return;
+    PERF_COUNT_OUT_BLOCK(length);
+    put_cdc_block(buffer, length); //whole packets instead of a putc_cdc per byte
+#else
     size_t offset;
     
     for (offset = 0; offset < length; offset++) {
         UART1TX(buffer[offset]);
     }
+#endif
 }
 
-void bp_write_string(const char *string) {
-    char character;
-    while ((character = *string++)) {
-        UART1TX(character);
+void bp_read_buffer(uint8_t *buffer, size_t length) {
+#if defined(BUSPIRATEV4) && !defined(BPV4_DEBUG)
+    PERF_COUNT_IN_BLOCK(length);
+    get_cdc_block(buffer, length); //copies whole OUT packets at a time
+#else
+    size_t offset;
+
+    for (offset = 0; offset < length; offset++) {
+        buffer[offset] = UART1RX();
     }
+#endif
+}
+
+void bp_write_string(const char *string) {
+    bp_write_buffer((const uint8_t *) string, strlen(string));
 }
 
 void bp_write_line(const char *string) {
-    char character;
-    while ((character = *string++)) {
-        UART1TX(character);
+    bp_write_buffer((const uint8_t *) string, strlen(string));
+    bp_write_buffer(&LINE_END[0], sizeof(LINE_END));
+}
+
+//The formatters below render into a small buffer on the stack and send it
+//with one bp_write_buffer() call, which on a v4 is one copy into the USB
+//packet instead of a putc_cdc() per character.
+
+//render a decimal value without leading zeros, starting at the given power
+//of ten, returns the length. A first digit over 9 is sent as is ('0' + n),
+//as the division based formatters always did.
+
+static size_t bp_format_decimal(uint8_t *buffer, unsigned long value, unsigned char power) {
+    size_t length = 0;
+    unsigned char digit;
+
+    for (; power < (sizeof(DECIMAL_POWERS) / sizeof(DECIMAL_POWERS[0])); power++) {
+        digit = 0;
+        while (value >= DECIMAL_POWERS[power]) {
+            value -= DECIMAL_POWERS[power];
+            digit++;
+        }
+        if (length || digit) {
+            buffer[length++] = digit + '0';
+        }
     }
-    
-    UART1TX(0x0D);
-    UART1TX(0x0A);
+    buffer[length++] = value + '0';
+
+    return length;
 }
 
 //output an 8bit/byte binary value to the user terminal
 
 void bpWbin(unsigned char c) {
-    unsigned char i, j;
-    j = 0b10000000;
-
-    bp_write_string("0b");
+    uint8_t buffer[10];
+    unsigned char i;
 
+    buffer[0] = '0';
+    buffer[1] = 'b';
     for (i = 0; i < 8; i++) {
-        if (c & j) {
-            UART1TX('1');
-        } else {
-            UART1TX('0');
-        }
-        j >>= 1;
+        buffer[i + 2] = (c & 0b10000000) ? '1' : '0';
+        c <<= 1;
     }
 
+    bp_write_buffer(buffer, sizeof(buffer));
 }
 
 //output an 32bit/long decimal value to the user terminal
 
 void bpWlongdec(unsigned long l) {
-    unsigned long c, m;
-    unsigned char j, k = 0;
-
-    c = 100000000;
-    for (j = 0; j < 8; j++) {
-        m = l / c;
-        if (k || m) {
-            UART1TX(m + '0');
-            l = l - (m * c);
-            k = 1;
-        }
-        c /= 10;
-    }
-    UART1TX(l + '0');
+    uint8_t buffer[DECIMAL_LENGTH_MAX];
 
+    bp_write_buffer(buffer, bp_format_decimal(buffer, l, DECIMAL_POWERS_LONG));
 }
 
 // userfriendly printing of looooonng ints
@@ -160,49 +201,27 @@ void bpWlongdecf(unsigned long l) {
 //output an 16bit/integer decimal value to the user terminal
 
 void bpWintdec(unsigned int i) {
-    unsigned int c, m;
-    unsigned char j, k = 0;
-
-    c = 10000;
-    for (j = 0; j < 4; j++) {
-        m = i / c;
-        if (k || m) {
-            UART1TX(m + '0');
-            i = i - (m * c);
-            k = 1;
-        }
-        c /= 10;
-    }
-    UART1TX(i + '0');
+    uint8_t buffer[DECIMAL_LENGTH_MAX];
+
+    bp_write_buffer(buffer, bp_format_decimal(buffer, i, DECIMAL_POWERS_INT));
 }
 
 //output an 8bit/byte decimal value to the user terminal
 
 void bpWdec(unsigned char c) {
-    unsigned char d, j, m, k = 0;
-
-    d = 100;
-    for (j = 0; j < 2; j++) {
-        m = c / d;
-        if (k || m) {
-            UART1TX(m + '0');
-            c = c - (m * d);
-            k = 1;
-        }
-        d /= 10;
-    }
-    UART1TX(c + '0');
+    uint8_t buffer[DECIMAL_LENGTH_MAX];
+
+    bp_write_buffer(buffer, bp_format_decimal(buffer, c, DECIMAL_POWERS_BYTE));
 }
 
 void bpWhex(unsigned int c) {
-    unsigned int b;
+    uint8_t buffer[4];
 
-    bp_write_buffer(&HEX_PREFIX[0], sizeof(HEX_PREFIX));
-    b = (c >> 4) & 0x0F;
-    UART1TX(HEXASCII[b]);
-    b = c & 0x0F;
-    UART1TX(HEXASCII[b]);
-    return;
+    buffer[0] = HEX_PREFIX[0];
+    buffer[1] = HEX_PREFIX[1];
+    buffer[2] = HEXASCII[(c >> 4) & 0x0F];
+    buffer[3] = HEXASCII[c & 0x0F];
+    bp_write_buffer(buffer, sizeof(buffer));
 }
 
 void bpWhexBuf(unsigned int c) {
@@ -217,27 +236,41 @@ void bpWhexBuf(unsigned int c) {
     return;
 }
 
+//report how close the UARTbuf ring buffer came to overflowing
+
+void UARTbufReport(void) {
+#ifdef BUSPIRATEV3
+    unsigned int high_water, overflows;
+
+    UARTbufStats(&high_water, &overflows);
+    bp_write_string("Buffer peak ");
+    bpWintdec(high_water);
+    bp_write_string(" bytes, ");
+    bpWintdec(overflows);
+    bp_write_line(" dropped");
+#endif
+}
+
 // output a 16bit hex value to the user terminal
 
 void bpWinthex(unsigned int c) {
-    unsigned int b;
+    uint8_t buffer[6];
 
-    bp_write_buffer(&HEX_PREFIX[0], sizeof(HEX_PREFIX));
-    b = (c >> 12) & 0x0F;
-    UART1TX(HEXASCII[b]);
-    b = (c >> 8) & 0x0F;
-    UART1TX(HEXASCII[b]);
-    b = (c >> 4) & 0x0F;
-    UART1TX(HEXASCII[b]);
-    b = c & 0x0F;
-    UART1TX(HEXASCII[b]);
-    return;
+    buffer[0] = HEX_PREFIX[0];
+    buffer[1] = HEX_PREFIX[1];
+    buffer[2] = HEXASCII[(c >> 12) & 0x0F];
+    buffer[3] = HEXASCII[(c >> 8) & 0x0F];
+    buffer[4] = HEXASCII[(c >> 4) & 0x0F];
+    buffer[5] = HEXASCII[c & 0x0F];
+    bp_write_buffer(buffer, sizeof(buffer));
 }
 
 
 //print an ADC measurement in decimal form
 
 void bpWvolts(const unsigned int adc) {
+    uint8_t buffer[(DECIMAL_LENGTH_MAX * 2) + 2];
+    size_t length;
     unsigned char c;
 
     // input voltage is divided by two and compared to 3.3V
@@ -247,16 +280,17 @@ void bpWvolts(const unsigned int adc) {
     // fit in an unsigned int. The error is less than 1mV.
     const unsigned int centivolt = (adc * 29) / 45;
 
-    bpWdec(centivolt / 100);
+    length = bp_format_decimal(buffer, (unsigned char) (centivolt / 100), DECIMAL_POWERS_BYTE);
 
-    UART1TX('.');
+    buffer[length++] = '.';
 
     c = centivolt % 100;
 
     if (c < 10) // need extra zero?
-        UART1TX('0');
+        buffer[length++] = '0';
 
-    bpWdec(centivolt % 100);
+    length += bp_format_decimal(&buffer[length], c, DECIMAL_POWERS_BYTE);
+    bp_write_buffer(buffer, length);
 }
 
 
@@ -309,60 +343,120 @@ unsigned char UART1RXRdy(void) {
 //uses user terminal input buffer to buffer UART output
 //any existing user input will be destroyed
 //best used for binary mode and sniffers
+//
+//the U1TX interrupt drains the buffer: it fires when the UART transmit FIFO
+//runs empty and refills all of it, so the sniffers send at the full terminal
+//speed whatever their polling loops are doing. UARTbuf starts the interrupt
+//when it finds it stopped, the interrupt stops itself once the buffer is
+//empty, and UARTbufFlush hands the UART back to the polled functions.
 //static struct _UARTRINGBUF{
-static unsigned int writepointer;
-static unsigned int readpointer;
+static volatile unsigned int writepointer = 1; //empty, as after UARTbufSetup
+static volatile unsigned int readpointer = 0;
 //}ringBuf;
+static volatile unsigned char ringDrain; //U1TX interrupt serves the ring buffer, not UART1TXBuf
+static unsigned int ringHighWater; //most bytes waiting since UARTbufSetup
+static unsigned int ringOverflows; //bytes dropped since UARTbufSetup
 
 void UARTbufSetup(void) {
+    UARTbufFlush(); //wait for anything still queued
     //setup ring buffer pointers
     readpointer = 0;
     writepointer = 1;
+    ringHighWater = 0;
+    ringOverflows = 0;
     bus_pirate_configuration.overflow = 0;
 }
 
-void UARTbufService(void) {
+//start the U1TX interrupt, it fires right away
+static void UARTbufKick(void) {
+    if (ringDrain == 0) {
+        ringDrain = 1;
+        U1STAbits.UTXISEL1 = 1; //interrupt when the transmit FIFO becomes empty
+        U1STAbits.UTXISEL0 = 0;
+    }
+    IFS0bits.U1TXIF = 1;
+    IEC0bits.U1TXIE = 1;
+}
+
+//fill the transmit FIFO from the ring buffer, U1TX interrupt context
+static void UARTbufDrain(void) {
     unsigned int i;
-    if (U1STAbits.UTXBF == 0) {//check first for free slot
 
+    while (U1STAbits.UTXBF == 0) {
         i = readpointer + 1;
         if (i == BP_TERMINAL_BUFFER_SIZE) i = 0; //check for wrap
-        if (i == writepointer) return; //buffer empty,
+        if (i == writepointer) { //buffer empty, UARTbuf restarts us
+            IEC0bits.U1TXIE = 0;
+            return;
+        }
         readpointer = i;
-        U1TXREG = bus_pirate_configuration.terminal_input[readpointer]; //move a byte to UART
+        U1TXREG = bus_pirate_configuration.terminal_input[i]; //move a byte to UART
     }
 }
 
+void UARTbufService(void) {
+    //the interrupt does the work, only restart it if it missed a byte
+    if (IEC0bits.U1TXIE == 0 && UARTbufFree() != (BP_TERMINAL_BUFFER_SIZE - 1)) UARTbufKick();
+}
+
 void UARTbufFlush(void) {
-    unsigned int i;
+    UARTbufService();
+    while (IEC0bits.U1TXIE == 1 && ringDrain == 1); //wait for the interrupt to empty the buffer
 
-    while (1) {
-        i = readpointer + 1;
-        if (i == BP_TERMINAL_BUFFER_SIZE) i = 0; //check for wrap
-        if (i == writepointer) return; //buffer empty,
+    //back to the default interrupt mode for UART1TXInt
+    ringDrain = 0;
+    U1STAbits.UTXISEL1 = 0;
+    U1STAbits.UTXISEL0 = 0;
+}
 
-        if (U1STAbits.UTXBF == 0) {//free slot, move a byte to UART
-            readpointer = i;
-            U1TXREG = bus_pirate_configuration.terminal_input[readpointer];
-        }
-    }
+unsigned int UARTbufFree(void) {
+    unsigned int r = readpointer;
+
+    //one slot always stays unused, it tells a full buffer from an empty one
+    if (r >= writepointer) return r - writepointer;
+    return (BP_TERMINAL_BUFFER_SIZE - writepointer) + r;
+}
+
+void UARTbufStats(unsigned int *high_water, unsigned int *overflows) {
+    *high_water = ringHighWater;
+    *overflows = ringOverflows;
 }
 
 void UARTbuf(char c) {
+    unsigned int used;
+    unsigned int n;
+
     if (writepointer == readpointer) {
         BP_LEDMODE = 0; //drop byte, buffer full LED off
         bus_pirate_configuration.overflow = 1;
+        if (ringOverflows != 0xFFFF) ringOverflows++;
+        PERF_RING_OVERFLOW();
     } else {
+        n = writepointer + 1;
+        if (n == BP_TERMINAL_BUFFER_SIZE) n = 0; //check for wrap
         bus_pirate_configuration.terminal_input[writepointer] = c;
-        writepointer++;
-        if (writepointer == BP_TERMINAL_BUFFER_SIZE) writepointer = 0; //check for wrap
+        writepointer = n; //one store, the TX interrupt never sees a half-wrapped index
+
+        used = (BP_TERMINAL_BUFFER_SIZE - 1) - UARTbufFree();
+        if (used > ringHighWater) {
+            ringHighWater = used;
+            PERF_RING_LEVEL(used);
+        }
+        PERF_COUNT_OUT();
     }
+
+    if (IEC0bits.U1TXIE == 0) UARTbufKick();
 }
 
 //get a byte from UART
 
 unsigned char UART1RX(void) {
-    while (U1STAbits.URXDA == 0);
+    if (U1STAbits.URXDA == 0) {
+        PERF_WAIT_BEGIN();
+        while (U1STAbits.URXDA == 0);
+        PERF_WAIT_END();
+    }
+    PERF_COUNT_IN();
     return U1RXREG;
 }
 
@@ -374,6 +468,7 @@ void WAITTXEmpty(void) {
 
 void UART1TX(char c) {
     if (bus_pirate_configuration.quiet) return;
+    PERF_COUNT_OUT();
     while (U1STAbits.UTXBF == 1); //if buffer is full, wait
     U1TXREG = c;
 }
@@ -428,6 +523,12 @@ void __attribute__((interrupt, no_auto_psv)) _U1RXInterrupt(void) {
 }
 
 void __attribute__((interrupt, no_auto_psv)) _U1TXInterrupt(void) {
+    if (ringDrain) {
+        IFS0bits.U1TXIF = 0; //cleared first, the FIFO running empty again sets it
+        UARTbufDrain();
+        return;
+    }
+
     UART1TXSent++;
     if (UART1TXSent == UART1TXAvailable) {
         // if everything is sent  disale interrupts
@@ -448,6 +549,7 @@ extern BDentry *CDC_Outbdp, *CDC_Inbdp;
 
 void UART1TX(char c) {
     if (bus_pirate_configuration.quiet) return;
+    PERF_COUNT_OUT();
     putc_cdc(c);
 }
 
@@ -474,7 +576,20 @@ unsigned char UART1RXRdy(void) {
 //get a byte from UART
 
 unsigned char UART1RX(void) {
-    return getc_cdc();
+    unsigned char c;
+
+    if (UART1RXRdy() == 0) {
+        //the host has to hear the end of the last command before it sends
+        //the next one, don't leave it to the SOF timeout
+        CDC_Flush_In_Now();
+        PERF_WAIT_BEGIN();
+        c = getc_cdc();
+        PERF_WAIT_END();
+    } else {
+        c = getc_cdc();
+    }
+    PERF_COUNT_IN();
+    return c;
 }
 
 void UARTbufFlush(void) {
@@ -491,6 +606,15 @@ void UARTbufSetup(void) {
 void UARTbufService(void) {
 }
 
+unsigned int UARTbufFree(void) {
+    return BP_TERMINAL_BUFFER_SIZE; //UARTbuf waits for the USB host, never drops
+}
+
+void UARTbufStats(unsigned int *high_water, unsigned int *overflows) {
+    *high_water = 0;
+    *overflows = 0;
+}
+
 void ClearCommsError(void) {
 }
 
@@ -574,21 +698,40 @@ void UARTbufFlush(void) {
     }
 }
 
+unsigned int UARTbufFree(void) {
+    //one slot always stays unused, it tells a full buffer from an empty one
+    if (readpointer >= writepointer) return readpointer - writepointer;
+    return (BP_TERMINAL_BUFFER_SIZE - writepointer) + readpointer;
+}
+
+void UARTbufStats(unsigned int *high_water, unsigned int *overflows) {
+    *high_water = 0; //not tracked on the debug UART
+    *overflows = 0;
+}
+
 void UARTbuf(char c) {
+    unsigned int n;
+
     if (writepointer == readpointer) {
         BP_LEDMODE = 0; //drop byte, buffer full LED off
         bus_pirate_configuration.overflow = 1;
     } else {
+        n = writepointer + 1;
+        if (n == BP_TERMINAL_BUFFER_SIZE) n = 0; //check for wrap
         bus_pirate_configuration.terminal_input[writepointer] = c;
-        writepointer++;
-        if (writepointer == BP_TERMINAL_BUFFER_SIZE) writepointer = 0; //check for wrap
+        writepointer = n;
     }
 }
 
 //get a byte from UART
 
 unsigned char UART1RX(void) {
-    while (U1STAbits.URXDA == 0);
+    if (U1STAbits.URXDA == 0) {
+        PERF_WAIT_BEGIN();
+        while (U1STAbits.URXDA == 0);
+        PERF_WAIT_END();
+    }
+    PERF_COUNT_IN();
     return U1RXREG;
 }
 
@@ -600,6 +743,7 @@ void WAITTXEmpty(void) {
 
 void UART1TX(char c) {
     if (bus_pirate_configuration.quiet) return;
+    PERF_COUNT_OUT();
     while (U1STAbits.UTXBF == 1); //if buffer is full, wait
     U1TXREG = c;
 }
@@ -50,6 +50,14 @@ void bpEchoState(unsigned int c);
  */
 void bp_write_buffer(const uint8_t *buffer, size_t length);
 
+/**
+ * Waits for length bytes from the serial port and stores them in buffer.
+ *
+ * @param[out] buffer the buffer to fill.
+ * @param[in] length how many bytes to read.
+ */
+void bp_read_buffer(uint8_t *buffer, size_t length);
+
 /**
  * Writes the given NULL-terminated string to the serial port.
  *
@@ -138,6 +146,9 @@ void UARTbufService(void);
 void UARTbufFlush(void);
 void UARTbufSetup(void);
 void UARTbuf(char c);
+unsigned int UARTbufFree(void); //bytes UARTbuf can take before dropping
+void UARTbufStats(unsigned int *high_water, unsigned int *overflows); //peak fill and dropped bytes since UARTbufSetup
+void UARTbufReport(void); //print UARTbufStats in the terminal
 void bpWhexBuf(unsigned int c); //write a hex value to ring buffer
 
 
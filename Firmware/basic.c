@@ -42,6 +42,21 @@ int fors;						// current for
 int gosubs;						// current gosubs
 int datapos;					// read pointer.
 
+// while a program runs, lineindex holds the pgmspace offset of every line
+// in line number order and jumpcache the last target found for each
+// line number modulo JUMPCACHESIZE, so a jump in a loop costs a lookup
+// instead of a walk over the program
+unsigned int lineindex[LINEINDEXMAX];
+int lineindexlen=-1;				// -1 if there is no index
+struct jumptarget jumpcache[JUMPCACHESIZE];
+
+// for each letter the first token starting with it, and for each token the
+// next one starting with the same letter, so gettoken() only compares the
+// statements that can match
+unsigned char tokenfirst[26];
+unsigned char tokennext[NUMTOKEN];
+int tokenchains=0;
+
 
 char *tokens[NUMTOKEN+1]=
 {	STAT_LET,		//0x80
@@ -336,10 +351,67 @@ void handleelse(void)
 	}
 }
 
+// index the program lines, unless there are too many or they are out of
+// order (a program loaded from somewhere else), in which case searchlineno()
+// keeps walking pgmspace and still finds the first match
+
+void buildlineindex(void)
+{	int i, n;
+	unsigned int lineno, last;
+
+	for(i=0; i<JUMPCACHESIZE; i++)
+	{	jumpcache[i].pos=-1;
+	}
+	lineindexlen=-1;
+
+	i=0;
+	n=0;
+	last=0;
+	while((i<PGMSIZE)&&(pgmspace[i]>TOK_LEN))
+	{	lineno=(pgmspace[i+1]<<8)+pgmspace[i+2];
+		if((n==LINEINDEXMAX)||((n>0)&&(lineno<=last)))
+		{	return;
+		}
+		lineindex[n++]=i;
+		last=lineno;
+		i+=(pgmspace[i]-TOK_LEN)+3;
+	}
+	lineindexlen=n;
+}
+
 int searchlineno(unsigned int line)
 {	int i;
 	int len;
 	int lineno;
+	int low, high, mid;
+	struct jumptarget *cached;
+
+	if(lineindexlen>=0)
+	{	cached=&jumpcache[line&(JUMPCACHESIZE-1)];
+		if((cached->pos>=0)&&(cached->line==line))
+		{	return cached->pos;
+		}
+
+		low=0;
+		high=lineindexlen-1;
+		while(low<=high)
+		{	mid=(low+high)>>1;
+			i=lineindex[mid];
+			lineno=(pgmspace[i+1]<<8)+pgmspace[i+2];
+			if((unsigned int)lineno==line)
+			{	cached->line=line;
+				cached->pos=i;
+				return i;
+			}
+			if((unsigned int)lineno<line)
+			{	low=mid+1;
+			}
+			else
+			{	high=mid-1;
+			}
+		}
+		return -1;
+	}
 
 	i=0;
 
@@ -584,6 +656,8 @@ void interpreter(void)
 
 	for(i=0; i<26; i++) vars[i]=0;
 
+	buildlineindex();
+
 	while(!stop)
 	{	if(!ifstat)
 		{	if(pgmspace[pc]<TOK_LEN)
@@ -1119,6 +1193,7 @@ void interpreter(void)
 	}
 
 	bus_pirate_configuration.quiet=0; 		// display on 
+	lineindexlen=-1;						// the program may be edited now
 
 	if(stop!=NOERROR)
 	{	//bpWstring("Error(");
@@ -1195,8 +1270,26 @@ int compare(char *p)
 
 unsigned char gettoken(void)
 {	int i;
+	unsigned char c;
 
-	for(i=0; i<NUMTOKEN; i++)
+	if(!tokenchains)
+	{	for(i=0; i<26; i++)
+		{	tokenfirst[i]=0xFF;
+		}
+		for(i=NUMTOKEN-1; i>=0; i--)		// chains keep the tokens[] order
+		{	c=tokens[i][0]-'A';
+			tokennext[i]=tokenfirst[c];
+			tokenfirst[c]=i;
+		}
+		tokenchains=1;
+	}
+
+	c=cmdbuf[cmdstart];
+	if((c<'A')||(c>'Z'))
+	{	return 0;
+	}
+
+	for(i=tokenfirst[c-'A']; i!=0xFF; i=tokennext[i])
 	{	if(compare(tokens[i]))
 		{	return TOKENS+i;
 		}
@@ -1339,6 +1432,11 @@ void basiccmdline(void)
 
 		temp=(line[0]-TOK_LEN)+3;
 
+		if((end+temp)>=PGMSIZE)					// no room left, moving would run past pgmspace
+		{	BPMSG1051;
+			return;
+		}
+
 		//for(i=end+temp; i>=pos; i--)
 		for(i=end; i>=pos; i--)
 		{	pgmspace[i+temp]=pgmspace[i];		// move every thing from pos temp 
@@ -1411,7 +1509,7 @@ void bp_clear_basic_program_area(void)
 
 #define BASSDA		1
 #define BASSCL		2
-#define BASI2CCLK	100
+#define BASI2CCLK	5		// us per clock phase, 100kHz standard mode
 
 #define EEP24LC256
 
@@ -1420,9 +1518,14 @@ void bp_clear_basic_program_area(void)
 #define I2CADDR		0xA0
 #define EEPROMSIZE	0x8000
 #define EEPROMPAGE	64
+#define EEPROMPOLLS	50		// ACK polls of >200us each, write cycle (tWC) is 5ms max
 
 #endif
 
+// the first PGMSIZE bytes hold a CRC16 per slot (slot n at 2*n, MSB first),
+// the programs are in slots 1 and up, PGMSIZE bytes each
+#define CRCADDR(slot)	((slot)*2)
+
 //globals
 int eeprom_lastprog;
 unsigned int eeprom_lastmem;
@@ -1504,6 +1607,7 @@ int basi2cwrite(unsigned char c)
 		mask>>=1;
 	}
 
+	HIZbbH(BASSDA, BASI2CCLK/5);				// release data, else a 0 in bit 0 reads as ACK
 	HIZbbH(BASSCL, BASI2CCLK);
 	i=HIZbbR(BASSDA);
 	HIZbbL(BASSCL, BASI2CCLK);
@@ -1557,25 +1661,59 @@ void format(void)
 		}
 		basi2cstop();
 		UART1TX('.');
-		waiteeprom();
+		if(!waiteeprom())
+		{	return;
+		}
 	}
 	//bpWline("done");
 	BPMSG1055;
 }
 
-void waiteeprom(void)
-{	int wait;
-	wait=1;
-	while(wait)
+// ACK polling, returns 0 if the write cycle does not end in time
+
+int waiteeprom(void)
+{	int i, ready;
+
+	for(i=0; i<EEPROMPOLLS; i++)
 	{	basi2cstart();
-		wait=basi2cwrite(I2CADDR);
+		ready=basi2cwrite(I2CADDR);			// busy with a write cycle while it NACKs
 		basi2cstop();
+		if(ready)
+		{	return 1;
+		}
+		bp_delay_us(100);
 	}
+	bpBR;
+	//bpWline("EEPROM write timeout");
+	BPMSG1286;
+	return 0;
+}
+
+// CRC-16/CCITT (polynomial 0x1021, start 0xFFFF) of the program area
+
+unsigned int basiccrc(void)
+{	int i,j;
+	unsigned int crc;
+
+	crc=0xFFFF;
+	for(i=0; i<PGMSIZE; i++)
+	{	crc^=(pgmspace[i]<<8);
+		for(j=0; j<8; j++)
+		{	if(crc&0x8000)
+			{	crc=(crc<<1)^0x1021;
+			}
+			else
+			{	crc<<=1;
+			}
+		}
+	}
+	return crc&0xFFFF;						// int is wider than 16 bits off the PIC
 }
 
 void save(void)
 {	int i,j;
 	int slot;
+	unsigned int addr, crc;
 
 	consumewhitechars();
 	slot=getint();
@@ -1591,7 +1729,7 @@ void save(void)
 	bpWdec(slot);
 	bpBR;
 
-	if(slot>(EEPROMSIZE/PGMSIZE))
+	if(slot>=(EEPROMSIZE/PGMSIZE))
 	{	//bpWline("Invalid slot");
 		BPMSG1057;
 		return;
@@ -1601,34 +1739,38 @@ void save(void)
 	{	return;
 	}
 
-	slot*=PGMSIZE;
-
-	basi2cstop();
-	basi2cwrite(I2CADDR);
-	basi2cwrite(slot>>8);
-	basi2cwrite(slot&0x0FF);
-	basi2cstart();
-	basi2cwrite(I2CADDR+1);
-
-	slot*=EEPROMPAGE; 
+	addr=slot*PGMSIZE;
 
 	for(i=0; i<PGMSIZE; i+=EEPROMPAGE)		// we assume that pgmsize is dividable by eeprompage
 	{	basi2cstart();
 		basi2cwrite(I2CADDR);
-		basi2cwrite((slot+i)>>8);
-		basi2cwrite((slot+i)&0x0FF);
+		basi2cwrite((addr+i)>>8);
+		basi2cwrite((addr+i)&0x0FF);
 		for(j=0; j<EEPROMPAGE; j++)
 		{	basi2cwrite(pgmspace[i+j]);
 		}
 		basi2cstop();
 		UART1TX('.');
-		waiteeprom();
+		if(!waiteeprom())					// ACK polling, the page is written
+		{	return;
+		}
 	}
+
+	crc=basiccrc();
+	basi2cstart();
+	basi2cwrite(I2CADDR);
+	basi2cwrite(CRCADDR(slot)>>8);
+	basi2cwrite(CRCADDR(slot)&0x0FF);
+	basi2cwrite(crc>>8);
+	basi2cwrite(crc&0x0FF);
+	basi2cstop();
+	waiteeprom();
 }
 
 void load(void)
 {	int i;
 	int slot;
+	unsigned int addr, crc;
 
 	consumewhitechars();
 	slot=getint();
@@ -1644,7 +1786,7 @@ void load(void)
 	bpWdec(slot);
 	bpBR;
 
-	if(slot>(EEPROMSIZE/PGMSIZE))
+	if(slot>=(EEPROMSIZE/PGMSIZE))
 	{	//bpWline("Invalid slot");
 		BPMSG1057;
 		return;
@@ -1654,18 +1796,35 @@ void load(void)
 	{	return;
 	}
 
-	slot*=PGMSIZE;
-
+	basi2cstart();							// stored CRC
+	basi2cwrite(I2CADDR);
+	basi2cwrite(CRCADDR(slot)>>8);
+	basi2cwrite(CRCADDR(slot)&0x0FF);
+	basi2cstart();
+	basi2cwrite(I2CADDR+1);
+	crc=basi2cread(1)<<8;
+	crc|=basi2cread(0);
 	basi2cstop();
+
+	addr=slot*PGMSIZE;
+
+	basi2cstart();							// whole program in one sequential read
 	basi2cwrite(I2CADDR);
-	basi2cwrite(slot>>8);
-	basi2cwrite(slot&0x0FF);
+	basi2cwrite(addr>>8);
+	basi2cwrite(addr&0x0FF);
 	basi2cstart();
 	basi2cwrite(I2CADDR+1);
 
 	for(i=0; i<PGMSIZE; i++)
 	{	if(!(i%EEPROMPAGE))	UART1TX('.');		// pure estetic
-		pgmspace[i]=basi2cread(1);
+		pgmspace[i]=basi2cread(i<(PGMSIZE-1));	// NACK the last byte
+	}
+	basi2cstop();
+
+	if(basiccrc()!=crc)
+	{	bpBR;
+		bp_write_line("Checksum error");
+		bp_clear_basic_program_area();
 	}
 }
 
@@ -105,6 +105,8 @@
 #define PGMSIZE		1024
 #define FORMAX		4
 #define GOSUBMAX	10
+#define LINEINDEXMAX	128		// longer programs search the line numbers from the start
+#define JUMPCACHESIZE	8		// must be a power of two
 
 // errors
 #define NOERROR		1
@@ -129,10 +131,16 @@ struct token
 	unsigned char tok;
 };
 
+struct jumptarget
+{	unsigned int line;
+	int pos;
+};
+
 // functions
 void list(void);
 void interpreter(void);
 void handleelse(void);
+void buildlineindex(void);
 int searchlineno(unsigned int line);
 int getnumvar(void);
 int getmultdiv(void);
@@ -148,7 +156,7 @@ void directory(void);
 void save(void);
 void format(void);
 void load(void);
-void waiteeprom(void);
+int waiteeprom(void);
 
 #endif /* BP_ENABLE_BASIC_SUPPORT */
 
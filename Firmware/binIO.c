@@ -50,6 +50,7 @@
 #include "AUXpin.h"
 #include "binIO.h"
 #include "binwire.h"
+#include "perf_counters.h"
 
 extern mode_configuration_t mode_configuration;
 
@@ -96,8 +97,18 @@ Commands:
 00010110 // ADC Stop
 00011000 // XSVF Player
 // End added JM
+00011001 // read performance counters
+00011010 // clear performance counters
 //
 010xxxxx //set input(1)/output(0) pin state (returns pin read)
+
+Performance counters reply, values MSB first, times in 0.5us ticks:
+length of what follows (1), version=1 (1), modes=7 (1), handlers=5 (1),
+clock (4),
+bytes in (4) and out (4) for terminal, BBIO, SPI, I2C, UART, 1-Wire, raw wire,
+ticks waiting for the host (4), UARTbuf bytes dropped (2), UARTbuf peak (2),
+runs (4), ticks (4) and longest run (4) for SPI bulk, SPI write-then-read,
+I2C bulk, I2C write-then-read, raw wire bulk.
  */
 void binBBversion(void) { bp_write_string("BBIO1"); }
 
@@ -106,6 +117,7 @@ void binBB(void) {
   unsigned int i;
 
   BP_LEDMODE = 1; // light MODE LED
+  PERF_SET_MODE(PERF_MODE_BBIO);
   binReset();
   binBBversion(); // send mode name and version
 
@@ -119,34 +131,44 @@ void binBB(void) {
       } else if (inByte == 1) { // goto SPI mode
         binReset();
 #ifdef BP_ENABLE_SPI_SUPPORT
+        PERF_SET_MODE(PERF_MODE_SPI);
         binSPI(); // go into rawSPI loop
+        PERF_SET_MODE(PERF_MODE_BBIO);
 #endif            /* BP_ENABLE_SPI_SUPPORT */
         binReset();
         binBBversion();         // say name on return
       } else if (inByte == 2) { // goto I2C mode
         binReset();
 #ifdef BP_ENABLE_I2C_SUPPORT
+        PERF_SET_MODE(PERF_MODE_I2C);
         binI2C();
+        PERF_SET_MODE(PERF_MODE_BBIO);
 #endif /* BP_ENABLE_I2C_SUPPORT */
         binReset();
         binBBversion();         // say name on return
       } else if (inByte == 3) { // goto UART mode
         binReset();
 #ifdef BP_ENABLE_UART_SUPPORT
+        PERF_SET_MODE(PERF_MODE_UART);
         binUART();
+        PERF_SET_MODE(PERF_MODE_BBIO);
 #endif
         binReset();
         binBBversion();         // say name on return
       } else if (inByte == 4) { // goto 1WIRE mode
         binReset();
 #ifdef BP_ENABLE_1WIRE_SUPPORT
+        PERF_SET_MODE(PERF_MODE_1WIRE);
         binary_io_enter_1wire_mode();
+        PERF_SET_MODE(PERF_MODE_BBIO);
 #endif /* BP_ENABLE_1WIRE_SUPPORT */
         binReset();
         binBBversion();         // say name on return
       } else if (inByte == 5) { // goto RAW WIRE mode
         binReset();
+        PERF_SET_MODE(PERF_MODE_RAW_WIRE);
         binwire();
+        PERF_SET_MODE(PERF_MODE_BBIO);
         binReset();
         binBBversion();         // say name on return
       } else if (inByte == 6) { // goto OpenOCD mode
@@ -172,6 +194,7 @@ void binBB(void) {
 #endif
 #ifdef BUSPIRATEV4 // cannot use ASM reset on BPv4
         binReset();
+        PERF_SET_MODE(PERF_MODE_TERMINAL);
         return;
 #endif
         // self test is only for v2go and v3
@@ -251,6 +274,13 @@ void binBB(void) {
         jtag();
 #endif
         //--- End added JM
+#ifdef BP_ENABLE_PERF_COUNTERS
+      } else if (inByte == 0b11001) { // read performance counters
+        perf_counters_send();
+      } else if (inByte == 0b11010) { // clear performance counters
+        perf_counters_reset();
+        UART1TX(1);
+#endif /* BP_ENABLE_PERF_COUNTERS */
       } else if ((inByte >> 5) & 0b010) { // set pin direction, return read
         UART1TX(binBBpindirectionset(inByte));
       } else { // unknown command, error
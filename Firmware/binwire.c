@@ -2,6 +2,7 @@
 #include "bitbang.h"
 #include "bus_pirate_core.h"
 #include "binIOhelpers.h"
+#include "perf_counters.h"
 #ifdef BUSPIRATEV4
 #include "smps.h"
 #endif
@@ -20,6 +21,18 @@ void PIC424Write_internal(unsigned long cmd, unsigned char pn);
 void PIC424Write(unsigned char *cmd, unsigned char pn);
 void PIC424Read(void);
 
+unsigned char PICBlockWrite(unsigned char picMode);
+unsigned char PIC424BlockRead(void);
+static void PIC424ReadRaw(unsigned char *c);
+static unsigned int PIC424ReadVISI(void);
+static void PIC424MovLiteral(unsigned int literal, unsigned char reg);
+
+//how many times the PIC24 NVMCON WR bit is polled after a row write
+#define PIC24_WRITE_POLLS 1000
+
+//PIC24 instruction pairs read per bp_write_buffer call by the block read
+#define PIC24_READ_CHUNK 8
+
 #define R3WMOSI_TRIS 	BP_MOSI_DIR
 #define R3WCLK_TRIS 	BP_CLK_DIR
 #define R3WMISO_TRIS 	BP_MISO_DIR
@@ -51,8 +64,10 @@ void PIC424Read(void);
  * 0011xxxx - Bulk bits, send 1-8 bits of the next byte (0=1bit!)
  * 0100wxyz � Configure peripherals, w=power, x=pullups, y=AUX, z=CS
  * 0101xxxx - Bulk read, read 1-16bytes (0=1byte!)
- * 0110000x � Set speed
+ * 01100xxx � Set speed, 0=~5KHz 1=~50KHz 2=~100KHz 3=~150KHz 4=~1.6MHz (normal outputs only, 0x00 in HiZ)
  * 1000wxyz � Config, w=output type, x=3wire, y=lsb, z=n/a
+ * 10100110 - PIC block write, program a row in the current PIC mode, see PICBlockWrite
+ * 10101000 - PIC24 block read, read instruction pairs from an address, see PIC424BlockRead
  ****************** BPv4 Specific Instructions *********************
  * 11110000 - Return SMPS output voltage
  * 11110001 - Stop SMPS operation
@@ -176,8 +191,18 @@ void binwire(void) {
                 inByte++; //increment by 1, 0=1byte
                 UART1TX(1); //send 1/OK
 
+                PERF_BEGIN(PERF_HANDLER_RAW_BULK);
                 for (i = 0; i < inByte; i++) {
                     c = UART1RX(); // /* JTR usb port; */;
+                    if (mode_configuration.speed == BB_SPEED_FAST) {//bit order handled by the shift loop
+                        unsigned int mode = mode_configuration.numbits;
+
+                        if (mode_configuration.lsbEN == 1) mode |= BB_SHIFT_LSB_FIRST;
+                        if (wires == 3) mode |= BB_SHIFT_READ_MISO;
+                        c = bbShiftFast(c, mode);
+                        UART1TX((wires == 2) ? 1 : c);
+                        continue;
+                    }
                     if (mode_configuration.lsbEN == 1) {//adjust bitorder
                         c = bp_reverse_integer(c);
                     }
@@ -192,6 +217,7 @@ void binwire(void) {
                         UART1TX(c);
                     }
                 }
+                PERF_END(PERF_HANDLER_RAW_BULK);
 
                 break;
 
@@ -382,6 +408,16 @@ void binwire(void) {
                         if (cmdr == 0)
                             UART1TX(1); // ACK
 
+                        break;
+                    case 0b10100110: // block write, one status for the whole row
+                        UART1TX(PICBlockWrite(picMode));
+                        break;
+                    case 0b10101000: // PIC24 block read
+                        if (picMode != PIC424) {
+                            UART1TX(0);
+                            break;
+                        }
+                        PIC424BlockRead();
                         break;
                     default:
                         UART1TX(0x00); //send 0/Error
@@ -404,7 +440,11 @@ void binwire(void) {
 #endif
 
             case 0b0110://set speed
-                inByte &= (~0b11111100); //clear command portion
+                inByte &= (~0b11111000); //clear command portion
+                if ((inByte == BB_SPEED_FAST) && (mode_configuration.high_impedance == 1)) {//open drain is too slow for it
+                    UART1TX(0);
+                    break;
+                }
                 mode_configuration.speed = inByte;
                 bbSetup(wires, mode_configuration.speed);
                 bbCS(1); //takes care of custom HiZ settings too
@@ -593,8 +633,188 @@ void PIC424Write_internal(unsigned long cmd, unsigned char pn) {
 }
 
 void PIC424Read(void) {
-    unsigned char c;
+    unsigned char c[2];
 
+    //return bytes in little endian format
+    PIC424ReadRaw(c);
+    UART1TX(c[0]);
+    UART1TX(c[1]);
+}
+
+/*
+ * Block write, programs a whole row with one host command and one status
+ * byte. The payload depends on the PIC mode set with 0b10100000, data bytes
+ * are in the same format the 0b10100100 write command takes:
+ *
+ * PIC424: NVMCON (2 bytes, MSB first), destination address (3 bytes, MSB
+ *         first), number of 4 instruction groups g, then g*12 bytes: the
+ *         W0-W5 words (LSW0, MSB1:MSB0, LSW1, LSW2, MSB3:MSB2, LSW3), each
+ *         LSB first. Runs the PIC24F ICSP row write: NVMCON and TBLPAG setup,
+ *         write latches loaded with TBLWTL/TBLWTH, WR set and polled until the
+ *         write is done. 16 groups make a 64 instruction row.
+ * PIC416: programming delay in ms (1-3), number of words n, then n*2 bytes.
+ *         Each word but the last goes out with the "table write, post
+ *         increment by 2" command (0b1101), the last one with "table write,
+ *         start programming" (0b1111), followed by the NOP that holds the
+ *         clock high for the programming delay. TBLPTR must be set up first.
+ * PIC614: programming delay in ms, number of words n, then n*2 bytes. Each
+ *         word is loaded with "load data for program memory" (0x02) and the
+ *         address incremented (0x06) in between, then "begin programming"
+ *         (0x08), the delay, and a final increment to the next row.
+ *
+ * Returns 1 once the row is written, 0 for an unknown mode, an empty row or a
+ * PIC24 write that never completed.
+ */
+unsigned char PICBlockWrite(unsigned char picMode) {
+    unsigned char *data = bus_pirate_configuration.terminal_input;
+    unsigned char header[6], delay;
+    unsigned int i, n, polls;
+
+    switch (picMode) {
+        case PIC424:
+            bp_read_buffer(header, 6);
+            n = header[5];
+            if (n == 0) {
+                return 0;
+            }
+            bp_read_buffer(data, n * 12);
+
+            //exit the reset vector
+            PIC24NOP();
+            PIC424Write_internal(0x040200, 1); //GOTO 0x200
+
+            //NVMCON for a row write
+            PIC424MovLiteral((header[0] << 8) | header[1], 10); //MOV #nvmcon, W10
+            PIC424Write_internal(0x883B0A, 0); //MOV W10, NVMCON
+
+            //write pointer
+            PIC424MovLiteral(header[2], 0); //MOV #addr23:16, W0
+            PIC424Write_internal(0x880190, 0); //MOV W0, TBLPAG
+            PIC424MovLiteral((header[3] << 8) | header[4], 7); //MOV #addr15:0, W7
+
+            for (i = 0; i < n * 12; i += 12) {
+                //W0-W5 hold the next 4 instructions, packed
+                for (polls = 0; polls < 6; polls++) {
+                    PIC424MovLiteral(data[i + polls * 2] | (data[i + polls * 2 + 1] << 8), polls);
+                }
+
+                //load the write latches
+                PIC424Write_internal(0xEB0300, 1); //CLR W6
+                PIC424Write_internal(0xBB0BB6, 2); //TBLWTL [W6++], [W7]
+                PIC424Write_internal(0xBBDBB6, 2); //TBLWTH.B [W6++], [W7++]
+                PIC424Write_internal(0xBBEBB6, 2); //TBLWTH.B [W6++], [++W7]
+                PIC424Write_internal(0xBB1BB6, 2); //TBLWTL [W6++], [W7++]
+                PIC424Write_internal(0xBB0BB6, 2); //TBLWTL [W6++], [W7]
+                PIC424Write_internal(0xBBDBB6, 2); //TBLWTH.B [W6++], [W7++]
+                PIC424Write_internal(0xBBEBB6, 2); //TBLWTH.B [W6++], [++W7]
+                PIC424Write_internal(0xBB1BB6, 2); //TBLWTL [W6++], [W7++]
+            }
+
+            //start the write and wait for WR to clear
+            PIC424Write_internal(0xA8E761, 2); //BSET NVMCON, #WR
+            for (polls = 0; polls < PIC24_WRITE_POLLS; polls++) {
+                PIC424Write_internal(0x040200, 1); //GOTO 0x200
+                PIC424Write_internal(0x803B02, 0); //MOV NVMCON, W2
+                PIC424Write_internal(0x883C22, 1); //MOV W2, VISI
+                if ((PIC424ReadVISI() & 0x8000) == 0) {
+                    break;
+                }
+            }
+
+            //reset the device internal PC
+            PIC424Write_internal(0x040200, 1); //GOTO 0x200
+
+            return (polls < PIC24_WRITE_POLLS) ? 1 : 0;
+
+        case PIC416:
+        case PIC614:
+            bp_read_buffer(header, 2);
+            delay = header[0];
+            n = header[1];
+            if (n == 0) {
+                return 0;
+            }
+            bp_read_buffer(data, n * 2);
+
+            for (i = 0; i < n * 2; i += 2) {
+                if (picMode == PIC416) {
+                    //table write post increment, or start programming on the last word
+                    PIC416Write((i + 2 < n * 2) ? 0x0D : 0x0F, data[i], data[i + 1]);
+                } else {
+                    PIC614Write(0x02, data[i], data[i + 1]); //load data for program memory
+                    if (i + 2 < n * 2) {
+                        PIC614Write(0x86, 0, 0); //increment address, no data
+                    }
+                }
+            }
+
+            if (picMode == PIC416) {
+                PIC416Write((delay & 0x03) << 6, 0, 0); //NOP, clock held high for the delay
+            } else {
+                PIC614Write(0x88, 0, 0); //begin programming, no data
+                bp_delay_ms(delay);
+                PIC614Write(0x86, 0, 0); //increment address to the next row
+            }
+            return 1;
+
+        default:
+            return 0;
+    }
+}
+
+/*
+ * PIC24 block read, reads instruction pairs in the packed format of the
+ * 0b10100101 read command: LSW0, MSB1:MSB0, LSW1, each word as PIC424Read
+ * sends it.
+ *
+ * Host sends the source address (3 bytes, MSB first) and the number of pairs
+ * n (0 means 256). The board replies 1, then n*6 bytes. TBLPAG, W6 and W7
+ * (pointing to VISI) are set up on the board, so no other command is needed
+ * first.
+ */
+unsigned char PIC424BlockRead(void) {
+    unsigned char header[4], buffer[PIC24_READ_CHUNK * 6];
+    unsigned int pairs, i;
+
+    bp_read_buffer(header, 4);
+    pairs = header[3] ? header[3] : 256;
+    UART1TX(1);
+
+    //exit the reset vector
+    PIC24NOP();
+    PIC424Write_internal(0x040200, 1); //GOTO 0x200
+
+    //read pointer and VISI
+    PIC424MovLiteral(header[0], 0); //MOV #addr23:16, W0
+    PIC424Write_internal(0x880190, 0); //MOV W0, TBLPAG
+    PIC424MovLiteral((header[1] << 8) | header[2], 6); //MOV #addr15:0, W6
+    PIC424Write_internal(0x207847, 1); //MOV #VISI, W7
+
+    i = 0;
+    while (pairs--) {
+        PIC424Write_internal(0xBA0B96, 2); //TBLRDL [W6], [W7]
+        PIC424ReadRaw(&buffer[i]);
+        PIC424Write_internal(0xBADBB6, 2); //TBLRDH.B [W6++], [W7++]
+        PIC424Write_internal(0xBAD3D6, 2); //TBLRDH.B [++W6], [W7--]
+        PIC424ReadRaw(&buffer[i + 2]);
+        PIC424Write_internal(0xBA0BB6, 2); //TBLRDL [W6++], [W7]
+        PIC424ReadRaw(&buffer[i + 4]);
+
+        i += 6;
+        if ((i == sizeof(buffer)) || (pairs == 0)) {
+            bp_write_buffer(buffer, i);
+            i = 0;
+        }
+    }
+
+    //reset the device internal PC
+    PIC424Write_internal(0x040200, 1); //GOTO 0x200
+
+    return 1;
+}
+
+//REGOUT, stores VISI in the two bytes PIC424Read sends
+static void PIC424ReadRaw(unsigned char *c) {
     //send four bit REGOUT command (read)
     bbWriteBit(1); //send bit
     bbWriteBit(0); //send bit
@@ -604,13 +824,24 @@ void PIC424Read(void) {
     //one byte output
     bbWriteByte(0x00); //send byte
 
-    //read 2 bytes
-    //return bytes in little endian format
-    c = bbReadByte();
-    UART1TX(bbReadByte());
-    UART1TX(c);
+    //read 2 bytes, little endian
+    c[1] = bbReadByte();
+    c[0] = bbReadByte();
 
     //ALWAYS POST nop TWICE after a read
     PIC24NOP();
     PIC24NOP();
 }
+
+//REGOUT, returns the VISI value (shifted LSB first, read MSB first)
+static unsigned int PIC424ReadVISI(void) {
+    unsigned char c[2];
+
+    PIC424ReadRaw(c);
+    return (bp_reverse_integer(c[0]) << 8) | bp_reverse_integer(c[1]);
+}
+
+//SIX MOV #literal, Wreg
+static void PIC424MovLiteral(unsigned int literal, unsigned char reg) {
+    PIC424Write_internal(0x200000 | ((unsigned long) literal << 4) | reg, 0);
+}
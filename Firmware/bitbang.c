@@ -34,10 +34,13 @@
 #define	BB_100KHZSPEED_CLOCK 5
 #define	BB_100KHZSPEED_HALFCLOCK 2
 
-#define	BB_MAXSPEED_SETTLE 0 //~400KHz
+#define	BB_MAXSPEED_SETTLE 0 //~150KHz, calls only
 #define	BB_MAXSPEED_CLOCK 0
 #define	BB_MAXSPEED_HALFCLOCK 0
 
+//BB_SPEED_FAST (~1.6MHz) uses the same zero delays for the bit functions,
+//bytes go through bbShiftFast. Clock rates per speed are in bitbang_asm.s
+
 extern mode_configuration_t mode_configuration;
 
 struct _bitbang{
@@ -47,6 +50,7 @@ struct _bitbang{
 	unsigned char delaySettle;
 	unsigned char delayClock;
 	unsigned char delayHalfClock;
+	unsigned char fast;
 } bitbang;
 
 void bbSetup(unsigned char pins, unsigned char speed){
@@ -65,6 +69,7 @@ void bbSetup(unsigned char pins, unsigned char speed){
 	
 	//define delays for differnt speeds
 	// I2C Bus timing in uS
+	bitbang.fast=0;
 	switch(speed){
 		case 0:
 			bitbang.delaySettle = BB_5KHZSPEED_SETTLE;
@@ -81,6 +86,14 @@ void bbSetup(unsigned char pins, unsigned char speed){
 			bitbang.delayClock = BB_100KHZSPEED_CLOCK;
 			bitbang.delayHalfClock = BB_100KHZSPEED_HALFCLOCK;
 			break;
+		case BB_SPEED_FAST:
+			if(mode_configuration.high_impedance){
+				//pull-ups can't raise open drain lines in 190ns, use speed 3
+				mode_configuration.speed=3;
+			}else{
+				bitbang.fast=1;
+			}
+			//fall through, bits and ticks run at the max speed timing
 		default:
 			bitbang.delaySettle = BB_MAXSPEED_SETTLE;
 			bitbang.delayClock = BB_MAXSPEED_CLOCK;
@@ -140,12 +153,20 @@ int bbI2Cstop(void){
 //BYTE functions
 //
 
+//mode word for bbShiftFast with the current bit count and output type
+static unsigned int bbShiftMode(unsigned int flags){
+	if(mode_configuration.high_impedance) flags|=BB_SHIFT_HIZ;
+	return mode_configuration.numbits | flags;
+}
+
 // ** Read with write for 3-wire protocols ** //
 
 //unsigned char bbReadWriteByte(unsigned char c){
 unsigned int bbReadWriteByte(unsigned int c){
 	unsigned int i,bt,tem,di,dat=0;
 
+	if(bitbang.fast) return bbShiftFast(c, bbShiftMode(BB_SHIFT_READ_MISO));
+
 	//begin with clock low...	
 	bt=1<<(mode_configuration.numbits-1);
 
@@ -171,6 +192,11 @@ unsigned int bbReadWriteByte(unsigned int c){
 void bbWriteByte(unsigned int c){
 	unsigned int i,bt,tem;
 
+	if(bitbang.fast){
+		bbShiftFast(c, bbShiftMode(0));
+		return;
+	}
+
 	//bbo();//prepare for output
 
 	//bt=0x80;
@@ -191,6 +217,8 @@ void bbWriteByte(unsigned int c){
 unsigned int bbReadByte(void){
 	unsigned int i,di,dat=0;
 
+	if(bitbang.fast) return bbShiftFast(0, bbShiftMode(BB_SHIFT_READ_MOSI));
+
 	//bbi();//prepare for input
 	bbR(MOSI); //setup for input
 
@@ -16,6 +16,17 @@
 //setup the library first
 void bbSetup(unsigned char pins, unsigned char speed);
 
+//speed setting that shifts bytes with the loops in bitbang_asm.s (~1.6MHz)
+#define BB_SPEED_FAST 4
+
+//assembly byte shift for the fast speed, see bitbang_asm.s
+//mode is the bit count (1-16) ORed with the flags below, returns the bits read
+unsigned int bbShiftFast(unsigned int data, unsigned int mode);
+#define BB_SHIFT_LSB_FIRST	0x0020 //shift LSB first instead of MSB first
+#define BB_SHIFT_READ_MISO	0x0040 //write MOSI and sample MISO (3-wire)
+#define BB_SHIFT_READ_MOSI	0x0080 //release MOSI and sample it (2-wire read)
+#define BB_SHIFT_HIZ		0x0100 //open drain outputs
+
 //byte functions 
 // bytes are overrated! migrating to unsigned int :D (read and write (procMenu) are already unsigned int)
 // the actual number of bits are stored in the bitbang struct, after each call this is set to 8
@@ -0,0 +1,205 @@
+;
+; bitbang_asm.s
+;
+; Byte shift loops for the top bitbang speed
+;
+; Published in the public domain.
+; For details see: http://creativecommons.org/publicdomain/zero/1.0/.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty o
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+;
+;
+; The C byte functions in bitbang.c go through bbPins/bbH/bbR/bbL for every
+; edge, each a call with a read-modify-write of LAT and TRIS and a
+; bp_delay_us, so even with all delays at 0 a bit costs around a hundred
+; cycles.  These loops keep everything in registers and touch only the
+; bits that change, with the same edge order as the C code: data out,
+; clock high, sample, clock low.
+;
+; Clock rates per speed setting, at 16 MIPS, worked out from the delays
+; and instruction timings (one cycle per instruction, two for a taken
+; branch) for a byte write:
+;
+;   speed  menu      per bit                        clock
+;   0      ~5KHz     220us of delays + calls        ~4.5KHz
+;   1      ~50KHz    22us of delays + calls         ~40KHz
+;   2      ~100KHz   11us of delays + calls         ~80KHz
+;   3      ~150KHz   calls only, ~100 cycles        ~150KHz
+;   4      ~1.6MHz   10 cycles (bbShiftFast)        1.6MHz
+;
+; None of these has been measured on an analyzer.  Speeds 1 and 2 keep
+; their old labels, the C loops land a little below them as bp_delay_us
+; and the calls add up; speed 3 was shown as ~400KHz.
+;
+; At speed 4 the clock is high for 3 cycles (190ns) and low for 7, and
+; interrupts are left enabled, so a USB or UART interrupt stretches the
+; low phase of whichever bit it lands on.  Open drain (HiZ) lines rise
+; only as fast as the pull-ups allow, far slower than 190ns, so bbSetup
+; falls back to speed 3 in HiZ mode and binwire refuses speed 4 there;
+; the BB_SHIFT_HIZ flag is kept for callers that bring a strong pull-up.
+;
+
+.ifdef __PIC24FJ256GB106__
+	.equ __24FJ256GB106, 1
+	.include "p24FJ256GB106.inc"
+
+	; Bus pirate v4 hardware, RD1 (MOSI), RD2 (CLK), RD3 (MISO)
+	.equ BB_PORT, PORTD
+	.equ BB_LAT, LATD
+	.equ BB_TRIS, TRISD
+	.equ BB_MOSI_BIT, 1
+	.equ BB_CLK_BIT, 2
+	.equ BB_MISO_BIT, 3
+.endif ; __PIC24FJ256GB106__
+
+.ifdef __PIC24FJ64GA002__
+	.equ __24FJ64GA002, 1
+	.include "p24FJ64GA002.inc"
+
+	; Bus pirate v3 hardware, RB9 (MOSI), RB8 (CLK), RB7 (MISO)
+	.equ BB_PORT, PORTB
+	.equ BB_LAT, LATB
+	.equ BB_TRIS, TRISB
+	.equ BB_MOSI_BIT, 9
+	.equ BB_CLK_BIT, 8
+	.equ BB_MISO_BIT, 7
+.endif ; __PIC24FJ64GA002__
+
+;
+; Mode word, keep in sync with the BB_SHIFT_* definitions in bitbang.h
+;
+.equ BB_SHIFT_BITS, 0x001F
+.equ BB_SHIFT_LSB_FIRST_BIT, 5
+.equ BB_SHIFT_READ_MISO_BIT, 6
+.equ BB_SHIFT_READ_MOSI_BIT, 7
+.equ BB_SHIFT_HIZ_BIT, 8
+
+;
+; One bit per iteration, 10 cycles (9 for a read without a write).
+;
+;  write   : shift a bit of w0 out on MOSI
+;  readbit : PORT bit to sample while the clock is high, -1 for none
+;  lsb     : shift LSB first rather than MSB first
+;
+; Register usage:
+;
+;  w0  : data out, MSB first data is left aligned
+;  w1  : bits left
+;  w2  : &LAT (push-pull) or &TRIS (open drain)
+;  w3  : constant BB_MOSI_BIT
+;  w4  : data in
+;  w6  : constant &PORT
+;
+.macro SHIFT_LOOP write, readbit, lsb
+__shift\@:
+.if \write
+.if \lsb
+		lsr	w0, w0			; C = next bit;
+.else
+		sl	w0, w0			; C = next bit;
+.endif
+		bsw.c	[w2], w3		; MOSI = C;
+.endif
+		nop				; data setup
+		bset	[w2], #BB_CLK_BIT	; CLK high;
+.if \readbit >= 0
+		nop				; PORT lags the pin by a cycle
+		btst.c	[w6], #\readbit		; C = data in;
+.if \lsb
+		rrc	w4, w4			; w4 = (C << 15) | (w4 >> 1);
+.else
+		rlc	w4, w4			; w4 = (w4 << 1) | C;
+.endif
+.else
+		nop				; clock high time
+		nop
+.endif
+		bclr	[w2], #BB_CLK_BIT	; CLK low;
+		dec	w1, w1			; } while (--w1);
+		bra	nz, __shift\@
+.endm
+
+;
+; Picks the MSB or LSB first version of a loop
+;
+.macro SHIFT_ORDERED write, readbit
+		btst	w5, #BB_SHIFT_LSB_FIRST_BIT
+		bra	nz, __lsb\@
+		SHIFT_LOOP \write, \readbit, 0
+		bra	__done
+__lsb\@:
+		SHIFT_LOOP \write, \readbit, 1
+		bra	__done
+.endm
+
+	.text
+	.global _bbShiftFast
+
+;
+; unsigned int bbShiftFast(unsigned int data, unsigned int mode)
+;
+; Clocks 1 to 16 bits out on MOSI and/or in from MISO or MOSI.  The clock
+; must be low on entry and is left low, MOSI keeps the last bit written.
+;
+; Parameters:
+;  w0 : data to write, right aligned
+;  w1 : mode, bit count (1-16) ORed with BB_SHIFT_* flags
+;
+; Returns:
+;  w0 : data read, right aligned, or 0 if nothing was read
+;
+_bbShiftFast:
+		mov	w1, w5			; w5 = mode;
+		and	w1, #BB_SHIFT_BITS, w1	; w1 = bits;
+		subr	w1, #16, w7		; w7 = 16 - bits;
+		mov	#BB_MOSI_BIT, w3	; w3 = BB_MOSI_BIT;
+		mov	#BB_PORT, w6		; w6 = &PORT;
+		clr	w4			; w4 = 0;
+
+		; Open drain drives the latch low once and toggles TRIS,
+		; push-pull makes the pins outputs once and toggles LAT
+		btst	w5, #BB_SHIFT_HIZ_BIT
+		bra	z, 1f
+		mov	#BB_LAT, w2
+		bclr	[w2], #BB_MOSI_BIT
+		bclr	[w2], #BB_CLK_BIT
+		mov	#BB_TRIS, w2		; w2 = &TRIS;
+		bra	2f
+1:
+		mov	#BB_TRIS, w2
+		bclr	[w2], #BB_MOSI_BIT
+		bclr	[w2], #BB_CLK_BIT
+		mov	#BB_LAT, w2		; w2 = &LAT;
+2:
+
+		; MSB first data goes out from bit 15 down
+		btst	w5, #BB_SHIFT_LSB_FIRST_BIT
+		bra	nz, 3f
+		sl	w0, w7, w0		; w0 <<= 16 - bits;
+3:
+
+		btst	w5, #BB_SHIFT_READ_MOSI_BIT
+		bra	nz, __read_mosi
+		btst	w5, #BB_SHIFT_READ_MISO_BIT
+		bra	nz, __read_miso
+
+		SHIFT_ORDERED 1, -1
+
+__read_miso:
+		SHIFT_ORDERED 1, BB_MISO_BIT
+
+__read_mosi:
+		mov	#BB_TRIS, w0		; MOSI as input
+		bset	[w0], #BB_MOSI_BIT
+		SHIFT_ORDERED 0, BB_MOSI_BIT
+
+__done:
+		; LSB first data came in from bit 15 down
+		btst	w5, #BB_SHIFT_LSB_FIRST_BIT
+		bra	z, 4f
+		lsr	w4, w7, w4		; w4 >>= 16 - bits;
+4:
+		mov	w4, w0			; return w4;
+		return
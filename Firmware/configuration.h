@@ -282,6 +282,17 @@
  * @todo Clarify whether this code can still be used.
  */
 
+/**
+ * #define BP_ENABLE_PERF_COUNTERS
+ *
+ * Keeps performance counters (bytes per mode, time spent waiting for the
+ * host, UARTbuf overflows, bulk handler timings) that a host can read and
+ * clear from binary mode.  Uses timer #1.
+ *
+ * @note BPv3 default firmware status: INCLUDED
+ * @note BPv4 default firmware status: INCLUDED
+ */
+
 #ifndef BP_CUSTOM_FEATURE_SET
 
 #ifdef BUSPIRATEV4
@@ -299,6 +310,7 @@
 #define BP_ENABLE_SPI_SUPPORT
 #define BP_ENABLE_SUMP_SUPPORT
 #define BP_ENABLE_UART_SUPPORT
+#define BP_ENABLE_PERF_COUNTERS
 #endif /* BUSPIRATEV4 */
 
 #ifdef BUSPIRATEV3
@@ -316,6 +328,7 @@
 #define BP_ENABLE_SPI_SUPPORT
 #define BP_ENABLE_SUMP_SUPPORT
 #define BP_ENABLE_UART_SUPPORT
+#define BP_ENABLE_PERF_COUNTERS
 #endif /* BUSPIRATEV3 */
 
 #endif /* !BP_CUSTOM_FEATURE_SET */
@@ -335,6 +348,7 @@
 #define BP_ENABLE_SPI_SUPPORT
 #define BP_ENABLE_SUMP_SUPPORT
 #define BP_ENABLE_UART_SUPPORT
+#define BP_ENABLE_PERF_COUNTERS
 #endif /* BP_CUSTOM_FEATURE_SET */
 
 /* 1-Wire module configuration definitions. */
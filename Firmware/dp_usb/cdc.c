@@ -344,6 +344,7 @@ void SendZLP(void) {
 /******************************************************************************/
 void CDC_Flush_In_Now(void) {
     if (cdc_In_len > 0) {
+        lock = 1; // Stops CDCFlushOnTimeout() sending the same buffer.
         while (!getInReady());
         putda_cdc(cdc_In_len);
         if (cdc_In_len == CDC_BUFFER_SIZE) {
@@ -353,6 +354,7 @@ void CDC_Flush_In_Now(void) {
         }
         cdc_In_len = 0;
         cdc_timeout_count = 0;
+        lock = 0;
     }
 }
 
@@ -372,7 +374,7 @@ void CDCFlushOnTimeout(void) {
                 cdc_In_len = 0;
                 cdc_timeout_count = 0;
             }
-        } else if (ZLPpending) {
+        } else if (ZLPpending && (lock == 0)) {
             putda_cdc(0);
             ZLPpending = 0;
             cdc_timeout_count = 0;
@@ -385,6 +387,10 @@ void CDCFlushOnTimeout(void) {
 /******************************************************************************/
 void putc_cdc(BYTE c) {
     lock = 1; // Stops CDCFlushOnTimeout() from sending per chance it is on interrupts.
+    if (cdc_In_len == CDC_BUFFER_SIZE) { // Left full by put_cdc_nowait().
+        putda_cdc(cdc_In_len);
+        cdc_In_len = 0;
+    }
     *InPtr = c;
     InPtr++;
     cdc_In_len++;
@@ -398,6 +404,78 @@ void putc_cdc(BYTE c) {
     cdc_timeout_count = 0; //setup timer to throw data if the buffer doesn't fill
 }
 
+/******************************************************************************/
+// Queues count bytes for the IN endpoint a block at a time. Each buffer is
+// filled with one copy and handed to the endpoint as soon as it holds a full
+// packet, putda_cdc() only waits for the packet before it, so one buffer is
+// on the wire while the other is filled. A last partial packet stays queued
+// for CDC_Flush_In_Now() or the SOF timeout, as with putc_cdc().
+
+void put_cdc_block(const BYTE * data, unsigned int count) {
+    BYTE chunk;
+
+    while (count > 0) {
+        chunk = CDC_BUFFER_SIZE - cdc_In_len;
+        if (chunk > count) {
+            chunk = count;
+        }
+
+        lock = 1;
+        memcpy(InPtr, data, chunk);
+        InPtr += chunk;
+        cdc_In_len += chunk;
+        ZLPpending = 0;
+        if (cdc_In_len == CDC_BUFFER_SIZE) {
+            putda_cdc(cdc_In_len);
+            cdc_In_len = 0;
+            ZLPpending = 1; // timeout handled in the SOF handler.
+        }
+        lock = 0;
+
+        data += chunk;
+        count -= chunk;
+    }
+    cdc_timeout_count = 0;
+}
+
+/******************************************************************************/
+// Queues count bytes (at most CDC_BUFFER_SIZE) for the IN endpoint without
+// ever waiting. The bytes are either all queued, and count is returned, or
+// none are because both ping-pong buffers are full, and zero is returned.
+// A full buffer is handed to the endpoint as soon as it is free; one that
+// cannot be yet is sent by the next call, CDCFlushOnTimeout() or the other
+// put functions, which all check for it.
+
+BYTE put_cdc_nowait(const BYTE * data, BYTE count) {
+    BYTE i;
+
+    lock = 1; // Stops CDCFlushOnTimeout() arming the buffer armed here.
+    if ((cdc_In_len + count) > CDC_BUFFER_SIZE) {
+        if (!getInReady()) {
+            lock = 0;
+            return 0; // Other buffer still owned by the SIE, caller drops data.
+        }
+        putda_cdc(cdc_In_len);
+        cdc_In_len = 0;
+    }
+
+    for (i = 0; i < count; i++) {
+        *InPtr = data[i];
+        InPtr++;
+    }
+    cdc_In_len += count;
+    ZLPpending = 0;
+
+    if ((cdc_In_len == CDC_BUFFER_SIZE) && getInReady()) {
+        putda_cdc(cdc_In_len);
+        cdc_In_len = 0;
+        ZLPpending = 1; // timeout handled in the SOF handler.
+    }
+    lock = 0;
+    cdc_timeout_count = 0;
+    return count;
+}
+
 /******************************************************************************/
 // Waits for a byte to be available and returns that byte as a
 // function return value. The byte is removed from the CDC OUT queue.
@@ -417,6 +495,32 @@ BYTE getc_cdc(void) { // Must be used only in double buffer mode.
     return c;
 }
 
+/******************************************************************************/
+// Waits for count bytes and copies them to data, a packet at a time rather
+// than a getc_cdc() call per byte. The bytes are removed from the queue.
+
+void get_cdc_block(BYTE * data, unsigned int count) {
+    BYTE chunk;
+
+    while (count > 0) {
+        while (cdc_Out_len == 0) {
+            cdc_Out_len = getda_cdc(); // Skip any ZLP
+        }
+
+        chunk = cdc_Out_len;
+        if (chunk > count) {
+            chunk = count;
+        }
+
+        memcpy(data, OutPtr, chunk);
+        OutPtr += chunk;
+        cdc_Out_len -= chunk;
+
+        data += chunk;
+        count -= chunk;
+    }
+}
+
 /******************************************************************************/
 // Checks to see if there is a byte available in the CDC buffer.
 // If so, it returns that byte at the dereferenced pointer *C
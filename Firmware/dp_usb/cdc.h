@@ -33,7 +33,10 @@ void putc_cdc(BYTE c);
 void CDC_Flush_In_Now(void);
 void CDCFlushOnTimeout(void);
 BYTE poll_getc_cdc(BYTE * c);
+void get_cdc_block(BYTE * data, unsigned int count);
 BYTE peek_getc_cdc(BYTE * c);
+BYTE put_cdc_nowait(const BYTE * data, BYTE count);
+void put_cdc_block(const BYTE * data, unsigned int count);
 void initCDC(void);
 
 
@@ -22,6 +22,7 @@
 #include "bitbang.h"
 #include "bus_pirate_core.h"//need access to bpConfig
 #include "binIOhelpers.h"
+#include "perf_counters.h"
 #include "AUXpin.h"
 
 #include "procMenu.h"		// for the userinteraction subs
@@ -78,6 +79,7 @@ void I2C_Setup(void);
 void I2Csetup_exc(void);
 void I2C_SnifferSetup(void);
 void I2C_Sniffer(unsigned char termMode);
+void I2C_SnifferRecords(void);
 
 unsigned int I2Cread(void) {
     unsigned char c = 0;
@@ -792,11 +794,220 @@ void I2C_Sniffer(unsigned char termMode) {
     BP_MOSI_CN = 0; // clear change notice
     BP_CLK_CN = 0;
 
+    UARTbufFlush(); //send what is still queued
     if (termMode) {
         bpBR;
+        UARTbufReport();
     }
 }
 
+//*******************/
+//
+//
+//	I2C sniffer, timestamped binary records
+//
+//
+//*******************/
+//
+// The escaped binary sniffer sends the same '[', ']', '+' and '-' as the
+// terminal and has no timing. This one sends compact records, timed with
+// timer #4/#5 running as a free running 32 bit counter at Fcy/8 (0.5us per
+// tick). Multi byte fields are MSB first.
+//
+// 0x01 d1 d0                       start, d ticks after the previous start
+// 0x02 d3 d2 d1 d0                 start, for gaps of 0x10000 ticks or more
+// 0x03                             stop
+// 0x04 b                           byte b, ACKed
+// 0x05 b                           byte b, NACKed
+// 0x06 c1 c0                       records were lost before this one
+// 0x00                             end, the sniffer stopped
+//
+// A start without a stop before it is a repeated start. The delta of the
+// first start counts from the moment the sniffer started.
+//
+// Records are queued whole or dropped, never waited on, so a busy bus can't
+// stall the sampling loop. The next record that fits is preceded by a 0x06
+// record holding the number of records lost (saturated at 0xFFFF). Queued
+// records go out within a USB packet timeout on a v4 and as fast as the UART
+// drains on a v3, where sustained traffic needs the 0x06 records.
+//
+// Any byte from the host stops the sniffer. The 0x00 record comes after
+// everything still queued, the host reads up to it before sending commands.
+
+#define I2C_RECORD_END 0x00
+#define I2C_RECORD_START 0x01
+#define I2C_RECORD_START_LONG 0x02
+#define I2C_RECORD_STOP 0x03
+#define I2C_RECORD_ACK 0x04
+#define I2C_RECORD_NACK 0x05
+#define I2C_RECORD_DROPPED 0x06
+
+#define I2C_RECORD_DROPPED_MAX 0xFFFF
+
+static unsigned int i2cRecordsDropped; //records lost since the last one sent
+
+static uint32_t I2C_SnifferTime(void) {
+    uint16_t lsw;
+
+    lsw = TMR4; //latches TMR5 into TMR5HLD
+    return ((uint32_t) TMR5HLD << 16) | lsw;
+}
+
+//queue a whole record or nothing
+static bool I2C_SnifferQueue(const uint8_t *record, uint8_t length) {
+#if defined(BUSPIRATEV4) && !defined(BPV4_DEBUG)
+    return put_cdc_nowait(record, length) != 0;
+#else
+    uint8_t i;
+
+    if (UARTbufFree() < length) return false;
+    for (i = 0; i < length; i++) {
+        UARTbuf(record[i]);
+    }
+    return true;
+#endif
+}
+
+//send a record, reporting earlier losses first
+static void I2C_SnifferSend(const uint8_t *record, uint8_t length) {
+    uint8_t dropped[3];
+
+    if (i2cRecordsDropped != 0) {
+        dropped[0] = I2C_RECORD_DROPPED;
+        dropped[1] = (uint8_t) (i2cRecordsDropped >> 8);
+        dropped[2] = (uint8_t) i2cRecordsDropped;
+        if (I2C_SnifferQueue(dropped, sizeof (dropped))) {
+            i2cRecordsDropped = 0;
+        }
+    }
+
+    if (i2cRecordsDropped == 0 && I2C_SnifferQueue(record, length)) return;
+
+    if (i2cRecordsDropped != I2C_RECORD_DROPPED_MAX) i2cRecordsDropped++;
+}
+
+void I2C_SnifferRecords(void) {
+    unsigned char SDANew, SDAOld;
+    unsigned char SCLNew, SCLOld;
+
+    unsigned char DataState = 0;
+    unsigned char DataBits = 0;
+    unsigned char dat = 0;
+    uint8_t record[5];
+    uint32_t now, delta, lastStart;
+
+    UARTbufSetup();
+
+    SDA_TRIS = 1; // -- Ensure pins are in high impedance mode --
+    SCL_TRIS = 1;
+
+    SCL = 0; // writes to the PORTs write to the LATCH
+    SDA = 0;
+
+    //timer #4/#5 as a free running 32 bits counter, Fcy/8
+    T4CON = 0;
+    TMR5HLD = 0;
+    TMR4 = 0;
+    PR5 = 0xFFFF;
+    PR4 = 0xFFFF;
+    T4CONbits.T32 = ON;
+    T4CONbits.TCKPS = 0b01;
+    T4CONbits.TON = ON;
+
+    BP_MOSI_CN = 1; // enable change notice on SCL and SDA
+    BP_CLK_CN = 1;
+
+    IFS1bits.CNIF = 0; // clear the change interrupt flag
+
+    i2cRecordsDropped = 0;
+    lastStart = 0;
+
+    SDAOld = SDA;
+    SCLOld = SCL;
+
+    while (1) {
+        if (!IFS1bits.CNIF) {//check change notice interrupt
+            UARTbufService();
+            if (UART1RXRdy()) { //any byte stops the sniffer
+                UART1RX();
+                break;
+            }
+            continue;
+        }
+
+        IFS1bits.CNIF = 0; //clear interrupt flag
+
+        SDANew = SDA; //store current state right away
+        SCLNew = SCL;
+
+        if (DataState && !SCLOld && SCLNew) // Sample When SCL Goes Low To High
+        {
+            if (DataBits < 8) //we're still collecting data bits
+            {
+                dat = dat << 1;
+                if (SDANew) {
+                    dat |= 1;
+                }
+
+                DataBits++;
+            } else {
+                record[0] = SDANew ? I2C_RECORD_NACK : I2C_RECORD_ACK; // SDA High Means NACK
+                record[1] = dat;
+                I2C_SnifferSend(record, 2);
+                DataBits = 0; // Ready For Next Data Byte
+            }
+        } else if (SCLOld && SCLNew) // SCL High, Must Be Data Transition
+        {
+            if (SDAOld && !SDANew) // Start Condition (High To Low)
+            {
+                DataState = 1; // Allow Data Collection
+                DataBits = 0;
+
+                now = I2C_SnifferTime();
+                delta = now - lastStart;
+                lastStart = now;
+                if (delta > 0xFFFF) {
+                    record[0] = I2C_RECORD_START_LONG;
+                    record[1] = (uint8_t) (delta >> 24);
+                    record[2] = (uint8_t) (delta >> 16);
+                    record[3] = (uint8_t) (delta >> 8);
+                    record[4] = (uint8_t) delta;
+                    I2C_SnifferSend(record, 5);
+                } else {
+                    record[0] = I2C_RECORD_START;
+                    record[1] = (uint8_t) (delta >> 8);
+                    record[2] = (uint8_t) delta;
+                    I2C_SnifferSend(record, 3);
+                }
+            } else if (!SDAOld && SDANew) // Stop Condition (Low To High)
+            {
+                DataState = 0; // Don't Allow Data Collection
+                DataBits = 0;
+
+                record[0] = I2C_RECORD_STOP;
+                I2C_SnifferSend(record, 1);
+            }
+        }
+
+        SDAOld = SDANew; // Save Last States
+        SCLOld = SCLNew;
+    }
+
+    BP_MOSI_CN = 0; // clear change notice
+    BP_CLK_CN = 0;
+
+    if (i2cRecordsDropped != 0) { //a last try for the loss report
+        record[0] = I2C_RECORD_DROPPED;
+        record[1] = (uint8_t) (i2cRecordsDropped >> 8);
+        record[2] = (uint8_t) i2cRecordsDropped;
+        I2C_SnifferQueue(record, 3);
+    }
+    UARTbufFlush(); //send what is still queued
+    UART1TX(I2C_RECORD_END);
+
+    T4CON = 0;
+}
+
 /*
 rawI2C mode:
 # 00000000//reset to BBIO
@@ -806,6 +1017,7 @@ rawI2C mode:
 # 00000100 - I2C read byte
 # 00000110 - ACK bit
 # 00000111 - NACK bit
+# 00001110 - Timestamped binary sniffer records
 # 0001xxxx � Bulk transfer, send 1-16 bytes (0=1byte!)
 # (0110)000x - Set I2C speed, 3 = 400khz 2=100khz 1=50khz 0=5khz
 # (0111)000x - Read speed, (planned)
@@ -896,12 +1108,10 @@ I2C_write_read_error: //use this for the read error too
                             break;
                         }
 
+                        PERF_BEGIN(PERF_HANDLER_I2C_WRITE_READ);
+
                         //get bytes
-                        for (j = 0; j < fw; j++) {
-                            //JTR Not required while (!UART1RXRdy()); //wait for a byte
-                            bus_pirate_configuration.terminal_input[j] = UART1RX();
-                            /* JTR usb port; */;
-                        }
+                        bp_read_buffer(bus_pirate_configuration.terminal_input, fw);
 
                         //start
                         bbI2Cstart();
@@ -930,10 +1140,10 @@ I2C_write_read_error: //use this for the read error too
 
                         UART1TX(1); //send 1/OK
 
-                        for (j = 0; j < fr; j++) { //send the read buffer contents over serial
-                            UART1TX(bus_pirate_configuration.terminal_input[j]);
-                        }
+                        //send the read buffer contents over serial
+                        bp_write_buffer(bus_pirate_configuration.terminal_input, fr);
 
+                        PERF_END(PERF_HANDLER_I2C_WRITE_READ);
                         break;//00001001 xxxxxxxx
 					case 9: //extended AUX command
 					      UART1TX(1); //confirm that the command is known
@@ -973,6 +1183,10 @@ I2C_write_read_error: //use this for the read error too
 					      }
 					      UART1TX(fr);//result
 					      break;
+                    case 0b1110:
+                        UART1TX(1);
+                        I2C_SnifferRecords(); //timestamped records
+                        break;
                     case 0b1111:
                         I2C_Sniffer(0); //set for raw output
                         UART1TX(1);
@@ -988,11 +1202,13 @@ I2C_write_read_error: //use this for the read error too
                 inByte++; //increment by 1, 0=1byte
                 UART1TX(1); //send 1/OK
 
+                PERF_BEGIN(PERF_HANDLER_I2C_BULK);
                 for (i = 0; i < inByte; i++) {
                     //JTR Not required while (UART1RXRdy() == 0); //wait for a byte
                     bbWriteByte(UART1RX()); // JTR usb port //send byte
                     UART1TX(bbReadBit()); //return ACK0 or NACK1
                 }
+                PERF_END(PERF_HANDLER_I2C_BULK);
 
                 break;
 
@@ -21,6 +21,7 @@
 
 #include "basic.h"
 #include "bus_pirate_core.h"
+#include "perf_counters.h"
 #include "procMenu.h"
 #include "selftest.h"
 
@@ -42,7 +43,7 @@ static void initialize_board(void);
  * Internal terminal buffer area.
  */
 static uint8_t bp_buffer[BP_TERMINAL_BUFFER_SIZE]
-    __attribute__((section(".bss.end")));
+    __attribute__((section(".bss.end"), aligned(2)));
 
 /**
  * Global configuration data holder.
@@ -189,6 +190,11 @@ void initialize_board(void) {
   InitializeUART1();
 #endif /* BUSPIRATEV4 && BPV4_DEBUG */
 
+#ifdef BP_ENABLE_PERF_COUNTERS
+  /* Start the performance counters clock. */
+  perf_counters_init();
+#endif /* BP_ENABLE_PERF_COUNTERS */
+
 #ifdef BUSPIRATEV3
   /* Turn pull-ups ON. */
   CNPU1bits.CN6PUE = ON;
@@ -8,249 +8,254 @@
 #define BPMSG1006 bp_message_write_line(102, 13)
 #define BPMSG1007 bp_message_write_line(115, 23)
 #define BPMSG1008 bp_message_write_buffer(138, 6)
-#define BPMSG1009 bp_message_write_line(144, 211)
-#define BPMSG1010 bp_message_write_line(355, 19)
-#define BPMSG1011 bp_message_write_line(374, 13)
-#define BPMSG1012 bp_message_write_line(387, 43)
-#define BPMSG1013 bp_message_write_buffer(430, 17)
-#define BPMSG1014 bp_message_write_line(447, 16)
-#define BPMSG1015 bp_message_write_line(463, 15)
-#define BPMSG1016 bp_message_write_line(478, 36)
-#define BPMSG1017 bp_message_write_buffer(514, 10)
-#define BPMSG1019 bp_message_write_buffer(524, 9)
-#define BPMSG1020 bp_message_write_buffer(533, 21)
-#define BPMSG1021 bp_message_write_buffer(554, 20)
-#define BPMSG1022 bp_message_write_line(574, 27)
-#define BPMSG1023 bp_message_write_line(601, 26)
-#define BPMSG1024 bp_message_write_line(627, 21)
-#define BPMSG1025 bp_message_write_line(648, 24)
-#define BPMSG1026 bp_message_write_line(672, 16)
-#define BPMSG1027 bp_message_write_buffer(688, 14)
-#define BPMSG1028 bp_message_write_line(702, 12)
-#define BPMSG1029 bp_message_write_line(714, 17)
-#define BPMSG1030 bp_message_write_buffer(731, 17)
-#define BPMSG1031 bp_message_write_buffer(748, 9)
-#define BPMSG1032 bp_message_write_buffer(757, 4)
-#define BPMSG1033 bp_message_write_buffer(761, 16)
-#define BPMSG1034 bp_message_write_line(777, 10)
-#define BPMSG1037 bp_message_write_line(787, 31)
-#define BPMSG1038 bp_message_write_buffer(818, 15)
-#define BPMSG1039 bp_message_write_buffer(833, 14)
-#define BPMSG1040 bp_message_write_line(847, 8)
-#define BPMSG1041 bp_message_write_line(855, 7)
-#define BPMSG1042 bp_message_write_line(862, 14)
-#define BPMSG1044 bp_message_write_buffer(876, 15)
-#define BPMSG1045 bp_message_write_buffer(891, 1)
-#define BPMSG1047 bp_message_write_buffer(892, 6)
-#define BPMSG1048 bp_message_write_buffer(898, 8)
-#define BPMSG1049 bp_message_write_buffer(906, 11)
-#define BPMSG1050 bp_message_write_line(917, 7)
-#define BPMSG1051 bp_message_write_line(924, 9)
-#define BPMSG1052 bp_message_write_line(933, 12)
-#define BPMSG1053 bp_message_write_line(945, 9)
-#define BPMSG1054 bp_message_write_buffer(954, 7)
-#define BPMSG1055 bp_message_write_line(961, 4)
-#define BPMSG1056 bp_message_write_buffer(965, 15)
-#define BPMSG1057 bp_message_write_line(980, 12)
-#define BPMSG1058 bp_message_write_buffer(992, 18)
-#define BPMSG1059 bp_message_write_line(1010, 33)
-#define BPMSG1060 bp_message_write_buffer(1043, 3)
-#define BPMSG1061 bp_message_write_buffer(1046, 4)
-#define BPMSG1062 bp_message_write_line(1050, 13)
-#define BPMSG1063 bp_message_write_line(1063, 12)
-#define BPMSG1064 bp_message_write_line(1075, 37)
-#define BPMSG1065 bp_message_write_line(1112, 59)
-#define BPMSG1066 bp_message_write_buffer(1171, 53)
-#define BPMSG1067 bp_message_write_buffer(1224, 44)
-#define BPMSG1068 bp_message_write_buffer(1268, 16)
-#define BPMSG1069 bp_message_write_buffer(1284, 53)
-#define BPMSG1070 bp_message_write_line(1337, 46)
-#define BPMSG1071 bp_message_write_line(1383, 7)
-#define BPMSG1084 bp_message_write_buffer(1390, 7)
-#define BPMSG1085 bp_message_write_line(1397, 5)
-#define BPMSG1086 bp_message_write_line(1402, 22)
-#define BPMSG1087 bp_message_write_line(1424, 21)
-#define BPMSG1088 bp_message_write_line(1445, 29)
-#define BPMSG1089 bp_message_write_buffer(1474, 21)
-#define BPMSG1091 bp_message_write_buffer(1495, 20)
-#define BPMSG1092 bp_message_write_line(1515, 26)
-#define BPMSG1093 bp_message_write_line(1541, 5)
-#define BPMSG1094 bp_message_write_line(1546, 10)
-#define BPMSG1095 bp_message_write_buffer(1556, 22)
-#define BPMSG1096 bp_message_write_buffer(1578, 17)
-#define BPMSG1097 bp_message_write_buffer(1595, 18)
-#define BPMSG1098 bp_message_write_buffer(1613, 12)
-#define BPMSG1099 bp_message_write_buffer(1625, 6)
-#define BPMSG1100 bp_message_write_line(1631, 2)
-#define BPMSG1101 bp_message_write_buffer(1633, 7)
-#define BPMSG1102 bp_message_write_buffer(1640, 6)
-#define BPMSG1103 bp_message_write_line(1646, 8)
-#define BPMSG1104 bp_message_write_line(1654, 8)
-#define BPMSG1105 bp_message_write_line(1662, 14)
-#define BPMSG1106 bp_message_write_line(1676, 14)
-#define BPMSG1107 bp_message_write_line(1690, 16)
-#define BPMSG1108 bp_message_write_buffer(1706, 13)
-#define BPMSG1109 bp_message_write_buffer(1719, 10)
-#define BPMSG1110 bp_message_write_buffer(1729, 21)
-#define BPMSG1111 bp_message_write_line(1750, 23)
-#define BPMSG1112 bp_message_write_line(1773, 14)
-#define BPMSG1113 bp_message_write_line(1787, 49)
-#define BPMSG1114 bp_message_write_line(1836, 21)
-#define BPMSG1115 bp_message_write_line(1857, 7)
-#define BPMSG1116 bp_message_write_line(1864, 27)
-#define BPMSG1117 bp_message_write_buffer(1891, 6)
-#define BPMSG1118 bp_message_write_line(1897, 30)
-#define BPMSG1119 bp_message_write_line(1927, 12)
-#define BPMSG1120 bp_message_write_line(1939, 34)
-#define BPMSG1121 bp_message_write_line(1973, 30)
-#define BPMSG1123 bp_message_write_buffer(2003, 27)
-#define BPMSG1124 bp_message_write_buffer(2030, 28)
-#define BPMSG1126 bp_message_write_buffer(2058, 13)
-#define BPMSG1127 bp_message_write_line(2071, 34)
-#define BPMSG1128 bp_message_write_line(2105, 18)
-#define BPMSG1129 bp_message_write_line(2123, 18)
-#define BPMSG1130 bp_message_write_buffer(2141, 4)
-#define BPMSG1131 bp_message_write_buffer(2145, 9)
-#define BPMSG1132 bp_message_write_buffer(2154, 12)
-#define BPMSG1133 bp_message_write_line(2166, 141)
-#define BPMSG1134 bp_message_write_line(2307, 20)
-#define BPMSG1135 bp_message_write_buffer(2327, 14)
-#define BPMSG1136 bp_message_write_buffer(2341, 5)
-#define BPMSG1137 bp_message_write_buffer(2346, 6)
-#define BPMSG1138 bp_message_write_buffer(2352, 8)
-#define BPMSG1140 bp_message_write_buffer(2360, 6)
-#define BPMSG1142 bp_message_write_line(2366, 79)
-#define BPMSG1143 bp_message_write_buffer(2445, 16)
-#define BPMSG1144 bp_message_write_buffer(2461, 56)
-#define BPMSG1145 bp_message_write_line(2517, 63)
-#define BPMSG1146 bp_message_write_buffer(2580, 45)
-#define BPMSG1147 bp_message_write_buffer(2625, 10)
-#define BPMSG1148 bp_message_write_buffer(2635, 6)
-#define BPMSG1149 bp_message_write_buffer(2641, 6)
-#define BPMSG1150 bp_message_write_buffer(2647, 6)
-#define BPMSG1151 bp_message_write_buffer(2653, 3)
-#define BPMSG1152 bp_message_write_buffer(2656, 7)
-#define BPMSG1153 bp_message_write_buffer(2663, 11)
-#define BPMSG1154 bp_message_write_buffer(2674, 6)
-#define BPMSG1155 bp_message_write_buffer(2680, 15)
-#define BPMSG1156 bp_message_write_buffer(2695, 12)
-#define BPMSG1157 bp_message_write_buffer(2707, 13)
-#define BPMSG1158 bp_message_write_buffer(2720, 25)
-#define BPMSG1159 bp_message_write_line(2745, 10)
-#define BPMSG1160 bp_message_write_line(2755, 11)
-#define BPMSG1161 bp_message_write_buffer(2766, 20)
-#define BPMSG1162 bp_message_write_buffer(2786, 3)
-#define BPMSG1163 bp_message_write_line(2789, 63)
-#define BPMSG1164 bp_message_write_line(2852, 4)
-#define BPMSG1165 bp_message_write_buffer(2856, 3)
-#define BPMSG1166 bp_message_write_buffer(2859, 8)
-#define BPMSG1167 bp_message_write_buffer(2867, 8)
-#define BPMSG1168 bp_message_write_buffer(2875, 8)
-#define BPMSG1169 bp_message_write_buffer(2883, 4)
-#define BPMSG1170 bp_message_write_line(2887, 14)
-#define BPMSG1171 bp_message_write_buffer(2901, 2)
-#define BPMSG1172 bp_message_write_buffer(2903, 3)
-#define BPMSG1173 bp_message_write_buffer(2906, 4)
-#define BPMSG1174 bp_message_write_buffer(2910, 3)
-#define BPMSG1175 bp_message_write_line(2913, 8)
-#define BPMSG1176 bp_message_write_line(2921, 10)
-#define BPMSG1177 bp_message_write_line(2931, 10)
-#define BPMSG1178 bp_message_write_line(2941, 32)
-#define BPMSG1179 bp_message_write_buffer(2973, 6)
-#define BPMSG1180 bp_message_write_line(2979, 8)
-#define BPMSG1181 bp_message_write_buffer(2987, 4)
-#define BPMSG1182 bp_message_write_buffer(2991, 3)
-#define BPMSG1183 bp_message_write_buffer(2994, 4)
-#define BPMSG1184 bp_message_write_buffer(2998, 2)
-#define BPMSG1185 bp_message_write_line(3000, 3)
-#define BPMSG1186 bp_message_write_line(3003, 5)
-#define BPMSG1187 bp_message_write_line(3008, 55)
-#define BPMSG1188 bp_message_write_line(3063, 53)
-#define BPMSG1189 bp_message_write_line(3116, 67)
-#define BPMSG1190 bp_message_write_line(3183, 49)
-#define BPMSG1191 bp_message_write_buffer(3232, 32)
-#define BPMSG1192 bp_message_write_line(3264, 52)
-#define BPMSG1194 bp_message_write_buffer(3316, 3)
-#define BPMSG1195 bp_message_write_buffer(3319, 3)
-#define BPMSG1196 bp_message_write_buffer(3322, 15)
-#define BPMSG1197 bp_message_write_buffer(3337, 15)
-#define BPMSG1199 bp_message_write_buffer(3352, 84)
-#define BPMSG1200 bp_message_write_buffer(3436, 33)
-#define BPMSG1201 bp_message_write_buffer(3469, 50)
-#define BPMSG1202 bp_message_write_buffer(3519, 32)
-#define BPMSG1203 bp_message_write_buffer(3551, 106)
-#define BPMSG1204 bp_message_write_line(3657, 11)
-#define BPMSG1205 bp_message_write_line(3668, 13)
-#define BPMSG1206 bp_message_write_line(3681, 14)
-#define BPMSG1207 bp_message_write_line(3695, 28)
-#define BPMSG1208 bp_message_write_line(3723, 20)
-#define BPMSG1209 bp_message_write_line(3743, 34)
-#define BPMSG1210 bp_message_write_buffer(3777, 7)
-#define BPMSG1211 bp_message_write_line(3784, 27)
-#define BPMSG1212 bp_message_write_line(3811, 2)
-#define BPMSG1213 bp_message_write_line(3813, 20)
-#define BPMSG1214 bp_message_write_line(3833, 18)
-#define BPMSG1215 bp_message_write_line(3851, 19)
-#define BPMSG1216 bp_message_write_line(3870, 29)
-#define BPMSG1217 bp_message_write_line(3899, 50)
-#define BPMSG1218 bp_message_write_buffer(3949, 19)
-#define BPMSG1219 bp_message_write_line(3968, 152)
-#define BPMSG1220 bp_message_write_line(4120, 36)
-#define BPMSG1221 bp_message_write_line(4156, 4)
-#define BPMSG1222 bp_message_write_line(4160, 5)
-#define BPMSG1223 bp_message_write_line(4165, 10)
-#define BPMSG1224 bp_message_write_line(4175, 21)
-#define BPMSG1225 bp_message_write_line(4196, 16)
-#define BPMSG1226 bp_message_write_line(4212, 10)
-#define BPMSG1227 bp_message_write_buffer(4222, 26)
-#define BPMSG1228 bp_message_write_buffer(4248, 10)
-#define BPMSG1229 bp_message_write_line(4258, 9)
-#define BPMSG1230 bp_message_write_line(4267, 11)
-#define BPMSG1231 bp_message_write_line(4278, 11)
-#define BPMSG1232 bp_message_write_line(4289, 11)
-#define BPMSG1233 bp_message_write_line(4300, 70)
-#define BPMSG1234 bp_message_write_buffer(4370, 4)
-#define BPMSG1235 bp_message_write_buffer(4374, 26)
-#define BPMSG1236 bp_message_write_buffer(4400, 10)
-#define BPMSG1245 bp_message_write_buffer(4410, 11)
-#define BPMSG1246 bp_message_write_buffer(4421, 5)
-#define BPMSG1247 bp_message_write_buffer(4426, 5)
-#define BPMSG1248 bp_message_write_line(4431, 28)
-#define BPMSG1249 bp_message_write_line(4459, 32)
-#define BPMSG1250 bp_message_write_line(4491, 15)
-#define BPMSG1251 bp_message_write_line(4506, 17)
-#define BPMSG1252 bp_message_write_buffer(4523, 27)
-#define BPMSG1253 bp_message_write_line(4550, 29)
-#define BPMSG1254 bp_message_write_line(4579, 19)
-#define BPMSG1255 bp_message_write_line(4598, 12)
-#define BPMSG1280 bp_message_write_line(4610, 19)
-#define BPMSG1281 bp_message_write_line(4629, 14)
-#define BPMSG1282 bp_message_write_line(4643, 47)
-#define BPMSG1283 bp_message_write_buffer(4690, 15)
-#define BPMSG1284 bp_message_write_buffer(4705, 15)
-#define BPMSG1285 bp_message_write_line(4720, 4)
-#define HLP1000 bp_message_write_line(4724, 33)
-#define HLP1001 bp_message_write_line(4757, 76)
-#define HLP1002 bp_message_write_line(4833, 38)
-#define HLP1003 bp_message_write_line(4871, 40)
-#define HLP1004 bp_message_write_line(4911, 21)
-#define HLP1005 bp_message_write_line(4932, 27)
-#define HLP1006 bp_message_write_line(4959, 40)
-#define HLP1007 bp_message_write_line(4999, 27)
-#define HLP1008 bp_message_write_line(5026, 46)
-#define HLP1009 bp_message_write_line(5072, 21)
-#define HLP1010 bp_message_write_line(5093, 35)
-#define HLP1011 bp_message_write_line(5128, 46)
-#define HLP1012 bp_message_write_line(5174, 28)
-#define HLP1013 bp_message_write_line(5202, 33)
-#define HLP1014 bp_message_write_line(5235, 28)
-#define HLP1015 bp_message_write_line(5263, 37)
-#define HLP1016 bp_message_write_line(5300, 33)
-#define HLP1017 bp_message_write_line(5333, 25)
-#define HLP1018 bp_message_write_line(5358, 31)
-#define HLP1019 bp_message_write_line(5389, 41)
-#define HLP1020 bp_message_write_line(5430, 37)
-#define HLP1021 bp_message_write_line(5467, 54)
-#define HLP1022 bp_message_write_line(5521, 62)
+#define BPMSG1009 bp_message_write_line(144, 380)
+#define BPMSG1010 bp_message_write_line(524, 19)
+#define BPMSG1011 bp_message_write_line(543, 13)
+#define BPMSG1012 bp_message_write_line(556, 43)
+#define BPMSG1013 bp_message_write_buffer(599, 17)
+#define BPMSG1014 bp_message_write_line(616, 16)
+#define BPMSG1015 bp_message_write_line(632, 15)
+#define BPMSG1016 bp_message_write_line(647, 36)
+#define BPMSG1017 bp_message_write_buffer(683, 10)
+#define BPMSG1019 bp_message_write_buffer(693, 9)
+#define BPMSG1020 bp_message_write_buffer(702, 21)
+#define BPMSG1021 bp_message_write_buffer(723, 20)
+#define BPMSG1022 bp_message_write_line(743, 27)
+#define BPMSG1023 bp_message_write_line(770, 26)
+#define BPMSG1024 bp_message_write_line(796, 21)
+#define BPMSG1025 bp_message_write_line(817, 24)
+#define BPMSG1026 bp_message_write_line(841, 16)
+#define BPMSG1027 bp_message_write_buffer(857, 14)
+#define BPMSG1028 bp_message_write_line(871, 12)
+#define BPMSG1029 bp_message_write_line(883, 17)
+#define BPMSG1030 bp_message_write_buffer(900, 17)
+#define BPMSG1031 bp_message_write_buffer(917, 9)
+#define BPMSG1032 bp_message_write_buffer(926, 4)
+#define BPMSG1033 bp_message_write_buffer(930, 16)
+#define BPMSG1034 bp_message_write_line(946, 10)
+#define BPMSG1037 bp_message_write_line(956, 31)
+#define BPMSG1038 bp_message_write_buffer(987, 15)
+#define BPMSG1039 bp_message_write_buffer(1002, 14)
+#define BPMSG1040 bp_message_write_line(1016, 8)
+#define BPMSG1041 bp_message_write_line(1024, 7)
+#define BPMSG1042 bp_message_write_line(1031, 14)
+#define BPMSG1044 bp_message_write_buffer(1045, 15)
+#define BPMSG1045 bp_message_write_buffer(1060, 1)
+#define BPMSG1047 bp_message_write_buffer(1061, 6)
+#define BPMSG1048 bp_message_write_buffer(1067, 8)
+#define BPMSG1049 bp_message_write_buffer(1075, 11)
+#define BPMSG1050 bp_message_write_line(1086, 7)
+#define BPMSG1051 bp_message_write_line(1093, 9)
+#define BPMSG1052 bp_message_write_line(1102, 12)
+#define BPMSG1053 bp_message_write_line(1114, 9)
+#define BPMSG1054 bp_message_write_buffer(1123, 7)
+#define BPMSG1055 bp_message_write_line(1130, 4)
+#define BPMSG1056 bp_message_write_buffer(1134, 15)
+#define BPMSG1057 bp_message_write_line(1149, 12)
+#define BPMSG1058 bp_message_write_buffer(1161, 18)
+#define BPMSG1059 bp_message_write_line(1179, 33)
+#define BPMSG1060 bp_message_write_buffer(1212, 3)
+#define BPMSG1061 bp_message_write_buffer(1215, 4)
+#define BPMSG1062 bp_message_write_line(1219, 13)
+#define BPMSG1063 bp_message_write_line(1232, 12)
+#define BPMSG1064 bp_message_write_line(1244, 37)
+#define BPMSG1065 bp_message_write_line(1281, 59)
+#define BPMSG1066 bp_message_write_buffer(1340, 53)
+#define BPMSG1067 bp_message_write_buffer(1393, 44)
+#define BPMSG1068 bp_message_write_buffer(1437, 16)
+#define BPMSG1069 bp_message_write_buffer(1453, 53)
+#define BPMSG1070 bp_message_write_line(1506, 46)
+#define BPMSG1071 bp_message_write_line(1552, 7)
+#define BPMSG1084 bp_message_write_buffer(1559, 7)
+#define BPMSG1085 bp_message_write_line(1566, 5)
+#define BPMSG1086 bp_message_write_line(1571, 22)
+#define BPMSG1087 bp_message_write_line(1593, 21)
+#define BPMSG1088 bp_message_write_line(1614, 29)
+#define BPMSG1089 bp_message_write_buffer(1643, 21)
+#define BPMSG1091 bp_message_write_buffer(1664, 20)
+#define BPMSG1092 bp_message_write_line(1684, 26)
+#define BPMSG1093 bp_message_write_line(1710, 5)
+#define BPMSG1094 bp_message_write_line(1715, 10)
+#define BPMSG1095 bp_message_write_buffer(1725, 22)
+#define BPMSG1096 bp_message_write_buffer(1747, 17)
+#define BPMSG1097 bp_message_write_buffer(1764, 18)
+#define BPMSG1098 bp_message_write_buffer(1782, 12)
+#define BPMSG1099 bp_message_write_buffer(1794, 6)
+#define BPMSG1100 bp_message_write_line(1800, 2)
+#define BPMSG1101 bp_message_write_buffer(1802, 7)
+#define BPMSG1102 bp_message_write_buffer(1809, 6)
+#define BPMSG1103 bp_message_write_line(1815, 8)
+#define BPMSG1104 bp_message_write_line(1823, 8)
+#define BPMSG1105 bp_message_write_line(1831, 14)
+#define BPMSG1106 bp_message_write_line(1845, 14)
+#define BPMSG1107 bp_message_write_line(1859, 16)
+#define BPMSG1108 bp_message_write_buffer(1875, 13)
+#define BPMSG1109 bp_message_write_buffer(1888, 10)
+#define BPMSG1110 bp_message_write_buffer(1898, 21)
+#define BPMSG1111 bp_message_write_line(1919, 23)
+#define BPMSG1112 bp_message_write_line(1942, 14)
+#define BPMSG1113 bp_message_write_line(1956, 49)
+#define BPMSG1114 bp_message_write_line(2005, 21)
+#define BPMSG1115 bp_message_write_line(2026, 7)
+#define BPMSG1116 bp_message_write_line(2033, 27)
+#define BPMSG1117 bp_message_write_buffer(2060, 6)
+#define BPMSG1118 bp_message_write_line(2066, 30)
+#define BPMSG1119 bp_message_write_line(2096, 12)
+#define BPMSG1120 bp_message_write_line(2108, 34)
+#define BPMSG1121 bp_message_write_line(2142, 30)
+#define BPMSG1123 bp_message_write_buffer(2172, 27)
+#define BPMSG1124 bp_message_write_buffer(2199, 28)
+#define BPMSG1126 bp_message_write_buffer(2227, 13)
+#define BPMSG1127 bp_message_write_line(2240, 34)
+#define BPMSG1128 bp_message_write_line(2274, 18)
+#define BPMSG1129 bp_message_write_line(2292, 18)
+#define BPMSG1130 bp_message_write_buffer(2310, 4)
+#define BPMSG1131 bp_message_write_buffer(2314, 9)
+#define BPMSG1132 bp_message_write_buffer(2323, 12)
+#define BPMSG1133 bp_message_write_line(2335, 141)
+#define BPMSG1134 bp_message_write_line(2476, 20)
+#define BPMSG1135 bp_message_write_buffer(2496, 14)
+#define BPMSG1136 bp_message_write_buffer(2510, 5)
+#define BPMSG1137 bp_message_write_buffer(2515, 6)
+#define BPMSG1138 bp_message_write_buffer(2521, 8)
+#define BPMSG1140 bp_message_write_buffer(2529, 6)
+#define BPMSG1142 bp_message_write_line(2535, 79)
+#define BPMSG1143 bp_message_write_buffer(2614, 16)
+#define BPMSG1144 bp_message_write_buffer(2630, 56)
+#define BPMSG1145 bp_message_write_line(2686, 63)
+#define BPMSG1146 bp_message_write_buffer(2749, 45)
+#define BPMSG1147 bp_message_write_buffer(2794, 10)
+#define BPMSG1148 bp_message_write_buffer(2804, 6)
+#define BPMSG1149 bp_message_write_buffer(2810, 6)
+#define BPMSG1150 bp_message_write_buffer(2816, 6)
+#define BPMSG1151 bp_message_write_buffer(2822, 3)
+#define BPMSG1152 bp_message_write_buffer(2825, 7)
+#define BPMSG1153 bp_message_write_buffer(2832, 11)
+#define BPMSG1154 bp_message_write_buffer(2843, 6)
+#define BPMSG1155 bp_message_write_buffer(2849, 15)
+#define BPMSG1156 bp_message_write_buffer(2864, 12)
+#define BPMSG1157 bp_message_write_buffer(2876, 13)
+#define BPMSG1158 bp_message_write_buffer(2889, 25)
+#define BPMSG1159 bp_message_write_line(2914, 10)
+#define BPMSG1160 bp_message_write_line(2924, 11)
+#define BPMSG1161 bp_message_write_buffer(2935, 20)
+#define BPMSG1162 bp_message_write_buffer(2955, 3)
+#define BPMSG1163 bp_message_write_line(2958, 63)
+#define BPMSG1164 bp_message_write_line(3021, 4)
+#define BPMSG1165 bp_message_write_buffer(3025, 3)
+#define BPMSG1166 bp_message_write_buffer(3028, 8)
+#define BPMSG1167 bp_message_write_buffer(3036, 8)
+#define BPMSG1168 bp_message_write_buffer(3044, 8)
+#define BPMSG1169 bp_message_write_buffer(3052, 4)
+#define BPMSG1170 bp_message_write_line(3056, 14)
+#define BPMSG1171 bp_message_write_buffer(3070, 2)
+#define BPMSG1172 bp_message_write_buffer(3072, 3)
+#define BPMSG1173 bp_message_write_buffer(3075, 4)
+#define BPMSG1174 bp_message_write_buffer(3079, 3)
+#define BPMSG1175 bp_message_write_line(3082, 8)
+#define BPMSG1176 bp_message_write_line(3090, 10)
+#define BPMSG1177 bp_message_write_line(3100, 10)
+#define BPMSG1178 bp_message_write_line(3110, 32)
+#define BPMSG1179 bp_message_write_buffer(3142, 6)
+#define BPMSG1180 bp_message_write_line(3148, 8)
+#define BPMSG1181 bp_message_write_buffer(3156, 4)
+#define BPMSG1182 bp_message_write_buffer(3160, 3)
+#define BPMSG1183 bp_message_write_buffer(3163, 4)
+#define BPMSG1184 bp_message_write_buffer(3167, 2)
+#define BPMSG1185 bp_message_write_line(3169, 3)
+#define BPMSG1186 bp_message_write_line(3172, 5)
+#define BPMSG1187 bp_message_write_line(3177, 55)
+#define BPMSG1188 bp_message_write_line(3232, 53)
+#define BPMSG1189 bp_message_write_line(3285, 67)
+#define BPMSG1190 bp_message_write_line(3352, 49)
+#define BPMSG1191 bp_message_write_buffer(3401, 32)
+#define BPMSG1192 bp_message_write_line(3433, 52)
+#define BPMSG1194 bp_message_write_buffer(3485, 3)
+#define BPMSG1195 bp_message_write_buffer(3488, 3)
+#define BPMSG1196 bp_message_write_buffer(3491, 15)
+#define BPMSG1197 bp_message_write_buffer(3506, 15)
+#define BPMSG1199 bp_message_write_buffer(3521, 84)
+#define BPMSG1200 bp_message_write_buffer(3605, 33)
+#define BPMSG1201 bp_message_write_buffer(3638, 50)
+#define BPMSG1202 bp_message_write_buffer(3688, 32)
+#define BPMSG1203 bp_message_write_buffer(3720, 106)
+#define BPMSG1204 bp_message_write_line(3826, 11)
+#define BPMSG1205 bp_message_write_line(3837, 13)
+#define BPMSG1206 bp_message_write_line(3850, 14)
+#define BPMSG1207 bp_message_write_line(3864, 28)
+#define BPMSG1208 bp_message_write_line(3892, 20)
+#define BPMSG1209 bp_message_write_line(3912, 34)
+#define BPMSG1210 bp_message_write_buffer(3946, 7)
+#define BPMSG1211 bp_message_write_line(3953, 27)
+#define BPMSG1212 bp_message_write_line(3980, 2)
+#define BPMSG1213 bp_message_write_line(3982, 20)
+#define BPMSG1214 bp_message_write_line(4002, 18)
+#define BPMSG1215 bp_message_write_line(4020, 19)
+#define BPMSG1216 bp_message_write_line(4039, 29)
+#define BPMSG1217 bp_message_write_line(4068, 50)
+#define BPMSG1218 bp_message_write_buffer(4118, 19)
+#define BPMSG1219 bp_message_write_line(4137, 152)
+#define BPMSG1220 bp_message_write_line(4289, 36)
+#define BPMSG1221 bp_message_write_line(4325, 4)
+#define BPMSG1222 bp_message_write_line(4329, 5)
+#define BPMSG1223 bp_message_write_line(4334, 10)
+#define BPMSG1224 bp_message_write_line(4344, 21)
+#define BPMSG1225 bp_message_write_line(4365, 16)
+#define BPMSG1226 bp_message_write_line(4381, 10)
+#define BPMSG1227 bp_message_write_buffer(4391, 26)
+#define BPMSG1228 bp_message_write_buffer(4417, 10)
+#define BPMSG1229 bp_message_write_line(4427, 9)
+#define BPMSG1230 bp_message_write_line(4436, 11)
+#define BPMSG1231 bp_message_write_line(4447, 11)
+#define BPMSG1232 bp_message_write_line(4458, 11)
+#define BPMSG1233 bp_message_write_line(4469, 70)
+#define BPMSG1234 bp_message_write_buffer(4539, 4)
+#define BPMSG1235 bp_message_write_buffer(4543, 26)
+#define BPMSG1236 bp_message_write_buffer(4569, 10)
+#define BPMSG1245 bp_message_write_buffer(4579, 11)
+#define BPMSG1246 bp_message_write_buffer(4590, 5)
+#define BPMSG1247 bp_message_write_buffer(4595, 5)
+#define BPMSG1248 bp_message_write_line(4600, 28)
+#define BPMSG1249 bp_message_write_line(4628, 32)
+#define BPMSG1250 bp_message_write_line(4660, 15)
+#define BPMSG1251 bp_message_write_line(4675, 17)
+#define BPMSG1252 bp_message_write_buffer(4692, 27)
+#define BPMSG1253 bp_message_write_line(4719, 29)
+#define BPMSG1254 bp_message_write_line(4748, 19)
+#define BPMSG1255 bp_message_write_line(4767, 12)
+#define BPMSG1280 bp_message_write_line(4779, 19)
+#define BPMSG1281 bp_message_write_line(4798, 14)
+#define BPMSG1282 bp_message_write_line(4812, 47)
+#define BPMSG1283 bp_message_write_buffer(4859, 15)
+#define BPMSG1284 bp_message_write_buffer(4874, 15)
+#define BPMSG1285 bp_message_write_line(4889, 4)
+#define BPMSG1286 bp_message_write_line(4893, 20)
+#define BPMSG1287 bp_message_write_line(4913, 33)
+#define BPMSG1288 bp_message_write_line(4946, 25)
+#define BPMSG1289 bp_message_write_line(4971, 26)
+#define BPMSG1290 bp_message_write_line(4997, 14)
+#define HLP1000 bp_message_write_line(5011, 33)
+#define HLP1001 bp_message_write_line(5044, 76)
+#define HLP1002 bp_message_write_line(5120, 38)
+#define HLP1003 bp_message_write_line(5158, 40)
+#define HLP1004 bp_message_write_line(5198, 21)
+#define HLP1005 bp_message_write_line(5219, 27)
+#define HLP1006 bp_message_write_line(5246, 40)
+#define HLP1007 bp_message_write_line(5286, 27)
+#define HLP1008 bp_message_write_line(5313, 46)
+#define HLP1009 bp_message_write_line(5359, 21)
+#define HLP1010 bp_message_write_line(5380, 35)
+#define HLP1011 bp_message_write_line(5415, 46)
+#define HLP1012 bp_message_write_line(5461, 28)
+#define HLP1013 bp_message_write_line(5489, 33)
+#define HLP1014 bp_message_write_line(5522, 28)
+#define HLP1015 bp_message_write_line(5550, 37)
+#define HLP1016 bp_message_write_line(5587, 33)
+#define HLP1017 bp_message_write_line(5620, 25)
+#define HLP1018 bp_message_write_line(5645, 31)
+#define HLP1019 bp_message_write_line(5676, 41)
+#define HLP1020 bp_message_write_line(5717, 37)
+#define HLP1021 bp_message_write_line(5754, 54)
+#define HLP1022 bp_message_write_line(5808, 62)
 
 #endif /* BP_MESSAGES_V3_H */
@@ -24,7 +24,7 @@ _bp_messages:
 	.pascii "\r\n   *"
 
 	; BPMSG1009
-	.pascii "1WIRE ROM COMMAND MACROs:\r\n 51.READ ROM (0x33) *for single device bus\r\n 85.MATCH ROM (0x55) *followed by 64bit address\r\n 204.SKIP ROM (0xCC) *followed by command\r\n 236.ALARM SEARCH (0xEC)\r\n 240.SEARCH ROM (0xF0)"
+	.pascii "1WIRE ROM COMMAND MACROs:\r\n 51.READ ROM (0x33) *for single device bus\r\n 60.OVERDRIVE SKIP ROM (0x3C) *then overdrive timing\r\n 83.STANDARD SPEED *reset and back to standard timing\r\n 85.MATCH ROM (0x55) *followed by 64bit address\r\n 105.OVERDRIVE MATCH ROM (0x69) *followed by 64bit address\r\n 204.SKIP ROM (0xCC) *followed by command\r\n 236.ALARM SEARCH (0xEC)\r\n 240.SEARCH ROM (0xF0)"
 
 	; BPMSG1010
 	.pascii "ALARM SEARCH (0xEC)"
@@ -177,7 +177,7 @@ _bp_messages:
 	.pascii "I2C mode:\r\n 1. Software\r\n 2. Hardware"
 
 	; BPMSG1065
-	.pascii "Set speed:\r\n 1. ~5KHz\r\n 2. ~50KHz\r\n 3. ~100KHz\r\n 4. ~400KHz"
+	.pascii "Set speed:\r\n 1. ~5KHz\r\n 2. ~50KHz\r\n 3. ~100KHz\r\n 4. ~150KHz"
 
 	; BPMSG1066
 	.pascii "WARNING: HARDWARE I2C is broken on this PIC! (REV A3)"
@@ -686,6 +686,21 @@ _bp_messages:
 	; BPMSG1285
 	.pascii " bps"
 
+	; BPMSG1286
+	.pascii "EEPROM write timeout"
+
+	; BPMSG1287
+	.pascii " 5. ~1.6MHz (normal outputs only)"
+
+	; BPMSG1288
+	.pascii "OVERDRIVE SKIP ROM (0x3C)"
+
+	; BPMSG1289
+	.pascii "OVERDRIVE MATCH ROM (0x69)"
+
+	; BPMSG1290
+	.pascii "STANDARD SPEED"
+
 	; HLP1000
 	.pascii " General\t\t\t\t\tProtocol interaction"
 
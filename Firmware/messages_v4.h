@@ -8,289 +8,294 @@
 #define BPMSG1006 bp_message_write_line(102, 13)
 #define BPMSG1007 bp_message_write_line(115, 23)
 #define BPMSG1008 bp_message_write_buffer(138, 6)
-#define BPMSG1009 bp_message_write_line(144, 211)
-#define BPMSG1010 bp_message_write_line(355, 19)
-#define BPMSG1011 bp_message_write_line(374, 13)
-#define BPMSG1012 bp_message_write_line(387, 43)
-#define BPMSG1013 bp_message_write_buffer(430, 17)
-#define BPMSG1014 bp_message_write_line(447, 16)
-#define BPMSG1015 bp_message_write_line(463, 15)
-#define BPMSG1016 bp_message_write_line(478, 36)
-#define BPMSG1017 bp_message_write_buffer(514, 10)
-#define BPMSG1019 bp_message_write_buffer(524, 9)
-#define BPMSG1020 bp_message_write_buffer(533, 21)
-#define BPMSG1021 bp_message_write_buffer(554, 20)
-#define BPMSG1022 bp_message_write_line(574, 27)
-#define BPMSG1023 bp_message_write_line(601, 26)
-#define BPMSG1024 bp_message_write_line(627, 21)
-#define BPMSG1025 bp_message_write_line(648, 24)
-#define BPMSG1026 bp_message_write_line(672, 16)
-#define BPMSG1027 bp_message_write_buffer(688, 14)
-#define BPMSG1028 bp_message_write_line(702, 12)
-#define BPMSG1029 bp_message_write_line(714, 17)
-#define BPMSG1030 bp_message_write_buffer(731, 17)
-#define BPMSG1031 bp_message_write_buffer(748, 9)
-#define BPMSG1032 bp_message_write_buffer(757, 4)
-#define BPMSG1033 bp_message_write_buffer(761, 16)
-#define BPMSG1034 bp_message_write_line(777, 10)
-#define BPMSG1037 bp_message_write_line(787, 31)
-#define BPMSG1038 bp_message_write_buffer(818, 15)
-#define BPMSG1039 bp_message_write_buffer(833, 14)
-#define BPMSG1040 bp_message_write_line(847, 8)
-#define BPMSG1041 bp_message_write_line(855, 7)
-#define BPMSG1042 bp_message_write_line(862, 14)
-#define BPMSG1044 bp_message_write_buffer(876, 15)
-#define BPMSG1045 bp_message_write_buffer(891, 1)
-#define BPMSG1047 bp_message_write_buffer(892, 6)
-#define BPMSG1048 bp_message_write_buffer(898, 8)
-#define BPMSG1049 bp_message_write_buffer(906, 11)
-#define BPMSG1050 bp_message_write_line(917, 7)
-#define BPMSG1051 bp_message_write_line(924, 9)
-#define BPMSG1052 bp_message_write_line(933, 12)
-#define BPMSG1053 bp_message_write_line(945, 9)
-#define BPMSG1054 bp_message_write_buffer(954, 7)
-#define BPMSG1055 bp_message_write_line(961, 4)
-#define BPMSG1056 bp_message_write_buffer(965, 15)
-#define BPMSG1057 bp_message_write_line(980, 12)
-#define BPMSG1058 bp_message_write_buffer(992, 18)
-#define BPMSG1059 bp_message_write_line(1010, 33)
-#define BPMSG1060 bp_message_write_buffer(1043, 3)
-#define BPMSG1061 bp_message_write_buffer(1046, 4)
-#define BPMSG1062 bp_message_write_line(1050, 13)
-#define BPMSG1063 bp_message_write_line(1063, 12)
-#define BPMSG1064 bp_message_write_line(1075, 37)
-#define BPMSG1065 bp_message_write_line(1112, 59)
-#define BPMSG1066 bp_message_write_buffer(1171, 53)
-#define BPMSG1067 bp_message_write_buffer(1224, 44)
-#define BPMSG1068 bp_message_write_buffer(1268, 16)
-#define BPMSG1069 bp_message_write_buffer(1284, 123)
-#define BPMSG1070 bp_message_write_line(1407, 46)
-#define BPMSG1071 bp_message_write_line(1453, 7)
-#define BPMSG1072 bp_message_write_line(1460, 34)
-#define BPMSG1073 bp_message_write_line(1494, 6)
-#define BPMSG1074 bp_message_write_buffer(1500, 14)
-#define BPMSG1075 bp_message_write_buffer(1514, 3)
-#define BPMSG1076 bp_message_write_line(1517, 3)
-#define BPMSG1077 bp_message_write_line(1520, 7)
-#define BPMSG1078 bp_message_write_line(1527, 12)
-#define BPMSG1079 bp_message_write_line(1539, 13)
-#define BPMSG1080 bp_message_write_buffer(1552, 8)
-#define BPMSG1081 bp_message_write_buffer(1560, 7)
-#define BPMSG1082 bp_message_write_line(1567, 21)
-#define BPMSG1083 bp_message_write_line(1588, 32)
-#define BPMSG1084 bp_message_write_buffer(1620, 7)
-#define BPMSG1085 bp_message_write_line(1627, 5)
-#define BPMSG1086 bp_message_write_line(1632, 22)
-#define BPMSG1087 bp_message_write_line(1654, 21)
-#define BPMSG1088 bp_message_write_line(1675, 29)
-#define BPMSG1089 bp_message_write_buffer(1704, 21)
-#define BPMSG1091 bp_message_write_buffer(1725, 20)
-#define BPMSG1092 bp_message_write_line(1745, 26)
-#define BPMSG1093 bp_message_write_line(1771, 5)
-#define BPMSG1094 bp_message_write_line(1776, 10)
-#define BPMSG1095 bp_message_write_buffer(1786, 22)
-#define BPMSG1096 bp_message_write_buffer(1808, 17)
-#define BPMSG1097 bp_message_write_buffer(1825, 18)
-#define BPMSG1098 bp_message_write_buffer(1843, 12)
-#define BPMSG1099 bp_message_write_buffer(1855, 6)
-#define BPMSG1100 bp_message_write_line(1861, 2)
-#define BPMSG1101 bp_message_write_buffer(1863, 7)
-#define BPMSG1102 bp_message_write_buffer(1870, 6)
-#define BPMSG1103 bp_message_write_line(1876, 8)
-#define BPMSG1104 bp_message_write_line(1884, 8)
-#define BPMSG1105 bp_message_write_line(1892, 14)
-#define BPMSG1106 bp_message_write_line(1906, 14)
-#define BPMSG1107 bp_message_write_line(1920, 16)
-#define BPMSG1108 bp_message_write_buffer(1936, 13)
-#define BPMSG1109 bp_message_write_buffer(1949, 10)
-#define BPMSG1110 bp_message_write_buffer(1959, 21)
-#define BPMSG1111 bp_message_write_line(1980, 23)
-#define BPMSG1112 bp_message_write_line(2003, 14)
-#define BPMSG1113 bp_message_write_line(2017, 49)
-#define BPMSG1114 bp_message_write_line(2066, 21)
-#define BPMSG1115 bp_message_write_line(2087, 7)
-#define BPMSG1116 bp_message_write_line(2094, 27)
-#define BPMSG1117 bp_message_write_buffer(2121, 6)
-#define BPMSG1118 bp_message_write_line(2127, 30)
-#define BPMSG1119 bp_message_write_line(2157, 12)
-#define BPMSG1120 bp_message_write_line(2169, 34)
-#define BPMSG1121 bp_message_write_line(2203, 30)
-#define BPMSG1123 bp_message_write_buffer(2233, 27)
-#define BPMSG1124 bp_message_write_buffer(2260, 28)
-#define BPMSG1126 bp_message_write_buffer(2288, 13)
-#define BPMSG1127 bp_message_write_line(2301, 34)
-#define BPMSG1128 bp_message_write_line(2335, 18)
-#define BPMSG1129 bp_message_write_line(2353, 18)
-#define BPMSG1130 bp_message_write_buffer(2371, 4)
-#define BPMSG1131 bp_message_write_buffer(2375, 9)
-#define BPMSG1132 bp_message_write_buffer(2384, 12)
-#define BPMSG1133 bp_message_write_line(2396, 190)
-#define BPMSG1134 bp_message_write_line(2586, 20)
-#define BPMSG1135 bp_message_write_buffer(2606, 14)
-#define BPMSG1136 bp_message_write_buffer(2620, 5)
-#define BPMSG1137 bp_message_write_buffer(2625, 6)
-#define BPMSG1138 bp_message_write_buffer(2631, 8)
-#define BPMSG1140 bp_message_write_buffer(2639, 6)
-#define BPMSG1142 bp_message_write_line(2645, 79)
-#define BPMSG1143 bp_message_write_buffer(2724, 16)
-#define BPMSG1144 bp_message_write_buffer(2740, 56)
-#define BPMSG1145 bp_message_write_line(2796, 63)
-#define BPMSG1146 bp_message_write_buffer(2859, 45)
-#define BPMSG1147 bp_message_write_buffer(2904, 10)
-#define BPMSG1148 bp_message_write_buffer(2914, 6)
-#define BPMSG1149 bp_message_write_buffer(2920, 6)
-#define BPMSG1150 bp_message_write_buffer(2926, 6)
-#define BPMSG1151 bp_message_write_buffer(2932, 3)
-#define BPMSG1152 bp_message_write_buffer(2935, 7)
-#define BPMSG1153 bp_message_write_buffer(2942, 11)
-#define BPMSG1154 bp_message_write_buffer(2953, 6)
-#define BPMSG1155 bp_message_write_buffer(2959, 15)
-#define BPMSG1156 bp_message_write_buffer(2974, 12)
-#define BPMSG1157 bp_message_write_buffer(2986, 13)
-#define BPMSG1158 bp_message_write_buffer(2999, 25)
-#define BPMSG1159 bp_message_write_line(3024, 10)
-#define BPMSG1160 bp_message_write_line(3034, 11)
-#define BPMSG1161 bp_message_write_buffer(3045, 20)
-#define BPMSG1162 bp_message_write_buffer(3065, 3)
-#define BPMSG1163 bp_message_write_line(3068, 46)
-#define BPMSG1164 bp_message_write_line(3114, 4)
-#define BPMSG1165 bp_message_write_buffer(3118, 3)
-#define BPMSG1166 bp_message_write_buffer(3121, 8)
-#define BPMSG1167 bp_message_write_buffer(3129, 8)
-#define BPMSG1168 bp_message_write_buffer(3137, 8)
-#define BPMSG1169 bp_message_write_buffer(3145, 4)
-#define BPMSG1170 bp_message_write_line(3149, 14)
-#define BPMSG1171 bp_message_write_buffer(3163, 2)
-#define BPMSG1172 bp_message_write_buffer(3165, 3)
-#define BPMSG1173 bp_message_write_buffer(3168, 4)
-#define BPMSG1174 bp_message_write_buffer(3172, 3)
-#define BPMSG1175 bp_message_write_line(3175, 8)
-#define BPMSG1176 bp_message_write_line(3183, 10)
-#define BPMSG1177 bp_message_write_line(3193, 10)
-#define BPMSG1178 bp_message_write_line(3203, 38)
-#define BPMSG1179 bp_message_write_buffer(3241, 6)
-#define BPMSG1180 bp_message_write_line(3247, 8)
-#define BPMSG1181 bp_message_write_buffer(3255, 4)
-#define BPMSG1182 bp_message_write_buffer(3259, 3)
-#define BPMSG1183 bp_message_write_buffer(3262, 4)
-#define BPMSG1184 bp_message_write_buffer(3266, 2)
-#define BPMSG1185 bp_message_write_line(3268, 3)
-#define BPMSG1186 bp_message_write_line(3271, 5)
-#define BPMSG1187 bp_message_write_line(3276, 55)
-#define BPMSG1188 bp_message_write_line(3331, 53)
-#define BPMSG1189 bp_message_write_line(3384, 67)
-#define BPMSG1190 bp_message_write_line(3451, 49)
-#define BPMSG1191 bp_message_write_buffer(3500, 32)
-#define BPMSG1192 bp_message_write_line(3532, 52)
-#define BPMSG1194 bp_message_write_buffer(3584, 3)
-#define BPMSG1195 bp_message_write_buffer(3587, 3)
-#define BPMSG1196 bp_message_write_buffer(3590, 15)
-#define BPMSG1197 bp_message_write_buffer(3605, 15)
-#define BPMSG1199 bp_message_write_buffer(3620, 84)
-#define BPMSG1200 bp_message_write_buffer(3704, 33)
-#define BPMSG1201 bp_message_write_buffer(3737, 50)
-#define BPMSG1202 bp_message_write_buffer(3787, 32)
-#define BPMSG1203 bp_message_write_buffer(3819, 124)
-#define BPMSG1204 bp_message_write_line(3943, 11)
-#define BPMSG1205 bp_message_write_line(3954, 13)
-#define BPMSG1206 bp_message_write_line(3967, 14)
-#define BPMSG1207 bp_message_write_line(3981, 28)
-#define BPMSG1208 bp_message_write_line(4009, 20)
-#define BPMSG1209 bp_message_write_line(4029, 34)
-#define BPMSG1210 bp_message_write_buffer(4063, 7)
-#define BPMSG1211 bp_message_write_line(4070, 27)
-#define BPMSG1212 bp_message_write_line(4097, 2)
-#define BPMSG1213 bp_message_write_line(4099, 20)
-#define BPMSG1214 bp_message_write_line(4119, 18)
-#define BPMSG1215 bp_message_write_line(4137, 19)
-#define BPMSG1216 bp_message_write_line(4156, 29)
-#define BPMSG1217 bp_message_write_line(4185, 50)
-#define BPMSG1218 bp_message_write_buffer(4235, 19)
-#define BPMSG1219 bp_message_write_line(4254, 152)
-#define BPMSG1220 bp_message_write_line(4406, 36)
-#define BPMSG1221 bp_message_write_line(4442, 4)
-#define BPMSG1222 bp_message_write_line(4446, 5)
-#define BPMSG1223 bp_message_write_line(4451, 10)
-#define BPMSG1224 bp_message_write_line(4461, 21)
-#define BPMSG1225 bp_message_write_line(4482, 16)
-#define BPMSG1226 bp_message_write_line(4498, 10)
-#define BPMSG1227 bp_message_write_buffer(4508, 26)
-#define BPMSG1228 bp_message_write_buffer(4534, 10)
-#define BPMSG1229 bp_message_write_line(4544, 9)
-#define BPMSG1230 bp_message_write_line(4553, 11)
-#define BPMSG1231 bp_message_write_line(4564, 11)
-#define BPMSG1232 bp_message_write_line(4575, 11)
-#define BPMSG1233 bp_message_write_line(4586, 70)
-#define BPMSG1234 bp_message_write_buffer(4656, 4)
-#define BPMSG1235 bp_message_write_buffer(4660, 26)
-#define BPMSG1236 bp_message_write_buffer(4686, 10)
-#define BPMSG1237 bp_message_write_buffer(4696, 8)
-#define BPMSG1238 bp_message_write_line(4704, 38)
-#define BPMSG1239 bp_message_write_line(4742, 28)
-#define BPMSG1240 bp_message_write_line(4770, 16)
-#define BPMSG1241 bp_message_write_line(4786, 14)
-#define BPMSG1242 bp_message_write_line(4800, 15)
-#define BPMSG1243 bp_message_write_line(4815, 5)
-#define BPMSG1244 bp_message_write_line(4820, 14)
-#define BPMSG1245 bp_message_write_buffer(4834, 11)
-#define BPMSG1246 bp_message_write_buffer(4845, 5)
-#define BPMSG1247 bp_message_write_buffer(4850, 5)
-#define BPMSG1248 bp_message_write_line(4855, 25)
-#define BPMSG1249 bp_message_write_line(4880, 32)
-#define BPMSG1250 bp_message_write_line(4912, 15)
-#define BPMSG1251 bp_message_write_line(4927, 17)
-#define BPMSG1252 bp_message_write_buffer(4944, 27)
-#define BPMSG1253 bp_message_write_line(4971, 29)
-#define BPMSG1254 bp_message_write_line(5000, 19)
-#define BPMSG1255 bp_message_write_line(5019, 12)
-#define BPMSG1256 bp_message_write_line(5031, 86)
-#define BPMSG1257 bp_message_write_buffer(5117, 36)
-#define BPMSG1258 bp_message_write_line(5153, 16)
-#define BPMSG1259 bp_message_write_line(5169, 9)
-#define BPMSG1260 bp_message_write_line(5178, 11)
-#define BPMSG1261 bp_message_write_line(5189, 11)
-#define BPMSG1262 bp_message_write_line(5200, 11)
-#define BPMSG1263 bp_message_write_line(5211, 23)
-#define BPMSG1264 bp_message_write_line(5234, 23)
-#define BPMSG1265 bp_message_write_line(5257, 6)
-#define BPMSG1266 bp_message_write_buffer(5263, 3)
-#define BPMSG1267 bp_message_write_buffer(5266, 3)
-#define BPMSG1268 bp_message_write_buffer(5269, 2)
-#define BPMSG1269 bp_message_write_buffer(5271, 10)
-#define BPMSG1270 bp_message_write_buffer(5281, 4)
-#define BPMSG1271 bp_message_write_line(5285, 87)
-#define BPMSG1272 bp_message_write_buffer(5372, 25)
-#define BPMSG1273 bp_message_write_line(5397, 7)
-#define BPMSG1274 bp_message_write_line(5404, 8)
-#define BPMSG1278 bp_message_write_line(5412, 14)
-#define BPMSG1280 bp_message_write_line(5426, 19)
-#define BPMSG1281 bp_message_write_line(5445, 14)
-#define BPMSG1282 bp_message_write_line(5459, 56)
-#define BPMSG1283 bp_message_write_buffer(5515, 15)
-#define BPMSG1284 bp_message_write_buffer(5530, 15)
-#define BPMSG1285 bp_message_write_line(5545, 4)
-#define HLP1000 bp_message_write_line(5549, 32)
-#define HLP1001 bp_message_write_line(5581, 75)
-#define HLP1002 bp_message_write_line(5656, 37)
-#define HLP1003 bp_message_write_line(5693, 39)
-#define HLP1004 bp_message_write_line(5732, 20)
-#define HLP1005 bp_message_write_line(5752, 26)
-#define HLP1006 bp_message_write_line(5778, 39)
-#define HLP1007 bp_message_write_line(5817, 26)
-#define HLP1008 bp_message_write_line(5843, 45)
-#define HLP1009 bp_message_write_line(5888, 39)
-#define HLP1010 bp_message_write_line(5927, 57)
-#define HLP1011 bp_message_write_line(5984, 52)
-#define HLP1012 bp_message_write_line(6036, 27)
-#define HLP1013 bp_message_write_line(6063, 32)
-#define HLP1014 bp_message_write_line(6095, 27)
-#define HLP1015 bp_message_write_line(6122, 36)
-#define HLP1016 bp_message_write_line(6158, 32)
-#define HLP1017 bp_message_write_line(6190, 24)
-#define HLP1018 bp_message_write_line(6214, 31)
-#define HLP1019 bp_message_write_line(6245, 40)
-#define HLP1020 bp_message_write_line(6285, 36)
-#define HLP1021 bp_message_write_line(6321, 53)
-#define HLP1022 bp_message_write_line(6374, 61)
+#define BPMSG1009 bp_message_write_line(144, 380)
+#define BPMSG1010 bp_message_write_line(524, 19)
+#define BPMSG1011 bp_message_write_line(543, 13)
+#define BPMSG1012 bp_message_write_line(556, 43)
+#define BPMSG1013 bp_message_write_buffer(599, 17)
+#define BPMSG1014 bp_message_write_line(616, 16)
+#define BPMSG1015 bp_message_write_line(632, 15)
+#define BPMSG1016 bp_message_write_line(647, 36)
+#define BPMSG1017 bp_message_write_buffer(683, 10)
+#define BPMSG1019 bp_message_write_buffer(693, 9)
+#define BPMSG1020 bp_message_write_buffer(702, 21)
+#define BPMSG1021 bp_message_write_buffer(723, 20)
+#define BPMSG1022 bp_message_write_line(743, 27)
+#define BPMSG1023 bp_message_write_line(770, 26)
+#define BPMSG1024 bp_message_write_line(796, 21)
+#define BPMSG1025 bp_message_write_line(817, 24)
+#define BPMSG1026 bp_message_write_line(841, 16)
+#define BPMSG1027 bp_message_write_buffer(857, 14)
+#define BPMSG1028 bp_message_write_line(871, 12)
+#define BPMSG1029 bp_message_write_line(883, 17)
+#define BPMSG1030 bp_message_write_buffer(900, 17)
+#define BPMSG1031 bp_message_write_buffer(917, 9)
+#define BPMSG1032 bp_message_write_buffer(926, 4)
+#define BPMSG1033 bp_message_write_buffer(930, 16)
+#define BPMSG1034 bp_message_write_line(946, 10)
+#define BPMSG1037 bp_message_write_line(956, 31)
+#define BPMSG1038 bp_message_write_buffer(987, 15)
+#define BPMSG1039 bp_message_write_buffer(1002, 14)
+#define BPMSG1040 bp_message_write_line(1016, 8)
+#define BPMSG1041 bp_message_write_line(1024, 7)
+#define BPMSG1042 bp_message_write_line(1031, 14)
+#define BPMSG1044 bp_message_write_buffer(1045, 15)
+#define BPMSG1045 bp_message_write_buffer(1060, 1)
+#define BPMSG1047 bp_message_write_buffer(1061, 6)
+#define BPMSG1048 bp_message_write_buffer(1067, 8)
+#define BPMSG1049 bp_message_write_buffer(1075, 11)
+#define BPMSG1050 bp_message_write_line(1086, 7)
+#define BPMSG1051 bp_message_write_line(1093, 9)
+#define BPMSG1052 bp_message_write_line(1102, 12)
+#define BPMSG1053 bp_message_write_line(1114, 9)
+#define BPMSG1054 bp_message_write_buffer(1123, 7)
+#define BPMSG1055 bp_message_write_line(1130, 4)
+#define BPMSG1056 bp_message_write_buffer(1134, 15)
+#define BPMSG1057 bp_message_write_line(1149, 12)
+#define BPMSG1058 bp_message_write_buffer(1161, 18)
+#define BPMSG1059 bp_message_write_line(1179, 33)
+#define BPMSG1060 bp_message_write_buffer(1212, 3)
+#define BPMSG1061 bp_message_write_buffer(1215, 4)
+#define BPMSG1062 bp_message_write_line(1219, 13)
+#define BPMSG1063 bp_message_write_line(1232, 12)
+#define BPMSG1064 bp_message_write_line(1244, 37)
+#define BPMSG1065 bp_message_write_line(1281, 59)
+#define BPMSG1066 bp_message_write_buffer(1340, 53)
+#define BPMSG1067 bp_message_write_buffer(1393, 44)
+#define BPMSG1068 bp_message_write_buffer(1437, 16)
+#define BPMSG1069 bp_message_write_buffer(1453, 123)
+#define BPMSG1070 bp_message_write_line(1576, 46)
+#define BPMSG1071 bp_message_write_line(1622, 7)
+#define BPMSG1072 bp_message_write_line(1629, 34)
+#define BPMSG1073 bp_message_write_line(1663, 6)
+#define BPMSG1074 bp_message_write_buffer(1669, 14)
+#define BPMSG1075 bp_message_write_buffer(1683, 3)
+#define BPMSG1076 bp_message_write_line(1686, 3)
+#define BPMSG1077 bp_message_write_line(1689, 7)
+#define BPMSG1078 bp_message_write_line(1696, 12)
+#define BPMSG1079 bp_message_write_line(1708, 13)
+#define BPMSG1080 bp_message_write_buffer(1721, 8)
+#define BPMSG1081 bp_message_write_buffer(1729, 7)
+#define BPMSG1082 bp_message_write_line(1736, 21)
+#define BPMSG1083 bp_message_write_line(1757, 32)
+#define BPMSG1084 bp_message_write_buffer(1789, 7)
+#define BPMSG1085 bp_message_write_line(1796, 5)
+#define BPMSG1086 bp_message_write_line(1801, 22)
+#define BPMSG1087 bp_message_write_line(1823, 21)
+#define BPMSG1088 bp_message_write_line(1844, 29)
+#define BPMSG1089 bp_message_write_buffer(1873, 21)
+#define BPMSG1091 bp_message_write_buffer(1894, 20)
+#define BPMSG1092 bp_message_write_line(1914, 26)
+#define BPMSG1093 bp_message_write_line(1940, 5)
+#define BPMSG1094 bp_message_write_line(1945, 10)
+#define BPMSG1095 bp_message_write_buffer(1955, 22)
+#define BPMSG1096 bp_message_write_buffer(1977, 17)
+#define BPMSG1097 bp_message_write_buffer(1994, 18)
+#define BPMSG1098 bp_message_write_buffer(2012, 12)
+#define BPMSG1099 bp_message_write_buffer(2024, 6)
+#define BPMSG1100 bp_message_write_line(2030, 2)
+#define BPMSG1101 bp_message_write_buffer(2032, 7)
+#define BPMSG1102 bp_message_write_buffer(2039, 6)
+#define BPMSG1103 bp_message_write_line(2045, 8)
+#define BPMSG1104 bp_message_write_line(2053, 8)
+#define BPMSG1105 bp_message_write_line(2061, 14)
+#define BPMSG1106 bp_message_write_line(2075, 14)
+#define BPMSG1107 bp_message_write_line(2089, 16)
+#define BPMSG1108 bp_message_write_buffer(2105, 13)
+#define BPMSG1109 bp_message_write_buffer(2118, 10)
+#define BPMSG1110 bp_message_write_buffer(2128, 21)
+#define BPMSG1111 bp_message_write_line(2149, 23)
+#define BPMSG1112 bp_message_write_line(2172, 14)
+#define BPMSG1113 bp_message_write_line(2186, 49)
+#define BPMSG1114 bp_message_write_line(2235, 21)
+#define BPMSG1115 bp_message_write_line(2256, 7)
+#define BPMSG1116 bp_message_write_line(2263, 27)
+#define BPMSG1117 bp_message_write_buffer(2290, 6)
+#define BPMSG1118 bp_message_write_line(2296, 30)
+#define BPMSG1119 bp_message_write_line(2326, 12)
+#define BPMSG1120 bp_message_write_line(2338, 34)
+#define BPMSG1121 bp_message_write_line(2372, 30)
+#define BPMSG1123 bp_message_write_buffer(2402, 27)
+#define BPMSG1124 bp_message_write_buffer(2429, 28)
+#define BPMSG1126 bp_message_write_buffer(2457, 13)
+#define BPMSG1127 bp_message_write_line(2470, 34)
+#define BPMSG1128 bp_message_write_line(2504, 18)
+#define BPMSG1129 bp_message_write_line(2522, 18)
+#define BPMSG1130 bp_message_write_buffer(2540, 4)
+#define BPMSG1131 bp_message_write_buffer(2544, 9)
+#define BPMSG1132 bp_message_write_buffer(2553, 12)
+#define BPMSG1133 bp_message_write_line(2565, 190)
+#define BPMSG1134 bp_message_write_line(2755, 20)
+#define BPMSG1135 bp_message_write_buffer(2775, 14)
+#define BPMSG1136 bp_message_write_buffer(2789, 5)
+#define BPMSG1137 bp_message_write_buffer(2794, 6)
+#define BPMSG1138 bp_message_write_buffer(2800, 8)
+#define BPMSG1140 bp_message_write_buffer(2808, 6)
+#define BPMSG1142 bp_message_write_line(2814, 79)
+#define BPMSG1143 bp_message_write_buffer(2893, 16)
+#define BPMSG1144 bp_message_write_buffer(2909, 56)
+#define BPMSG1145 bp_message_write_line(2965, 63)
+#define BPMSG1146 bp_message_write_buffer(3028, 45)
+#define BPMSG1147 bp_message_write_buffer(3073, 10)
+#define BPMSG1148 bp_message_write_buffer(3083, 6)
+#define BPMSG1149 bp_message_write_buffer(3089, 6)
+#define BPMSG1150 bp_message_write_buffer(3095, 6)
+#define BPMSG1151 bp_message_write_buffer(3101, 3)
+#define BPMSG1152 bp_message_write_buffer(3104, 7)
+#define BPMSG1153 bp_message_write_buffer(3111, 11)
+#define BPMSG1154 bp_message_write_buffer(3122, 6)
+#define BPMSG1155 bp_message_write_buffer(3128, 15)
+#define BPMSG1156 bp_message_write_buffer(3143, 12)
+#define BPMSG1157 bp_message_write_buffer(3155, 13)
+#define BPMSG1158 bp_message_write_buffer(3168, 25)
+#define BPMSG1159 bp_message_write_line(3193, 10)
+#define BPMSG1160 bp_message_write_line(3203, 11)
+#define BPMSG1161 bp_message_write_buffer(3214, 20)
+#define BPMSG1162 bp_message_write_buffer(3234, 3)
+#define BPMSG1163 bp_message_write_line(3237, 46)
+#define BPMSG1164 bp_message_write_line(3283, 4)
+#define BPMSG1165 bp_message_write_buffer(3287, 3)
+#define BPMSG1166 bp_message_write_buffer(3290, 8)
+#define BPMSG1167 bp_message_write_buffer(3298, 8)
+#define BPMSG1168 bp_message_write_buffer(3306, 8)
+#define BPMSG1169 bp_message_write_buffer(3314, 4)
+#define BPMSG1170 bp_message_write_line(3318, 14)
+#define BPMSG1171 bp_message_write_buffer(3332, 2)
+#define BPMSG1172 bp_message_write_buffer(3334, 3)
+#define BPMSG1173 bp_message_write_buffer(3337, 4)
+#define BPMSG1174 bp_message_write_buffer(3341, 3)
+#define BPMSG1175 bp_message_write_line(3344, 8)
+#define BPMSG1176 bp_message_write_line(3352, 10)
+#define BPMSG1177 bp_message_write_line(3362, 10)
+#define BPMSG1178 bp_message_write_line(3372, 38)
+#define BPMSG1179 bp_message_write_buffer(3410, 6)
+#define BPMSG1180 bp_message_write_line(3416, 8)
+#define BPMSG1181 bp_message_write_buffer(3424, 4)
+#define BPMSG1182 bp_message_write_buffer(3428, 3)
+#define BPMSG1183 bp_message_write_buffer(3431, 4)
+#define BPMSG1184 bp_message_write_buffer(3435, 2)
+#define BPMSG1185 bp_message_write_line(3437, 3)
+#define BPMSG1186 bp_message_write_line(3440, 5)
+#define BPMSG1187 bp_message_write_line(3445, 55)
+#define BPMSG1188 bp_message_write_line(3500, 53)
+#define BPMSG1189 bp_message_write_line(3553, 67)
+#define BPMSG1190 bp_message_write_line(3620, 49)
+#define BPMSG1191 bp_message_write_buffer(3669, 32)
+#define BPMSG1192 bp_message_write_line(3701, 52)
+#define BPMSG1194 bp_message_write_buffer(3753, 3)
+#define BPMSG1195 bp_message_write_buffer(3756, 3)
+#define BPMSG1196 bp_message_write_buffer(3759, 15)
+#define BPMSG1197 bp_message_write_buffer(3774, 15)
+#define BPMSG1199 bp_message_write_buffer(3789, 84)
+#define BPMSG1200 bp_message_write_buffer(3873, 33)
+#define BPMSG1201 bp_message_write_buffer(3906, 50)
+#define BPMSG1202 bp_message_write_buffer(3956, 32)
+#define BPMSG1203 bp_message_write_buffer(3988, 124)
+#define BPMSG1204 bp_message_write_line(4112, 11)
+#define BPMSG1205 bp_message_write_line(4123, 13)
+#define BPMSG1206 bp_message_write_line(4136, 14)
+#define BPMSG1207 bp_message_write_line(4150, 28)
+#define BPMSG1208 bp_message_write_line(4178, 20)
+#define BPMSG1209 bp_message_write_line(4198, 34)
+#define BPMSG1210 bp_message_write_buffer(4232, 7)
+#define BPMSG1211 bp_message_write_line(4239, 27)
+#define BPMSG1212 bp_message_write_line(4266, 2)
+#define BPMSG1213 bp_message_write_line(4268, 20)
+#define BPMSG1214 bp_message_write_line(4288, 18)
+#define BPMSG1215 bp_message_write_line(4306, 19)
+#define BPMSG1216 bp_message_write_line(4325, 29)
+#define BPMSG1217 bp_message_write_line(4354, 50)
+#define BPMSG1218 bp_message_write_buffer(4404, 19)
+#define BPMSG1219 bp_message_write_line(4423, 152)
+#define BPMSG1220 bp_message_write_line(4575, 36)
+#define BPMSG1221 bp_message_write_line(4611, 4)
+#define BPMSG1222 bp_message_write_line(4615, 5)
+#define BPMSG1223 bp_message_write_line(4620, 10)
+#define BPMSG1224 bp_message_write_line(4630, 21)
+#define BPMSG1225 bp_message_write_line(4651, 16)
+#define BPMSG1226 bp_message_write_line(4667, 10)
+#define BPMSG1227 bp_message_write_buffer(4677, 26)
+#define BPMSG1228 bp_message_write_buffer(4703, 10)
+#define BPMSG1229 bp_message_write_line(4713, 9)
+#define BPMSG1230 bp_message_write_line(4722, 11)
+#define BPMSG1231 bp_message_write_line(4733, 11)
+#define BPMSG1232 bp_message_write_line(4744, 11)
+#define BPMSG1233 bp_message_write_line(4755, 70)
+#define BPMSG1234 bp_message_write_buffer(4825, 4)
+#define BPMSG1235 bp_message_write_buffer(4829, 26)
+#define BPMSG1236 bp_message_write_buffer(4855, 10)
+#define BPMSG1237 bp_message_write_buffer(4865, 8)
+#define BPMSG1238 bp_message_write_line(4873, 38)
+#define BPMSG1239 bp_message_write_line(4911, 28)
+#define BPMSG1240 bp_message_write_line(4939, 16)
+#define BPMSG1241 bp_message_write_line(4955, 14)
+#define BPMSG1242 bp_message_write_line(4969, 15)
+#define BPMSG1243 bp_message_write_line(4984, 5)
+#define BPMSG1244 bp_message_write_line(4989, 14)
+#define BPMSG1245 bp_message_write_buffer(5003, 11)
+#define BPMSG1246 bp_message_write_buffer(5014, 5)
+#define BPMSG1247 bp_message_write_buffer(5019, 5)
+#define BPMSG1248 bp_message_write_line(5024, 25)
+#define BPMSG1249 bp_message_write_line(5049, 32)
+#define BPMSG1250 bp_message_write_line(5081, 15)
+#define BPMSG1251 bp_message_write_line(5096, 17)
+#define BPMSG1252 bp_message_write_buffer(5113, 27)
+#define BPMSG1253 bp_message_write_line(5140, 29)
+#define BPMSG1254 bp_message_write_line(5169, 19)
+#define BPMSG1255 bp_message_write_line(5188, 12)
+#define BPMSG1256 bp_message_write_line(5200, 86)
+#define BPMSG1257 bp_message_write_buffer(5286, 36)
+#define BPMSG1258 bp_message_write_line(5322, 16)
+#define BPMSG1259 bp_message_write_line(5338, 9)
+#define BPMSG1260 bp_message_write_line(5347, 11)
+#define BPMSG1261 bp_message_write_line(5358, 11)
+#define BPMSG1262 bp_message_write_line(5369, 11)
+#define BPMSG1263 bp_message_write_line(5380, 23)
+#define BPMSG1264 bp_message_write_line(5403, 23)
+#define BPMSG1265 bp_message_write_line(5426, 6)
+#define BPMSG1266 bp_message_write_buffer(5432, 3)
+#define BPMSG1267 bp_message_write_buffer(5435, 3)
+#define BPMSG1268 bp_message_write_buffer(5438, 2)
+#define BPMSG1269 bp_message_write_buffer(5440, 10)
+#define BPMSG1270 bp_message_write_buffer(5450, 4)
+#define BPMSG1271 bp_message_write_line(5454, 87)
+#define BPMSG1272 bp_message_write_buffer(5541, 25)
+#define BPMSG1273 bp_message_write_line(5566, 7)
+#define BPMSG1274 bp_message_write_line(5573, 8)
+#define BPMSG1278 bp_message_write_line(5581, 14)
+#define BPMSG1280 bp_message_write_line(5595, 19)
+#define BPMSG1281 bp_message_write_line(5614, 14)
+#define BPMSG1282 bp_message_write_line(5628, 56)
+#define BPMSG1283 bp_message_write_buffer(5684, 15)
+#define BPMSG1284 bp_message_write_buffer(5699, 15)
+#define BPMSG1285 bp_message_write_line(5714, 4)
+#define BPMSG1286 bp_message_write_line(5718, 20)
+#define BPMSG1287 bp_message_write_line(5738, 33)
+#define BPMSG1288 bp_message_write_line(5771, 25)
+#define BPMSG1289 bp_message_write_line(5796, 26)
+#define BPMSG1290 bp_message_write_line(5822, 14)
+#define HLP1000 bp_message_write_line(5836, 32)
+#define HLP1001 bp_message_write_line(5868, 75)
+#define HLP1002 bp_message_write_line(5943, 37)
+#define HLP1003 bp_message_write_line(5980, 39)
+#define HLP1004 bp_message_write_line(6019, 20)
+#define HLP1005 bp_message_write_line(6039, 26)
+#define HLP1006 bp_message_write_line(6065, 39)
+#define HLP1007 bp_message_write_line(6104, 26)
+#define HLP1008 bp_message_write_line(6130, 45)
+#define HLP1009 bp_message_write_line(6175, 39)
+#define HLP1010 bp_message_write_line(6214, 57)
+#define HLP1011 bp_message_write_line(6271, 52)
+#define HLP1012 bp_message_write_line(6323, 27)
+#define HLP1013 bp_message_write_line(6350, 32)
+#define HLP1014 bp_message_write_line(6382, 27)
+#define HLP1015 bp_message_write_line(6409, 36)
+#define HLP1016 bp_message_write_line(6445, 32)
+#define HLP1017 bp_message_write_line(6477, 24)
+#define HLP1018 bp_message_write_line(6501, 31)
+#define HLP1019 bp_message_write_line(6532, 40)
+#define HLP1020 bp_message_write_line(6572, 36)
+#define HLP1021 bp_message_write_line(6608, 53)
+#define HLP1022 bp_message_write_line(6661, 61)
 
 #endif /* BP_MESSAGES_V4_H */
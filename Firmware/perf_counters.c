@@ -0,0 +1,167 @@
+/*
+ * This file is part of the Bus Pirate project
+ * (http://code.google.com/p/the-bus-pirate/).
+ *
+ * Written and maintained by the Bus Pirate project.
+ *
+ * To the extent possible under law, the project has
+ * waived all copyright and related or neighboring rights to Bus Pirate. This
+ * work is published from United States.
+ *
+ * For details see: http://creativecommons.org/publicdomain/zero/1.0/.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "perf_counters.h"
+
+#ifdef BP_ENABLE_PERF_COUNTERS
+
+#include "base.h"
+#include "baseIO.h"
+
+/**
+ * Version of the block layout sent by perf_counters_send.
+ */
+#define PERF_COUNTERS_VERSION 1
+
+/**
+ * Bytes sent by perf_counters_send after the length byte.
+ */
+#define PERF_COUNTERS_BLOCK_LENGTH                                             \
+  (3 + 4 + (PERF_MODE_COUNT * 8) + 4 + 4 + (PERF_HANDLER_COUNT * 12))
+
+perf_counters_t perf_counters;
+perf_mode_counters_t *perf_current_mode = &perf_counters.mode[0];
+
+/**
+ * Upper 16 bits of the clock, bumped by the timer #1 period interrupt.
+ */
+static volatile uint16_t perf_clock_high;
+
+/**
+ * Start time of the running handler.
+ */
+static uint32_t perf_handler_start;
+
+/**
+ * Start time of the running wait for host input.
+ */
+static uint32_t perf_wait_start;
+
+void perf_counters_init(void) {
+  /* Timer #1 free running at Fcy/8, interrupt on every wrap. */
+  T1CON = 0;
+  TMR1 = 0;
+  PR1 = 0xFFFF;
+  perf_clock_high = 0;
+  T1CONbits.TCKPS = 0b01;
+  IFS0bits.T1IF = OFF;
+  IEC0bits.T1IE = ON;
+  T1CONbits.TON = ON;
+
+  perf_counters_reset();
+}
+
+void perf_counters_reset(void) {
+  memset(&perf_counters, 0, sizeof(perf_counters));
+}
+
+void perf_counters_set_mode(const perf_mode_t mode) {
+  perf_current_mode = &perf_counters.mode[mode];
+}
+
+uint32_t perf_counters_now(void) {
+  uint16_t high;
+  uint16_t low;
+
+  do {
+    high = perf_clock_high;
+    low = TMR1;
+
+    /* Wrapped, but the interrupt did not run yet. */
+    if (IFS0bits.T1IF && (low < 0x8000)) {
+      high++;
+    }
+  } while (high != perf_clock_high && !IFS0bits.T1IF);
+
+  return ((uint32_t)high << 16) | low;
+}
+
+void perf_counters_begin(const perf_handler_t handler) {
+  (void)handler;
+  perf_handler_start = perf_counters_now();
+}
+
+void perf_counters_end(const perf_handler_t handler) {
+  perf_handler_counters_t *counters = &perf_counters.handler[handler];
+  uint32_t elapsed = perf_counters_now() - perf_handler_start;
+
+  counters->calls++;
+  counters->ticks += elapsed;
+  if (elapsed > counters->max_ticks) {
+    counters->max_ticks = elapsed;
+  }
+}
+
+void perf_counters_wait_begin(void) { perf_wait_start = perf_counters_now(); }
+
+void perf_counters_wait_end(void) {
+  perf_counters.rx_wait_ticks += perf_counters_now() - perf_wait_start;
+}
+
+void perf_counters_ring_level(const uint16_t used) {
+  if (used > perf_counters.ring_high_water) {
+    perf_counters.ring_high_water = used;
+  }
+}
+
+static void perf_send_16(const uint16_t value) {
+  UART1TX(value >> 8);
+  UART1TX(value);
+}
+
+static void perf_send_32(const uint32_t value) {
+  perf_send_16(value >> 16);
+  perf_send_16(value);
+}
+
+void perf_counters_send(void) {
+  /* Snapshot first, sending updates the BBIO byte counters. */
+  perf_counters_t snapshot = perf_counters;
+  uint32_t now = perf_counters_now();
+  size_t index;
+
+  UART1TX(PERF_COUNTERS_BLOCK_LENGTH);
+  UART1TX(PERF_COUNTERS_VERSION);
+  UART1TX(PERF_MODE_COUNT);
+  UART1TX(PERF_HANDLER_COUNT);
+  perf_send_32(now);
+
+  for (index = 0; index < PERF_MODE_COUNT; index++) {
+    perf_send_32(snapshot.mode[index].bytes_in);
+    perf_send_32(snapshot.mode[index].bytes_out);
+  }
+
+  perf_send_32(snapshot.rx_wait_ticks);
+  perf_send_16(snapshot.ring_overflows);
+  perf_send_16(snapshot.ring_high_water);
+
+  for (index = 0; index < PERF_HANDLER_COUNT; index++) {
+    perf_send_32(snapshot.handler[index].calls);
+    perf_send_32(snapshot.handler[index].ticks);
+    perf_send_32(snapshot.handler[index].max_ticks);
+  }
+}
+
+void __attribute__((interrupt, no_auto_psv)) _T1Interrupt(void) {
+  perf_clock_high++;
+  IFS0bits.T1IF = OFF;
+}
+
+#endif /* BP_ENABLE_PERF_COUNTERS */
@@ -0,0 +1,217 @@
+/*
+ * This file is part of the Bus Pirate project
+ * (http://code.google.com/p/the-bus-pirate/).
+ *
+ * Written and maintained by the Bus Pirate project.
+ *
+ * To the extent possible under law, the project has
+ * waived all copyright and related or neighboring rights to Bus Pirate. This
+ * work is published from United States.
+ *
+ * For details see: http://creativecommons.org/publicdomain/zero/1.0/.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef BP_PERF_COUNTERS_H
+#define BP_PERF_COUNTERS_H
+
+#include <stdint.h>
+
+#include "configuration.h"
+
+/*
+ * Performance counters.
+ *
+ * A small block of counters updated by the I/O functions and the busiest
+ * binary mode handlers, so that a host can tell where the time goes when a
+ * fixture runs slower than expected: bytes moved per mode, time spent waiting
+ * for the host, UARTbuf overflows and occupancy, and how long the bulk
+ * handlers take.
+ *
+ * Times are read from timer #1, free running at Fcy/8 (one tick every 0.5us
+ * at 16 MIPS) and extended to 32 bits by its period interrupt, so they wrap
+ * after about 35 minutes.  Handler times are wall clock times and include the
+ * waits for the host bytes a handler reads.
+ *
+ * The counters are read and cleared from BBIO mode, see binIO.c.
+ */
+
+#ifdef BP_ENABLE_PERF_COUNTERS
+
+/**
+ * Modes bytes are accounted to.
+ */
+typedef enum {
+  PERF_MODE_TERMINAL = 0,
+  PERF_MODE_BBIO,
+  PERF_MODE_SPI,
+  PERF_MODE_I2C,
+  PERF_MODE_UART,
+  PERF_MODE_1WIRE,
+  PERF_MODE_RAW_WIRE,
+  PERF_MODE_COUNT
+} perf_mode_t;
+
+/**
+ * Timed binary mode handlers.
+ */
+typedef enum {
+  /** binSPI 0001xxxx bulk transfer. */
+  PERF_HANDLER_SPI_BULK = 0,
+  /** binSPI 0x04/0x05 write then read. */
+  PERF_HANDLER_SPI_WRITE_READ,
+  /** binI2C 0001xxxx bulk write. */
+  PERF_HANDLER_I2C_BULK,
+  /** binI2C 0x08 write then read. */
+  PERF_HANDLER_I2C_WRITE_READ,
+  /** binwire 0001xxxx bulk transfer. */
+  PERF_HANDLER_RAW_BULK,
+  PERF_HANDLER_COUNT
+} perf_handler_t;
+
+/**
+ * Per mode traffic.
+ */
+typedef struct {
+  /** Bytes read from the host. */
+  uint32_t bytes_in;
+
+  /** Bytes sent to the host. */
+  uint32_t bytes_out;
+} perf_mode_counters_t;
+
+/**
+ * Per handler timing.
+ */
+typedef struct {
+  /** Completed runs. */
+  uint32_t calls;
+
+  /** Ticks spent in all runs. */
+  uint32_t ticks;
+
+  /** Ticks taken by the longest run. */
+  uint32_t max_ticks;
+} perf_handler_counters_t;
+
+/**
+ * The counters block.
+ */
+typedef struct {
+  perf_mode_counters_t mode[PERF_MODE_COUNT];
+  perf_handler_counters_t handler[PERF_HANDLER_COUNT];
+
+  /** Ticks spent waiting for a byte from the host. */
+  uint32_t rx_wait_ticks;
+
+  /** Bytes UARTbuf dropped, saturating at 0xFFFF. */
+  uint16_t ring_overflows;
+
+  /** Most bytes waiting in the UARTbuf ring buffer. */
+  uint16_t ring_high_water;
+} perf_counters_t;
+
+extern perf_counters_t perf_counters;
+
+/**
+ * Counters of the current mode, updated on every byte.
+ */
+extern perf_mode_counters_t *perf_current_mode;
+
+/**
+ * Starts timer #1 and clears the counters.
+ */
+void perf_counters_init(void);
+
+/**
+ * Clears the counters, the clock keeps running.
+ */
+void perf_counters_reset(void);
+
+/**
+ * Selects the mode further bytes are accounted to.
+ *
+ * @param[in] mode the mode being entered.
+ */
+void perf_counters_set_mode(const perf_mode_t mode);
+
+/**
+ * Reads the 32 bits clock.
+ *
+ * @return the ticks elapsed since perf_counters_init.
+ */
+uint32_t perf_counters_now(void);
+
+/**
+ * Marks the start of a handler run.
+ *
+ * @param[in] handler the handler starting.
+ */
+void perf_counters_begin(const perf_handler_t handler);
+
+/**
+ * Marks the end of a handler run and accounts its time.
+ *
+ * @param[in] handler the handler done.
+ */
+void perf_counters_end(const perf_handler_t handler);
+
+/**
+ * Marks the start of a wait for host input.
+ */
+void perf_counters_wait_begin(void);
+
+/**
+ * Marks the end of a wait for host input and accounts its time.
+ */
+void perf_counters_wait_end(void);
+
+/**
+ * Accounts the UARTbuf ring buffer fill level.
+ *
+ * @param[in] used bytes waiting in the ring buffer.
+ */
+void perf_counters_ring_level(const uint16_t used);
+
+/**
+ * Sends the counters block to the host, see binIO.c for its layout.
+ */
+void perf_counters_send(void);
+
+#define PERF_COUNT_IN() (perf_current_mode->bytes_in++)
+#define PERF_COUNT_IN_BLOCK(count) (perf_current_mode->bytes_in += (count))
+#define PERF_COUNT_OUT() (perf_current_mode->bytes_out++)
+#define PERF_COUNT_OUT_BLOCK(count) (perf_current_mode->bytes_out += (count))
+#define PERF_SET_MODE(mode) perf_counters_set_mode(mode)
+#define PERF_BEGIN(handler) perf_counters_begin(handler)
+#define PERF_END(handler) perf_counters_end(handler)
+#define PERF_WAIT_BEGIN() perf_counters_wait_begin()
+#define PERF_WAIT_END() perf_counters_wait_end()
+#define PERF_RING_LEVEL(used) perf_counters_ring_level(used)
+#define PERF_RING_OVERFLOW()                                                   \
+  do {                                                                         \
+    if (perf_counters.ring_overflows != 0xFFFF) {                              \
+      perf_counters.ring_overflows++;                                          \
+    }                                                                          \
+  } while (0)
+
+#else
+
+#define PERF_COUNT_IN()
+#define PERF_COUNT_IN_BLOCK(count)
+#define PERF_COUNT_OUT()
+#define PERF_COUNT_OUT_BLOCK(count)
+#define PERF_SET_MODE(mode)
+#define PERF_BEGIN(handler)
+#define PERF_END(handler)
+#define PERF_WAIT_BEGIN()
+#define PERF_WAIT_END()
+#define PERF_RING_LEVEL(used)
+#define PERF_RING_OVERFLOW()
+
+#endif /* BP_ENABLE_PERF_COUNTERS */
+
+#endif /* BP_PERF_COUNTERS_H */
@@ -115,7 +115,7 @@ void R2Wsetup(void)
 	output=getint();
 
 	// check for userinput (and sanitycheck it!!)
-	if((speed>0)&&(speed<=4))
+	if((speed>0)&&(speed<=5))
 	{	mode_configuration.speed=speed-1;
 	}
 	else	
@@ -132,7 +132,8 @@ void R2Wsetup(void)
 	{	command_error=false;
 		//bpWmessage(MSG_OPT_BB_SPEED);
 		BPMSG1065;
-		mode_configuration.speed=(getnumber(1,1,4,0)-1);
+		BPMSG1287;
+		mode_configuration.speed=(getnumber(1,1,5,0)-1);
 		//bpWmessage(MSG_OPT_OUTPUT_TYPE);
 		BPMSG1142;
 		mode_configuration.high_impedance=(~(getnumber(1,1,2,0)-1));
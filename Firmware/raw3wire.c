@@ -135,7 +135,7 @@ void R3Wsetup(void)
 	consumewhitechars();
 	output=getint();
 
-	if((speed>0)&&(speed<=4))
+	if((speed>0)&&(speed<=5))
 	{	mode_configuration.speed=speed-1;
 	}
 	else	
@@ -157,7 +157,8 @@ void R3Wsetup(void)
 	if(speed==0)
 	{	//bpWmessage(MSG_OPT_BB_SPEED);
 		BPMSG1065;
-		mode_configuration.speed=(getnumber(1,1,4,0)-1);
+		BPMSG1287;
+		mode_configuration.speed=(getnumber(1,1,5,0)-1);
 
 		//bpWline("CS:\r\n 1. CS\r\n 2. /CS *default");
 		BPMSG1253;
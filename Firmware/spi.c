@@ -21,6 +21,7 @@
 #include "base.h"
 #include "bus_pirate_core.h"
 #include "binIOhelpers.h"
+#include "perf_counters.h"
 
 #include "procMenu.h"		// for the userinteraction subs
 
@@ -55,6 +56,8 @@ void binSPIversionString(void);
 void spiSlaveDisable(void);
 void spiSlaveSetup(void);
 void spiSniffer(unsigned char csState, unsigned char termMode);
+void spiSnifferRecords(unsigned char csState);
+void spiStreamTransfer(void);
 
 struct _SPI {
     unsigned char ckp : 1;
@@ -442,12 +445,13 @@ spiSnifferStart:
 
         if (SPI1STATbits.SPIROV == 1 || SPI2STATbits.SPIROV == 1 || bus_pirate_configuration.overflow == 1) {//we weren't fast enough, buffer overflow
 
-            if (bus_pirate_configuration.overflow == 0) UARTbufFlush();
+            UARTbufFlush(); //the U1TX interrupt must be done before UART1TX is used
             SPI1STAT = 0;
             SPI2STAT = 0;
 
             if (termMode) {
                 bp_write_line("Couldn't keep up");
+                UARTbufReport();
                 goto spiSnifferStart;
             }
 
@@ -459,7 +463,11 @@ spiSnifferStart:
         if (UART1RXRdy() == 1) {//any key pressed, exit
             c = UART1RX();
             /* JTR usb port; */;
-            if (termMode) bpBR; //fixed in 5.1: also sent br to binmode
+            UARTbufFlush(); //send what is still queued
+            if (termMode) {
+                bpBR; //fixed in 5.1: also sent br to binmode
+                UARTbufReport();
+            }
             break;
         }
     }
@@ -468,6 +476,226 @@ spiSnifferStart:
     spiSetup(spi_bus_speed[mode_configuration.speed]);
 }
 
+//
+//
+//	SPI Sniffer, timestamped binary records
+//
+//
+// Unlike the escaped binary sniffer, which spends three bytes per sniffed
+// byte and has no timing, this one packs the traffic into records stamped
+// with timer #4/#5 running as a free running 32 bit counter at Fcy/8, one
+// tick every 0.5us (wraps after ~35 minutes). Multi byte fields are MSB first.
+//
+// 0x01 t3 t2 t1 t0                 CS went low
+// 0x02 t3 t2 t1 t0                 CS went high
+// 0x03 t3 t2 t1 t0 n {MOSI MISO}*n n byte pairs, t is the time of the first
+// 0x04 c1 c0                       records were lost before this one
+// 0x00                             end, the sniffer stopped
+//
+// A data record is sent once it holds SNIFF_RECORD_MAX_PAIRS pairs, at a CS
+// edge, or when the bus stayed quiet for SNIFF_RECORD_IDLE_TICKS, so a busy
+// bus costs a little over two bytes per sniffed byte.
+//
+// When the output buffer is full, records are dropped instead of stopping
+// the sniffer. The next record that fits is preceded by a 0x04 record
+// holding the number of byte pairs lost (saturated at 0xFFFF), 0 if only CS
+// records went missing. A SPI receive overrun loses an unknown number of
+// bytes and is reported as 0xFFFF.
+//
+// Any byte from the host stops the sniffer. The 0x00 record comes after
+// everything still queued, the host reads up to it before sending commands.
+
+#define SNIFF_RECORD_END 0x00
+#define SNIFF_RECORD_CS_LOW 0x01
+#define SNIFF_RECORD_CS_HIGH 0x02
+#define SNIFF_RECORD_DATA 0x03
+#define SNIFF_RECORD_DROPPED 0x04
+
+#define SNIFF_RECORD_HEADER 6 //type, timestamp and count of a data record
+#define SNIFF_RECORD_MAX_PAIRS 29 //a full data record fits a 64 bytes USB packet
+#define SNIFF_RECORD_IDLE_TICKS 2000 //1ms
+#define SNIFF_DROPPED_UNKNOWN 0xFFFF
+
+static struct {
+    unsigned int dropped; //byte pairs lost since the last record sent
+    unsigned char lost; //a record was lost since the last record sent
+} sniffRecords;
+
+static uint32_t spiSnifferTime(void) {
+    uint16_t lsw;
+
+    lsw = TMR4; //latches TMR5 into TMR5HLD
+    return ((uint32_t) TMR5HLD << 16) | lsw;
+}
+
+static void spiSnifferStamp(uint8_t *record, uint32_t time) {
+    record[1] = (uint8_t) (time >> 24);
+    record[2] = (uint8_t) (time >> 16);
+    record[3] = (uint8_t) (time >> 8);
+    record[4] = (uint8_t) time;
+}
+
+//queue a whole record or nothing
+static bool spiSnifferQueue(const uint8_t *record, uint8_t length) {
+#if defined(BUSPIRATEV4) && !defined(BPV4_DEBUG)
+    return put_cdc_nowait(record, length) != 0;
+#else
+    uint8_t i;
+
+    if (UARTbufFree() < length) return false;
+    for (i = 0; i < length; i++) {
+        UARTbuf(record[i]);
+    }
+    return true;
+#endif
+}
+
+//send a record, reporting earlier losses first
+static void spiSnifferSend(const uint8_t *record, uint8_t length, uint8_t pairs) {
+    uint8_t dropped[3];
+
+    if (sniffRecords.lost) {
+        dropped[0] = SNIFF_RECORD_DROPPED;
+        dropped[1] = (uint8_t) (sniffRecords.dropped >> 8);
+        dropped[2] = (uint8_t) sniffRecords.dropped;
+        if (spiSnifferQueue(dropped, sizeof (dropped))) {
+            sniffRecords.lost = 0;
+            sniffRecords.dropped = 0;
+        }
+    }
+
+    if (sniffRecords.lost == 0 && spiSnifferQueue(record, length)) return;
+
+    sniffRecords.lost = 1;
+    if (sniffRecords.dropped > (SNIFF_DROPPED_UNKNOWN - pairs)) {
+        sniffRecords.dropped = SNIFF_DROPPED_UNKNOWN;
+    } else {
+        sniffRecords.dropped += pairs;
+    }
+}
+
+static void spiSnifferEdge(uint8_t type) {
+    uint8_t record[5];
+
+    record[0] = type;
+    spiSnifferStamp(record, spiSnifferTime());
+    spiSnifferSend(record, sizeof (record), 0);
+}
+
+void spiSnifferRecords(unsigned char csState) {
+    uint8_t record[SNIFF_RECORD_HEADER + (SNIFF_RECORD_MAX_PAIRS * 2)];
+    uint8_t pairs, *next;
+    uint32_t last;
+    bool csLow, cs;
+
+    UARTbufSetup();
+    spiDisable();
+    spiSlaveSetup();
+
+    if (csState == 0) { //use CS pin
+        SPI1CON1bits.SSEN = 1;
+        SPI2CON1bits.SSEN = 1;
+    }
+    SPI1STATbits.SPIEN = 1;
+    SPI2STATbits.SPIEN = 1;
+
+    //timer #4/#5 as a free running 32 bits counter, Fcy/8
+    T4CON = 0;
+    TMR5HLD = 0;
+    TMR4 = 0;
+    PR5 = 0xFFFF;
+    PR4 = 0xFFFF;
+    T4CONbits.T32 = ON;
+    T4CONbits.TCKPS = 0b01;
+    T4CONbits.TON = ON;
+
+    sniffRecords.dropped = 0;
+    sniffRecords.lost = 0;
+    record[0] = SNIFF_RECORD_DATA;
+    next = &record[SNIFF_RECORD_HEADER];
+    pairs = 0;
+    last = 0;
+    csLow = false;
+
+    while (1) {
+        //CS is read before the FIFOs are emptied, so that every byte
+        //clocked in before an edge is sent before the edge record
+        cs = (SPICS == 0);
+
+        if (cs && !csLow) {
+            if (pairs != 0) { //traffic from before the frame
+                record[SNIFF_RECORD_HEADER - 1] = pairs;
+                spiSnifferSend(record, SNIFF_RECORD_HEADER + (pairs * 2), pairs);
+                pairs = 0;
+                next = &record[SNIFF_RECORD_HEADER];
+            }
+            spiSnifferEdge(SNIFF_RECORD_CS_LOW);
+            csLow = true;
+        }
+
+        while (SPI1STATbits.SRXMPT == 0 && SPI2STATbits.SRXMPT == 0) {
+            if (pairs == 0) spiSnifferStamp(record, spiSnifferTime());
+            *next++ = SPI1BUF; //MOSI
+            *next++ = SPI2BUF; //MISO
+            pairs++;
+            if (pairs == SNIFF_RECORD_MAX_PAIRS) {
+                record[SNIFF_RECORD_HEADER - 1] = pairs;
+                spiSnifferSend(record, sizeof (record), pairs);
+                pairs = 0;
+                next = &record[SNIFF_RECORD_HEADER];
+            }
+            last = spiSnifferTime();
+        }
+
+        if (pairs != 0 && ((!cs && csLow) || (spiSnifferTime() - last) > SNIFF_RECORD_IDLE_TICKS)) {
+            record[SNIFF_RECORD_HEADER - 1] = pairs;
+            spiSnifferSend(record, SNIFF_RECORD_HEADER + (pairs * 2), pairs);
+            pairs = 0;
+            next = &record[SNIFF_RECORD_HEADER];
+        }
+
+        if (!cs && csLow) {
+            spiSnifferEdge(SNIFF_RECORD_CS_HIGH);
+            csLow = false;
+        }
+
+        if (SPI1STATbits.SPIROV == 1 || SPI2STATbits.SPIROV == 1) {
+            //restart both units so MOSI and MISO bytes pair up again
+            SPI1STATbits.SPIEN = 0;
+            SPI2STATbits.SPIEN = 0;
+            SPI1STATbits.SPIROV = 0;
+            SPI2STATbits.SPIROV = 0;
+            SPI1STATbits.SPIEN = 1;
+            SPI2STATbits.SPIEN = 1;
+            sniffRecords.lost = 1;
+            sniffRecords.dropped = SNIFF_DROPPED_UNKNOWN;
+        }
+
+        UARTbufService();
+        if (UART1RXRdy() == 1) { //any byte stops the sniffer
+            UART1RX();
+            break;
+        }
+    }
+
+    if (pairs != 0) {
+        record[SNIFF_RECORD_HEADER - 1] = pairs;
+        spiSnifferSend(record, SNIFF_RECORD_HEADER + (pairs * 2), pairs);
+    }
+    if (sniffRecords.lost) { //a last try for the loss report
+        record[0] = SNIFF_RECORD_DROPPED;
+        record[1] = (uint8_t) (sniffRecords.dropped >> 8);
+        record[2] = (uint8_t) sniffRecords.dropped;
+        spiSnifferQueue(record, 3);
+    }
+    UARTbufFlush(); //send what is still queued
+    UART1TX(SNIFF_RECORD_END);
+
+    T4CON = 0;
+    spiSlaveDisable();
+    spiSetup(spi_bus_speed[mode_configuration.speed]);
+}
+
 //configure both SPI units for slave mode on different pins
 //use current settings
 
@@ -547,13 +775,82 @@ void spiSlaveDisable(void) {
 
 }
 
+//
+// Streaming write-then-read, binSPI command 0x07
+//
+// 0x07, write count (4 bytes), read count (4 bytes), both MSB first. The
+// reply 0x01 comes right away, then CS goes low for the whole transfer. The
+// write bytes are clocked out as they arrive from the host and the read
+// bytes are sent back as they are clocked in, so the counts are not limited
+// by the terminal buffer: reading a whole SPI flash is
+// 0x07 00000004 <size> 03 000000.
+//
+// Writes are taken a terminal buffer at a time, and each one is answered
+// with 0x01 once it was clocked out. The host sends the next buffer only
+// after that, so a slow SPI clock can't overrun the UART of a v3.
+//
+
+#define SPI_STREAM_CHUNK 64 //read bytes sent per USB packet
+
+static unsigned long spiStreamCount(void) {
+    unsigned long count = 0;
+    unsigned char i;
+
+    for (i = 0; i < 4; i++) {
+        count = (count << 8) | UART1RX();
+    }
+    return count;
+}
+
+void spiStreamTransfer(void) {
+    unsigned char *buffer = bus_pirate_configuration.terminal_input;
+    unsigned long fw, fr;
+    unsigned int chunk, j;
+
+    fw = spiStreamCount();
+    fr = spiStreamCount();
+
+    UART1TX(1); //send 1/OK
+    UARTbufFlush();
+
+    PERF_BEGIN(PERF_HANDLER_SPI_WRITE_READ);
+
+    SPICS = 0;
+    while (fw > 0) {
+        chunk = (fw > BP_TERMINAL_BUFFER_SIZE) ? BP_TERMINAL_BUFFER_SIZE : fw;
+        bp_read_buffer(buffer, chunk);
+        for (j = 0; j < chunk; j++) {
+            spiWriteByte(buffer[j]);
+        }
+        fw -= chunk;
+        UART1TX(1); //ready for the next buffer
+        UARTbufFlush();
+    }
+    bp_delay_us(1);
+    while (fr > 0) {
+        chunk = (fr > SPI_STREAM_CHUNK) ? SPI_STREAM_CHUNK : fr;
+        for (j = 0; j < chunk; j++) {
+            buffer[j] = spiWriteByte(0xff);
+        }
+        bp_write_buffer(buffer, chunk);
+        fr -= chunk;
+    }
+    SPICS = 1;
+
+    PERF_END(PERF_HANDLER_SPI_WRITE_READ);
+}
+
 /*
 rawSPI mode:
  * 00000000 � Enter raw bitbang mode, reset to raw bitbang mode
  * 00000001 � SPI mode/rawSPI version string (SPI1)
  * 00000010 � CS low (0)
  * 00000011 � CS high (1)
- * Sniffers
+ * 00000111 - Streaming write-then-read, 32 bit counts, CS held low
+ * 00001011 - Timestamped sniffer records, all traffic
+ * 00001100 - Timestamped sniffer records, CS low
+ * 00001101 - Sniff all traffic
+ * 00001110 - Sniff CS low
  * 0001xxxx � Bulk SPI transfer, send 1-16 bytes (0=1byte!)
  * 0100wxyz � Configure peripherals, w=power, x=pullups, y=AUX, z=CS
  * 01100xxx � Set SPI speed, 30, 125, 250khz; 1, 2, 2.6, 4, 8MHz
@@ -562,8 +859,146 @@ rawSPI mode:
  * 00000000 - Null operation - verifies extended commands are available.
  * 00000001 - Return version (2 bytes)
  * 00000010 - Bulk Memory Read from Flash
+ * 00000011 - CRC32 of a 25 series SPI flash range
+ * 00000100 - SPI flash page program
+ * 00000101 - SPI flash sector erase
+ * 00000110 - Wait for the SPI flash to finish writing
 	
  */
+#ifdef AVR_EXTENDED_COMMANDS
+
+//CRC32 as computed by zlib's crc32(), a nibble at a time: a 16 entry table
+//is 64 bytes of flash instead of 1KB for a byte wide one
+static const unsigned long crc32Nibble[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+    0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+static unsigned long spiCrc32Update(unsigned long crc, unsigned char c) {
+    crc ^= c;
+    crc = (crc >> 4) ^ crc32Nibble[crc & 0x0F];
+    crc = (crc >> 4) ^ crc32Nibble[crc & 0x0F];
+    return crc;
+}
+
+//
+// 25 series SPI flash programming, extended commands 0x04 to 0x06
+//
+// A page program returns as soon as the page was handed to the flash. The
+// status register is polled locally at the start of the next flash command,
+// so the host sends the next page while the flash is still writing the
+// previous one. Addresses past 16MB use the 4 byte address opcodes.
+//
+
+#define SPI_FLASH_WREN 0x06
+#define SPI_FLASH_RDSR 0x05
+#define SPI_FLASH_PP 0x02
+#define SPI_FLASH_PP4 0x12
+#define SPI_FLASH_SE 0x20
+#define SPI_FLASH_SE4 0x21
+#define SPI_FLASH_WIP 0x01
+#define SPI_FLASH_WEL 0x02
+#define SPI_FLASH_PAGE 256
+#define SPI_FLASH_POLLS 200000UL //~2.5s at 10us or more per poll, a 4KB erase takes <0.5s
+
+static bool spiFlashWriting = false;
+
+//polls the status register until the write in progress ends, false on timeout
+static bool spiFlashWait(void) {
+    unsigned long polls;
+    unsigned char status;
+
+    if (!spiFlashWriting) return true;
+
+    SPICS = 0;
+    spiWriteByte(SPI_FLASH_RDSR);
+    for (polls = 0; polls < SPI_FLASH_POLLS; polls++) {
+        status = spiWriteByte(0xff); //the status is repeated until CS goes high
+        if ((status & SPI_FLASH_WIP) == 0) break;
+        bp_delay_us(10);
+    }
+    SPICS = 1;
+
+    spiFlashWriting = (polls == SPI_FLASH_POLLS);
+    return !spiFlashWriting;
+}
+
+//waits for the last write, then sends WREN and checks it took (not protected)
+static bool spiFlashWriteEnable(void) {
+    unsigned char status;
+
+    if (!spiFlashWait()) return false;
+
+    SPICS = 0;
+    spiWriteByte(SPI_FLASH_WREN);
+    SPICS = 1;
+
+    SPICS = 0;
+    spiWriteByte(SPI_FLASH_RDSR);
+    status = spiWriteByte(0xff);
+    SPICS = 1;
+
+    return (status & SPI_FLASH_WEL) != 0;
+}
+
+static void spiFlashAddress(unsigned char cmd, unsigned char cmd4, unsigned long addr) {
+    if (addr >= 0x1000000UL) {
+        spiWriteByte(cmd4);
+        spiWriteByte(addr >> 24);
+    } else {
+        spiWriteByte(cmd);
+    }
+    spiWriteByte(addr >> 16);
+    spiWriteByte(addr >> 8);
+    spiWriteByte(addr);
+}
+
+//page program: address (4 bytes), count (2 bytes, 1-256), data
+//the data must not cross a page boundary, the flash would wrap around
+static unsigned char spiFlashProgram(unsigned long addr, unsigned int count) {
+    unsigned char *buffer = bus_pirate_configuration.terminal_input;
+    unsigned int j;
+
+    if (count == 0 || (addr % SPI_FLASH_PAGE) + count > SPI_FLASH_PAGE) {
+        //the host sends the data anyway, don't take it for commands
+        for (j = 0; j < count; j++) {
+            UART1RX();
+        }
+        return 0;
+    }
+
+    //take the page while the flash finishes the previous one
+    bp_read_buffer(buffer, count);
+
+    if (!spiFlashWriteEnable()) return 0;
+
+    SPICS = 0;
+    spiFlashAddress(SPI_FLASH_PP, SPI_FLASH_PP4, addr);
+    for (j = 0; j < count; j++) {
+        spiWriteByte(buffer[j]);
+    }
+    SPICS = 1;
+
+    spiFlashWriting = true;
+    return 1;
+}
+
+//sector erase: address (4 bytes), waits for the erase to end
+static unsigned char spiFlashErase(unsigned long addr) {
+    if (!spiFlashWriteEnable()) return 0;
+
+    SPICS = 0;
+    spiFlashAddress(SPI_FLASH_SE, SPI_FLASH_SE4, addr);
+    SPICS = 1;
+
+    spiFlashWriting = true;
+    return spiFlashWait();
+}
+
+#endif /* AVR_EXTENDED_COMMANDS */
+
 static const unsigned char binSPIspeed[]={0b00000,0b11000,0b11100,0b11101,0b00011,0b01011,0b10011,0b11011}; //00=30,01=125,10=250,11=1000khz, 100=2mhz,101=2.667mhz,  110=4mhz, 111=8mhz; datasheet pg 142
 
 void binSPIversionString(void) {
@@ -574,7 +1009,7 @@ void binSPI(void) {
     static unsigned char inByte, rawCommand, i;
     unsigned int j, fw, fr;
 #ifdef AVR_EXTENDED_COMMANDS
-	unsigned long saddr, length;
+	unsigned long saddr, length, crc;
 #endif
 
     //useful default values
@@ -610,6 +1045,17 @@ void binSPI(void) {
                         IOLAT |= CS; //SPICS=1; //cs disable/high
                         UART1TX(1);
                         break;
+                    case 7: //streaming write-then-read
+                        spiStreamTransfer();
+                        break;
+                    case 0b1011: //timestamped records, all traffic 11
+                        UART1TX(1);
+                        spiSnifferRecords(1);
+                        break;
+                    case 0b1100: //timestamped records, cs low 12
+                        UART1TX(1);
+                        spiSnifferRecords(0);
+                        break;
                     case 0b1101: //all traffic 13
                         UART1TX(1);
                         spiSniffer(1, 0);
@@ -645,11 +1091,10 @@ void binSPI(void) {
                             break;
                         }
 
+                        PERF_BEGIN(PERF_HANDLER_SPI_WRITE_READ);
+
                         //get bytes
-                        for (j = 0; j < fw; j++) {
-                            bus_pirate_configuration.terminal_input[j] = UART1RX();
-                            /* JTR usb port; */;
-                        }
+                        bp_read_buffer(bus_pirate_configuration.terminal_input, fw);
 
                         if (inByte == 4) SPICS = 0;
                         for (j = 0; j < fw; j++) {
@@ -663,10 +1108,10 @@ void binSPI(void) {
 
                         UART1TX(1); //send 1/OK
 
-                        for (j = 0; j < fr; j++) { //send the read buffer contents over serial
-                            UART1TX(bus_pirate_configuration.terminal_input[j]);
-                        }
+                        //send the read buffer contents over serial
+                        bp_write_buffer(bus_pirate_configuration.terminal_input, fr);
 
+                        PERF_END(PERF_HANDLER_SPI_WRITE_READ);
                         break;
 #ifdef AVR_EXTENDED_COMMANDS
                     case 6: // AVR Extended Commands
@@ -682,7 +1127,7 @@ void binSPI(void) {
                             case 0x01: // version check
                                 UART1TX(1); // send 1/OK
                                 UART1TX(0x00);
-                                UART1TX(0x01); // version 1
+                                UART1TX(0x03); // version 3, has the flash CRC32 and programming
                                 break;
                             case 0x02: // bulk memory read from flash
                                 // read in the start address (4 bytes, MSB first)
@@ -733,6 +1178,80 @@ void binSPI(void) {
                                     }
                                 }
                                 break;
+                            case 0x03: // CRC32 of a 25 series flash range
+                                // start address and byte count, 4 bytes each, MSB first
+                                saddr = 0;
+                                for (j = 0; j < 4; j++) 
+                                {
+                                    saddr = (saddr << 8) | UART1RX();
+                                }
+                                length = 0;
+                                for (j = 0; j < 4; j++) 
+                                {
+                                    length = (length << 8) | UART1RX();
+                                }
+
+                                if ((saddr + length) < saddr) 
+                                {
+                                    UART1TX(0); // range wraps around
+                                    break;
+                                }
+
+                                // the CRC follows once the whole range was read,
+                                // several seconds for a large flash
+                                UART1TX(0x01); // send 1/OK
+                                UARTbufFlush();
+
+                                spiFlashWait(); // a page may still be programming
+
+                                SPICS = 0;
+                                if ((saddr + length) > 0x1000000UL) 
+                                {
+                                    spiWriteByte(0x13); // read, 4 byte address
+                                    spiWriteByte(saddr >> 24);
+                                } 
+                                else 
+                                {
+                                    spiWriteByte(0x03); // read
+                                }
+                                spiWriteByte(saddr >> 16);
+                                spiWriteByte(saddr >> 8);
+                                spiWriteByte(saddr);
+
+                                crc = 0xFFFFFFFFUL;
+                                for (; length > 0; length--) 
+                                {
+                                    crc = spiCrc32Update(crc, spiWriteByte(0xff));
+                                }
+                                SPICS = 1;
+                                crc = ~crc;
+
+                                UART1TX(crc >> 24);
+                                UART1TX(crc >> 16);
+                                UART1TX(crc >> 8);
+                                UART1TX(crc);
+                                break;
+                            case 0x04: // SPI flash page program
+                            case 0x05: // SPI flash sector erase
+                                saddr = 0;
+                                for (j = 0; j < 4; j++) 
+                                {
+                                    saddr = (saddr << 8) | UART1RX();
+                                }
+
+                                if (inByte == 0x05) 
+                                {
+                                    UART1TX(spiFlashErase(saddr));
+                                    break;
+                                }
+
+                                j = UART1RX();
+                                j = (j << 8) | UART1RX();
+                                UART1TX(spiFlashProgram(saddr, j));
+                                break;
+                            case 0x06: // wait for the last program or erase to end
+                                UART1TX(spiFlashWait() ? 1 : 0);
+                                break;
                             default:
                                 UART1TX(0);
                                 break;
@@ -749,9 +1268,11 @@ void binSPI(void) {
                 inByte++; //increment by 1, 0=1byte
                 UART1TX(1); //send 1/OK
 
+                PERF_BEGIN(PERF_HANDLER_SPI_BULK);
                 for (i = 0; i < inByte; i++) {
                     UART1TX(spiWriteByte(UART1RX()));
                 }
+                PERF_END(PERF_HANDLER_SPI_BULK);
 
                 break;
             case 0b0100: //configure peripherals w=power, x=pullups, y=AUX, z=CS
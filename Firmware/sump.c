@@ -20,6 +20,7 @@
 #include <stdint.h>
 
 #include "sump.h"
+#include "sump_capture.h"
 
 #ifdef BP_ENABLE_SUMP_SUPPORT
 
@@ -35,8 +36,7 @@
  *
  * @TODO: Add commands 0x0F, 0x9E, 0x9F from the extended SUMP protocol?
  * @TODO: Add "Set trigger configuration" command (0xC2, 0xC6, 0xCA, 0xCE).
- * @TODO: Check why samples are sent out backwards.
- * @TODO: Implement continuous sampling.
+ * @TODO: Implement continuous sampling on v3 (see SUMP_STREAM for v4).
  * @TODO: Remove sump_command_t.left and turn the structure into two separate
  *        fields.
  */
@@ -115,6 +115,34 @@
  */
 #define SUMP_XOFF 0x13
 
+/**
+ * Start streaming samples (Bus Pirate extension, v4 only).
+ *
+ * Samples are sent as they are taken, one byte each, at the rate set with
+ * SUMP_DIV (clamped to BP_SUMP_STREAM_MAXIMUM_SAMPLE_RATE) until any byte is
+ * received from the host.  The stream is framed as follows:
+ *
+ * 'B' 'P' 'S' '1' RATE0 RATE1 RATE2 RATE3      header, rate in Hz, LSB first
+ * 000xxxxx                                     one sample, probes in bits 0-4
+ * SUMP_STREAM_OVERRUN LOST0 LOST1              LOST samples were dropped
+ * SUMP_STREAM_END                              end of the stream
+ *
+ * Samples are dropped when the host does not read fast enough and both CDC
+ * IN buffers are full.  A lost count of 0xFFFF means at least that many.
+ */
+#define SUMP_STREAM 0x0A
+
+/**
+ * Stream marker, followed by the number of dropped samples (16 bits, LSB
+ * first).
+ */
+#define SUMP_STREAM_OVERRUN 0xFE
+
+/**
+ * Stream marker, sent once the host stopped the stream.
+ */
+#define SUMP_STREAM_END 0xFF
+
 /**
  * Set Divider.
  *
@@ -177,6 +205,14 @@
  */
 #define SUMP_FLAGS 0x82
 
+/**
+ * Run-length encoding flag, bit 8 of the SUMP_FLAGS parameter.
+ *
+ * When set, samples sent back may be counts (bit 7 set) telling how many more
+ * times the sample sent right after them occurred.
+ */
+#define SUMP_FLAG_RLE 0x0100
+
 /**
  * Set Trigger Values.
  *
@@ -274,14 +310,72 @@
 
 /**
  * The highest sample rate for the Bus Pirate to sample data at, in Hz.
+ *
+ * This is one sample per instruction cycle, see sump_capture_burst.
+ */
+#define BP_SUMP_MAXIMUM_SAMPLE_RATE 16000000
+
+/**
+ * Sample periods up to this many cycles are taken by the cycle counted loops
+ * in sump_asm.s instead of the timer driven capture engine (1MHz and up).
+ */
+#define BP_SUMP_FAST_MAX_CYCLES 16
+
+/**
+ * Sample period of sump_capture_burst, in cycles (16MHz).
+ */
+#define BP_SUMP_BURST_CYCLES 1
+
+/**
+ * Sample period of sump_capture_fast, in cycles (4MHz).
+ */
+#define BP_SUMP_QUAD_CYCLES 4
+
+/**
+ * Fixed overhead of sump_capture_paced, in cycles per sample.
+ */
+#define BP_SUMP_PACED_BASE_CYCLES 6
+
+/**
+ * sump_capture_burst stores whole PORTB words, so only half as many samples
+ * fit in the sample memory.
  */
-#define BP_SUMP_MAXIMUM_SAMPLE_RATE 1000000
+#define BP_SUMP_BURST_DEPTH (BP_SUMP_SAMPLE_MEMORY_SIZE / 2)
 
 /**
  * How many probes the Bus Pirate can use.
  */
 #define BP_SUMP_PROBES_COUNT 5
 
+/**
+ * Probe bits in a sample, PORTB bits 6 to 10 shifted down.
+ */
+#define BP_SUMP_PROBES_MASK 0x1F
+
+#ifdef BUSPIRATEV4
+
+/**
+ * Shortest sample period allowed when streaming, in instruction cycles.
+ *
+ * 160 cycles (100kHz) leaves the sampling loop enough time to hand full
+ * packets to the USB engine, and stays well under what a full speed bulk
+ * endpoint moves when the host keeps polling it.
+ */
+#define BP_SUMP_STREAM_MIN_CYCLES 160
+
+/**
+ * The highest sample rate for streaming, in Hz.
+ */
+#define BP_SUMP_STREAM_MAXIMUM_SAMPLE_RATE (16000000UL / BP_SUMP_STREAM_MIN_CYCLES)
+
+/**
+ * How often the host input is checked while streaming, as a sample count
+ * mask.
+ */
+#define BP_SUMP_STREAM_INPUT_CHECK_MASK 0x3F
+
+#endif /* BUSPIRATEV4 */
+
 /**
  * SUMP protocol version the Bus Pirate supports.
  */
@@ -310,7 +404,7 @@ static const uint8_t SUMP_METADATA[] = {
     (uint8_t)(((uint32_t)BP_SUMP_SAMPLE_MEMORY_SIZE >> 8) & 0xFF),
     (uint8_t)((uint32_t)BP_SUMP_SAMPLE_MEMORY_SIZE & 0xFF),
 
-    /* Sample rate (1MHz). */
+    /* Sample rate (16MHz). */
 
     SUMP_METADATA_MAXIMUM_SAMPLE_RATE,
     (uint8_t)((uint32_t)BP_SUMP_MAXIMUM_SAMPLE_RATE >> 24),
@@ -339,6 +433,12 @@ static const uint8_t SUMP_DEVICE_ID[] = {'1', 'A', 'L', 'S'};
 
 extern bus_pirate_configuration_t bus_pirate_configuration;
 
+/* Cycle counted sampling loops, see sump_asm.s. */
+extern void sump_capture_burst(uint16_t *buffer, uint16_t count);
+extern void sump_capture_fast(uint8_t *buffer, uint16_t count);
+extern void sump_capture_paced(uint8_t *buffer, uint16_t count,
+                               uint16_t delay);
+
 /**
  * Sampler states.
  */
@@ -347,7 +447,10 @@ typedef enum {
   SAMPLER_IDLE = 0,
 
   /** Sampler is either ready for acquisition or is currently acquiring. */
-  SAMPLER_ARMED
+  SAMPLER_ARMED,
+
+  /** Sampler sends samples out as they are taken. */
+  SAMPLER_STREAMING
 } sump_sampler_state_t;
 
 /**
@@ -401,6 +504,38 @@ static sump_analyzer_command_state_t command_processor_state = RX_COMMAND_IDLE;
  */
 static unsigned int samples_to_acquire;
 
+/**
+ * How many of the acquired samples are to be taken after the trigger fired.
+ */
+static unsigned int samples_after_trigger;
+
+/**
+ * Requested sample period, in instruction cycles.
+ */
+static uint32_t sample_cycles;
+
+/**
+ * Requested sample period in 1/25 instruction cycles, exact for the 100MHz
+ * SUMP clock.  Only used by the fast capture loops.
+ */
+static uint32_t sample_period_x25;
+
+/**
+ * Whether the next acquisition is run-length encoded.
+ */
+static bool rle_enabled;
+
+/**
+ * Ring buffer capture state for the current acquisition.
+ */
+static sump_capture_t capture;
+
+/**
+ * The command being received, kept across calls until all parameter bytes
+ * arrived.
+ */
+static sump_command_t command_buffer;
+
 /**
  * Acquires data from the probes and sends it out to the controlling software.
  *
@@ -408,6 +543,12 @@ static unsigned int samples_to_acquire;
  * value read from the samples_to_acquire variable.  Calling this function
  * where the sampler is not armed will not trigger any action.
  *
+ * Samples are taken continuously into a ring buffer while waiting for the
+ * trigger, so up to samples_to_acquire - samples_after_trigger samples from
+ * before the trigger are sent back too.  If a byte arrives from the host
+ * before the trigger fires, sampling pauses so the command can be handled and
+ * resumes on the next call.
+ *
  * To avoid rewriting interrupt vectors with the bootloader, this firmware
  * currently uses polling to read the trigger and timer.  A final version
  * should use interrupts after lots of testing.
@@ -416,6 +557,34 @@ static unsigned int samples_to_acquire;
  */
 static bool sump_acquire_samples(void);
 
+/**
+ * Acquires samples with one of the cycle counted loops in sump_asm.s.
+ *
+ * Used for sample periods of BP_SUMP_FAST_MAX_CYCLES and less, where the
+ * timer driven engine cannot keep up.  Sampling starts when the trigger
+ * fires, there is no pre-trigger history and no run-length encoding.
+ *
+ * The loops sample every 1 cycle (16MHz, at most BP_SUMP_BURST_DEPTH
+ * samples), 4 cycles (4MHz) or any whole number of cycles from 6 up.  The
+ * longest loop period not above the requested one is used, and the samples
+ * sent are picked from it at the requested period (see
+ * sump_capture_resample_index), so the client's timebase stays right.
+ * Periods that are a multiple of the loop period, such as 8MHz, 5.33MHz or
+ * 2MHz, are exact.  Others, such as 10MHz or 3.2MHz, place each sample
+ * within half a loop period of where it belongs.  If the memory fills
+ * before the window does, the oldest sample is repeated.
+ */
+static void sump_acquire_fast(void);
+
+#ifdef BUSPIRATEV4
+
+/**
+ * Streams samples to the host until it sends a byte, see SUMP_STREAM.
+ */
+static void sump_stream(void);
+
+#endif /* BUSPIRATEV4 */
+
 /**
  * Resets the device to start another buffer acquisition.
  */
@@ -487,9 +656,13 @@ void sump_reset(void) {
   /* Setup timer periods. */
   PR5 = HI16(BP_DEFAULT_TIMER_PERIOD);
   PR4 = LO16(BP_DEFAULT_TIMER_PERIOD);
+  sample_cycles = BP_DEFAULT_TIMER_PERIOD;
+  sample_period_x25 = BP_DEFAULT_TIMER_PERIOD * 25UL;
 
-  /* Default to acquire a full buffer. */
+  /* Default to acquire a full buffer, all of it after the trigger. */
   samples_to_acquire = BP_SUMP_SAMPLE_MEMORY_SIZE;
+  samples_after_trigger = BP_SUMP_SAMPLE_MEMORY_SIZE;
+  rle_enabled = false;
 
   /* Initialize the sampler. */
   sampler_state = SAMPLER_IDLE;
@@ -497,14 +670,6 @@ void sump_reset(void) {
 
 bool sump_handle_command_byte(unsigned char input_byte) {
 
-  /*
-   * The command storage buffer.
-   *
-   * No need to clear it first, as it will be properly initialized upon
-   * receiving a long (5 bytes) command.
-   */
-  sump_command_t command_buffer = {.bytes = {0}, .count = 0, .left = 0};
-
   switch (command_processor_state) {
 
   /* No command bytes received yet, this is the first one. */
@@ -547,6 +712,11 @@ bool sump_handle_command_byte(unsigned char input_byte) {
       /* Set change notification interrupt priority to 1. */
       IPC4bits.CNIP = 1;
 
+      /* Start filling the ring buffer from scratch. */
+      sump_capture_init(&capture, bus_pirate_configuration.terminal_input,
+                        BP_SUMP_SAMPLE_MEMORY_SIZE, samples_to_acquire,
+                        samples_after_trigger, rle_enabled);
+
       /* Update sampler state. */
       sampler_state = SAMPLER_ARMED;
       break;
@@ -556,6 +726,14 @@ bool sump_handle_command_byte(unsigned char input_byte) {
       bp_write_buffer(SUMP_METADATA, sizeof(SUMP_METADATA));
       break;
 
+#ifdef BUSPIRATEV4
+    /* Stream samples instead of capturing them. */
+    case SUMP_STREAM:
+      BP_LEDMODE = ON;
+      sampler_state = SAMPLER_STREAMING;
+      break;
+#endif /* BUSPIRATEV4 */
+
     /* Start/Stop data flow. */
     case SUMP_XON:
     case SUMP_XOFF:
@@ -628,19 +806,39 @@ bool sump_handle_command_byte(unsigned char input_byte) {
       break;
 
     case SUMP_FLAGS:
-      /* @TODO: Fill this? */
+      /*
+       * Only run-length encoding is supported, the probes fit in channel
+       * group 0 and there is no demux, filter or external clock.
+       */
+      rle_enabled =
+          ((((uint16_t)command_buffer.bytes[2] << 8) | command_buffer.bytes[1]) &
+           SUMP_FLAG_RLE) != 0;
       break;
 
-    /* Read requested samples buffer size. */
-    case SUMP_CNT:
-      samples_to_acquire =
-          (((command_buffer.bytes[2] << 8) + command_buffer.bytes[1]) + 1) * 4;
+    /* Read requested samples buffer size and post-trigger count. */
+    case SUMP_CNT: {
+      uint32_t read_count;
+      uint32_t delay_count;
+
+      read_count = ((((uint32_t)command_buffer.bytes[2] << 8) +
+                     command_buffer.bytes[1]) + 1) * 4;
+      delay_count = ((((uint32_t)command_buffer.bytes[4] << 8) +
+                      command_buffer.bytes[3]) + 1) * 4;
 
       /* Clamp sample counter if more bytes are requested. */
-      if (samples_to_acquire > BP_SUMP_SAMPLE_MEMORY_SIZE) {
-        samples_to_acquire = BP_SUMP_SAMPLE_MEMORY_SIZE;
+      if (read_count > BP_SUMP_SAMPLE_MEMORY_SIZE) {
+        read_count = BP_SUMP_SAMPLE_MEMORY_SIZE;
+      }
+
+      /* The trigger cannot be placed before the start of the window. */
+      if (delay_count > read_count) {
+        delay_count = read_count;
       }
+
+      samples_to_acquire = read_count;
+      samples_after_trigger = delay_count;
       break;
+    }
 
     case SUMP_DIV: {
       uint32_t period;
@@ -650,9 +848,13 @@ bool sump_handle_command_byte(unsigned char input_byte) {
        * own 100MHz frequency range to the internal 16MIPs
        * range.
        */
-      period = (((((uint32_t)command_buffer.bytes[3] << 16) +
-                  ((uint32_t)command_buffer.bytes[2] << 8) +
-                  (uint32_t)command_buffer.bytes[1]) + 1) * 4) / 25;
+      sample_period_x25 = ((((uint32_t)command_buffer.bytes[3] << 16) +
+                            ((uint32_t)command_buffer.bytes[2] << 8) +
+                            (uint32_t)command_buffer.bytes[1]) + 1) * 4;
+      period = sample_period_x25 / 25;
+
+      /* The fast capture loops need the exact period, not the timer's. */
+      sample_cycles = period;
 
       /* Round down if needed. */
       if (period > 0x10) {
@@ -679,16 +881,39 @@ bool sump_handle_command_byte(unsigned char input_byte) {
 bool sump_acquire_samples(void) {
   switch (sampler_state) {
 
+#ifdef BUSPIRATEV4
+  case SAMPLER_STREAMING:
+    sump_stream();
+
+    /* Reset the analyzer state. */
+    sump_reset();
+
+    /* Acquisition complete. */
+    return true;
+#endif /* BUSPIRATEV4 */
+
   /* Can start sampling. */
   case SAMPLER_ARMED: {
     size_t offset;
 
-    /* Skip if no interrupt and no trigger set. */
-    if (!IFS1bits.CNIF && CNEN2) {
-      break;
-    }
+    if (sample_cycles <= BP_SUMP_FAST_MAX_CYCLES) {
+
+      /* Wait for the trigger, if one is set. */
+      if (!IFS1bits.CNIF && CNEN2) {
+        break;
+      }
 
-    /* Take samples. */
+      sump_acquire_fast();
+
+      /* Disable change notification for pins 16 to 31. */
+      CNEN2 = 0;
+
+      /* Reset the analyzer state. */
+      sump_reset();
+
+      /* Acquisition complete. */
+      return true;
+    }
 
     /* Start timer #4. */
     T4CONbits.TON = ON;
@@ -696,16 +921,14 @@ bool sump_acquire_samples(void) {
     /* Clear timer #4 interrupt flag. */
     IFS1bits.T5IF = OFF;
 
-    /* Capture samples into the terminal buffer. */
-    for (offset = 0; offset < samples_to_acquire; offset++) {
-      bus_pirate_configuration.terminal_input[offset] = PORTB >> 6;
-
-      /* Wait for timer4 interrupt to trigger. */
-      while (IFS1bits.T5IF == OFF) {
-      }
+    /*
+     * Capture samples into the terminal buffer, triggering right away if no
+     * trigger pin was set.
+     */
+    if (sump_capture_run(&capture, CNEN2 != 0) == SUMP_CAPTURE_ABORTED) {
 
-      /* Clear timer #4 interrupt flag. */
-      IFS1bits.T5IF = OFF;
+      /* Let the caller handle the incoming command, then resume. */
+      break;
     }
 
     /* Disable change notification for pins 16 to 31. */
@@ -714,9 +937,9 @@ bool sump_acquire_samples(void) {
     /* Stop timer #4. */
     T4CON = OFF;
 
-    /* Write captured samples out. */
-    for (offset = samples_to_acquire; offset > 0; offset--) {
-      UART1TX(bus_pirate_configuration.terminal_input[offset - 1]);
+    /* Write captured samples out, newest first. */
+    for (offset = 0; offset < capture.read_count; offset++) {
+      UART1TX(sump_capture_sample(&capture, offset));
     }
 
     /* Reset the analyzer state. */
@@ -736,4 +959,160 @@ bool sump_acquire_samples(void) {
   return false;
 }
 
-#endif /* BP_ENABLE_SUMP_SUPPORT */
\ No newline at end of file
+void sump_acquire_fast(void) {
+  uint8_t *buffer = bus_pirate_configuration.terminal_input;
+  uint16_t period = (uint16_t)sample_period_x25;
+  uint16_t depth = BP_SUMP_SAMPLE_MEMORY_SIZE;
+  uint16_t cycles;
+  uint16_t count;
+  uint16_t offset;
+  uint16_t index;
+
+  /* Longest loop period not above the requested one. */
+  if (period < (BP_SUMP_QUAD_CYCLES * 25)) {
+    cycles = BP_SUMP_BURST_CYCLES;
+    depth = BP_SUMP_BURST_DEPTH;
+  } else if (period < (BP_SUMP_PACED_BASE_CYCLES * 25)) {
+    cycles = BP_SUMP_QUAD_CYCLES;
+  } else {
+    cycles = period / 25;
+  }
+
+  /* Loop samples up to the one the oldest sample of the window comes from. */
+  count = sump_capture_resample_index(samples_to_acquire - 1, period,
+                                      cycles * 25) +
+          1;
+
+  /* The unrolled loops take four samples per iteration. */
+  if (cycles != BP_SUMP_BURST_CYCLES) {
+    count = (count + 3) & ~3;
+  }
+
+  if (count > depth) {
+    count = depth;
+  }
+
+  if (cycles == BP_SUMP_BURST_CYCLES) {
+    uint16_t *words = (uint16_t *)buffer;
+
+    sump_capture_burst(words, count);
+
+    /* Squeeze the PORTB words down to probe bytes, in place. */
+    for (offset = 0; offset < count; offset++) {
+      buffer[offset] = (uint8_t)(words[offset] >> 6);
+    }
+  } else if (cycles == BP_SUMP_QUAD_CYCLES) {
+    sump_capture_fast(buffer, count);
+  } else {
+    sump_capture_paced(buffer, count, cycles - BP_SUMP_PACED_BASE_CYCLES);
+  }
+
+  /* Window samples that were taken, the rest repeats the oldest one. */
+  offset = samples_to_acquire;
+  while ((offset > 0) &&
+         (sump_capture_resample_index(offset - 1, period, cycles * 25) >=
+          count)) {
+    offset--;
+  }
+
+  /* Write captured samples out, newest first. */
+  for (index = offset; index > 0; index--) {
+    UART1TX(buffer[sump_capture_resample_index(index - 1, period,
+                                               cycles * 25)] &
+            BP_SUMP_PROBES_MASK);
+  }
+
+  /* Fill the rest of the window with the oldest sample. */
+  for (; offset < samples_to_acquire; offset++) {
+    UART1TX(buffer[0] & BP_SUMP_PROBES_MASK);
+  }
+}
+
+#ifdef BUSPIRATEV4
+
+void sump_stream(void) {
+  uint32_t period = sample_cycles;
+  uint32_t rate;
+  uint16_t lost = 0;
+  uint16_t taken = 0;
+  uint8_t marker[8];
+  uint8_t sample;
+
+  if (period < BP_SUMP_STREAM_MIN_CYCLES) {
+    period = BP_SUMP_STREAM_MIN_CYCLES;
+  }
+  rate = 16000000UL / period;
+
+  /* Header, the rate actually used may differ from the requested one. */
+  marker[0] = 'B';
+  marker[1] = 'P';
+  marker[2] = 'S';
+  marker[3] = '1';
+  marker[4] = (uint8_t)(rate & 0xFF);
+  marker[5] = (uint8_t)((rate >> 8) & 0xFF);
+  marker[6] = (uint8_t)((rate >> 16) & 0xFF);
+  marker[7] = (uint8_t)(rate >> 24);
+  bp_write_buffer(marker, sizeof(marker));
+  CDC_Flush_In_Now();
+
+  /* Timer #4/#5 as a 32 bits period timer. */
+  T4CON = 0;
+  TMR5HLD = 0;
+  TMR4 = 0;
+  T4CONbits.T32 = ON;
+  PR5 = HI16(period - 1);
+  PR4 = LO16(period - 1);
+  IFS1bits.T5IF = OFF;
+  T4CONbits.TON = ON;
+
+  for (;;) {
+    while (IFS1bits.T5IF == OFF) {
+    }
+    IFS1bits.T5IF = OFF;
+
+    sample = (uint8_t)((PORTB >> 6) & BP_SUMP_PROBES_MASK);
+
+    /* Report dropped samples before sending anything else. */
+    if (lost != 0) {
+      marker[0] = SUMP_STREAM_OVERRUN;
+      marker[1] = (uint8_t)(lost & 0xFF);
+      marker[2] = (uint8_t)(lost >> 8);
+      if (put_cdc_nowait(marker, 3) != 0) {
+        lost = 0;
+      }
+    }
+
+    if ((lost != 0) || (put_cdc_nowait(&sample, 1) == 0)) {
+      if (lost != 0xFFFF) {
+        lost++;
+      }
+    }
+
+    /* Any byte from the host stops the stream. */
+    if (((++taken & BP_SUMP_STREAM_INPUT_CHECK_MASK) == 0) && UART1RXRdy()) {
+      UART1RX();
+      break;
+    }
+  }
+
+  T4CON = OFF;
+
+  if (lost != 0) {
+    marker[0] = SUMP_STREAM_OVERRUN;
+    marker[1] = (uint8_t)(lost & 0xFF);
+    marker[2] = (uint8_t)(lost >> 8);
+    bp_write_buffer(marker, 3);
+  }
+
+  /*
+   * put_cdc_nowait() may have left a full IN buffer behind, the block write
+   * hands it to the endpoint before queueing the end marker.
+   */
+  marker[0] = SUMP_STREAM_END;
+  bp_write_buffer(marker, 1);
+  CDC_Flush_In_Now();
+}
+
+#endif /* BUSPIRATEV4 */
+
+#endif /* BP_ENABLE_SUMP_SUPPORT */
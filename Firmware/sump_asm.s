@@ -0,0 +1,190 @@
+;
+; sump_asm.s
+;
+; Cycle counted sampling loops for the SUMP logic analyzer
+;
+; Published in the public domain.
+; For details see: http://creativecommons.org/publicdomain/zero/1.0/.
+;
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty o
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+;
+;
+; The timer driven capture in sump.c polls T5IF from C, which tops out
+; around 1MHz and wanders by the length of whatever the loop happened to be
+; doing when the period elapsed.  These loops take PORTB at a fixed number
+; of instruction cycles instead, with interrupts masked for the duration of
+; the capture, so consecutive samples are always the same distance apart.
+;
+; Sample spacing, at 16 MIPS:
+;
+;   loop                   cycles      rate          depth    jitter (est.)
+;   sump_capture_burst     1           16MHz         2048     0 cycles
+;   sump_capture_fast      4           4MHz          4096     0 cycles
+;   sump_capture_paced     6 + delay   2.67MHz-1MHz  4096     0 cycles
+;
+; The jitter column is an estimate worked out from the instruction timings
+; (one cycle per instruction, two for a taken branch and for REPEAT plus one
+; per repeated NOP), it has not been measured on hardware: every gap between
+; two PORTB reads executes the same cycle count, including the gap that
+; holds the loop branch.  The only variation left is the phase of the first
+; read relative to the trigger, which is the time sump.c takes to notice
+; CNIF and call in, a few microseconds.
+;
+; Rates in between are picked out of the next faster loop by sump.c, which
+; adds up to half a loop period of placement error per sample.
+;
+
+.ifdef __PIC24FJ256GB106__
+	.equ __24FJ256GB106, 1
+	.include "p24FJ256GB106.inc"
+.endif ; __PIC24FJ256GB106__
+
+.ifdef __PIC24FJ64GA002__
+	.equ __24FJ64GA002, 1
+	.include "p24FJ64GA002.inc"
+.endif ; __PIC24FJ64GA002__
+
+;
+; Probes are PORTB bits 6 (CS) to 10 (AUX)
+;
+.equ PROBES_SHIFT, 6
+
+;
+; Mask all interrupts, old SR is left on the stack
+;
+.macro IRQ_OFF
+		push	SR			; save IPL
+		mov	SR, w7
+		ior	#0x00E0, w7		; IPL = 7
+		mov	w7, SR
+.endm
+
+;
+; Optional extra wait inserted once in every gap between two reads,
+; 2 + w6 cycles long
+;
+.macro GAP_DELAY delayed
+.if \delayed
+		repeat	w6
+		nop
+.endif
+.endm
+
+;
+; Four samples per iteration, one every 4 (+ GAP_DELAY) cycles.
+;
+; Each gap between two reads holds exactly three single cycle slots of
+; work.  The sample read last in an iteration (D) is shifted and stored
+; in the next one, so that the gap around the loop branch only has to
+; hold the counter decrement and the branch itself.
+;
+; Register usage:
+;
+;  w0  : destination pointer
+;  w1  : iterations left + 1
+;  w2  : constant &PORTB
+;  w3  : samples A and C
+;  w4  : sample B
+;  w5  : sample D
+;  w6  : extra delay (paced loop)
+;  w7  : tmp
+;
+.macro CAPTURE_LOOP delayed
+		lsr	w1, #2, w1		; w1 = count / 4 + 1;
+		inc	w1, w1
+		mov	#PORTB, w2		; w2 = &PORTB;
+
+		IRQ_OFF
+
+		; The first sample stands in for the D of iteration 0 and is
+		; followed by the same gap as every other D
+		mov	[w2], w5		; D = PORTB;
+		GAP_DELAY \delayed
+		dec	w1, w1			; w1--;
+		bra	1f			; (2 cycles, as a taken bra nz)
+
+1:
+		mov	[w2], w3		; A = PORTB;		-- 0
+		lsr	w5, #PROBES_SHIFT, w5	; 1
+		mov.b	w5, [w0++]		; *w0++ = D;		2
+		lsr	w3, #PROBES_SHIFT, w3	; 3
+		GAP_DELAY \delayed
+
+		mov	[w2], w4		; B = PORTB;		-- 4
+		mov.b	w3, [w0++]		; *w0++ = A;		5
+		lsr	w4, #PROBES_SHIFT, w4	; 6
+		mov.b	w4, [w0++]		; *w0++ = B;		7
+		GAP_DELAY \delayed
+
+		mov	[w2], w3		; C = PORTB;		-- 8
+		lsr	w3, #PROBES_SHIFT, w3	; 9
+		mov.b	w3, [w0++]		; *w0++ = C;		10
+		nop				; 11
+		GAP_DELAY \delayed
+
+		mov	[w2], w5		; D = PORTB;		-- 12
+		GAP_DELAY \delayed
+		dec	w1, w1			; 13
+		bra	nz, 1b			; 14, 15
+
+		; The last D is left over, the first one took its place
+
+		pop	SR			; restore IPL
+.endm
+
+	.text
+	.global _sump_capture_burst
+	.global _sump_capture_fast
+	.global _sump_capture_paced
+
+;
+; void sump_capture_burst(uint16_t *buffer, uint16_t count)
+;
+; Stores count raw PORTB words, one per cycle.  The caller shifts them down
+; to probe bytes afterwards.
+;
+; Parameters:
+;  w0 : buffer, word aligned
+;  w1 : # of samples, 1 to 16384
+;
+_sump_capture_burst:
+		mov	#PORTB, w2		; w2 = &PORTB;
+		dec	w1, w1			; REPEAT runs w1 + 1 times
+
+		IRQ_OFF
+
+		repeat	w1
+		mov	[w2], [w0++]		; *w0++ = PORTB;
+
+		pop	SR			; restore IPL
+		return
+
+;
+; void sump_capture_fast(uint8_t *buffer, uint16_t count)
+;
+; Stores count probe bytes, one every 4 cycles.
+;
+; Parameters:
+;  w0 : buffer
+;  w1 : # of samples, a multiple of 4
+;
+_sump_capture_fast:
+		CAPTURE_LOOP 0
+		return
+
+;
+; void sump_capture_paced(uint8_t *buffer, uint16_t count, uint16_t delay)
+;
+; Stores count probe bytes, one every 6 + delay cycles.
+;
+; Parameters:
+;  w0 : buffer
+;  w1 : # of samples, a multiple of 4
+;  w2 : delay, 0 to 16383
+;
+_sump_capture_paced:
+		mov	w2, w6			; w6 = delay;
+		CAPTURE_LOOP 1
+		return
@@ -0,0 +1,268 @@
+/*
+ * This file is part of the Bus Pirate project
+ * (http://code.google.com/p/the-bus-pirate/).
+ *
+ * Written and maintained by the Bus Pirate project.
+ *
+ * To the extent possible under law, the project has
+ * waived all copyright and related or neighboring rights to Bus Pirate. This
+ * work is published from United States.
+ *
+ * For details see: http://creativecommons.org/publicdomain/zero/1.0/.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sump_capture.h"
+
+/**
+ * Extracts the five probes from a PORTB value, AUX is bit 4 and CS is bit 0.
+ * The other PORTB bits are dropped so that bit 7 stays free for run-length
+ * counts.
+ */
+#define SUMP_CAPTURE_PROBES(port) ((uint8_t)(((port) >> 6) & 0x1F))
+
+#ifdef SUMP_CAPTURE_HOST
+
+/*
+ * Host build: the simulation provides PORTB, the sample clock, the trigger
+ * flag and the serial receive check.
+ */
+
+extern uint16_t sump_host_read_portb(void);
+extern void sump_host_wait_tick(void);
+extern bool sump_host_trigger_fired(void);
+extern bool sump_host_input_ready(void);
+
+#define SUMP_CAPTURE_READ_PROBES() SUMP_CAPTURE_PROBES(sump_host_read_portb())
+#define SUMP_CAPTURE_WAIT_TICK() sump_host_wait_tick()
+#define SUMP_CAPTURE_TRIGGER_FIRED() sump_host_trigger_fired()
+#define SUMP_CAPTURE_INPUT_READY() sump_host_input_ready()
+
+#define BP_ENABLE_SUMP_SUPPORT
+
+#else
+
+#include "configuration.h"
+
+#ifdef BP_ENABLE_SUMP_SUPPORT
+
+#include "base.h"
+#include "baseIO.h"
+
+/**
+ * Reads the five probes.
+ */
+#define SUMP_CAPTURE_READ_PROBES() SUMP_CAPTURE_PROBES(PORTB)
+
+/**
+ * Waits for the next timer #4/#5 period match and clears its flag.
+ */
+#define SUMP_CAPTURE_WAIT_TICK()                                               \
+  do {                                                                         \
+    while (IFS1bits.T5IF == OFF) {                                             \
+    }                                                                          \
+    IFS1bits.T5IF = OFF;                                                       \
+  } while (0)
+
+/**
+ * Checks the change notification flag, set when a trigger pin changed.
+ */
+#define SUMP_CAPTURE_TRIGGER_FIRED() (IFS1bits.CNIF)
+
+/**
+ * Checks whether the host sent a byte.
+ */
+#define SUMP_CAPTURE_INPUT_READY() (UART1RXRdy())
+
+#endif /* BP_ENABLE_SUMP_SUPPORT */
+
+#endif /* SUMP_CAPTURE_HOST */
+
+#ifdef BP_ENABLE_SUMP_SUPPORT
+
+/**
+ * How often the host input is checked while waiting for the trigger, as a
+ * mask applied to the ring buffer head.  Checking once every 256 samples
+ * keeps the armed loop as short as the post-trigger one.
+ */
+#define SUMP_CAPTURE_INPUT_CHECK_MASK 0x00FF
+
+void sump_capture_init(sump_capture_t *capture, uint8_t *buffer, uint16_t size,
+                       uint16_t read_count, uint16_t delay_count, bool rle) {
+  if (read_count > size) {
+    read_count = size;
+  }
+
+  if (delay_count > read_count || rle) {
+    delay_count = read_count;
+  }
+
+  if (delay_count == 0) {
+    delay_count = 1;
+  }
+
+  capture->buffer = buffer;
+  capture->mask = size - 1;
+  capture->read_count = read_count;
+  capture->delay_count = delay_count;
+  capture->head = 0;
+  capture->stored = 0;
+  capture->trigger = 0;
+  capture->taken = 0;
+  capture->triggered = false;
+  capture->rle = rle;
+}
+
+/**
+ * Run-length encoded variant of sump_capture_run.
+ *
+ * Samples until read_count bytes of the buffer are used, starting at the
+ * trigger.  A count byte is only reserved once a value repeats, so a busy
+ * line costs one byte per sample as in the plain capture.
+ */
+static sump_capture_result_t sump_capture_run_rle(sump_capture_t *capture,
+                                                  bool use_trigger) {
+  uint8_t *buffer = capture->buffer;
+  uint16_t limit = capture->read_count;
+  uint16_t used = 0;
+  uint8_t count = 0;
+  uint8_t value;
+  uint8_t sample;
+
+  /* Wait for the trigger, nothing is kept before it. */
+  while (use_trigger && !SUMP_CAPTURE_TRIGGER_FIRED()) {
+    if (SUMP_CAPTURE_INPUT_READY()) {
+      return SUMP_CAPTURE_ABORTED;
+    }
+
+    SUMP_CAPTURE_WAIT_TICK();
+  }
+
+  capture->triggered = true;
+  capture->trigger = 0;
+
+  value = SUMP_CAPTURE_READ_PROBES();
+  buffer[used++] = value;
+
+  for (;;) {
+    SUMP_CAPTURE_WAIT_TICK();
+    sample = SUMP_CAPTURE_READ_PROBES();
+
+    if ((sample == value) && (count < SUMP_CAPTURE_RLE_MAX_COUNT)) {
+      if (count == 0) {
+        /* First repeat, the count byte needs a slot. */
+        if (used >= limit) {
+          break;
+        }
+        used++;
+      }
+
+      count++;
+      buffer[used - 1] = SUMP_CAPTURE_RLE_FLAG | count;
+    } else {
+      if (used >= limit) {
+        break;
+      }
+
+      value = sample;
+      count = 0;
+      buffer[used++] = value;
+    }
+  }
+
+  capture->head = used & capture->mask;
+  capture->stored = used;
+  capture->taken = used;
+
+  return SUMP_CAPTURE_DONE;
+}
+
+sump_capture_result_t sump_capture_run(sump_capture_t *capture,
+                                       bool use_trigger) {
+  uint8_t *buffer = capture->buffer;
+  uint16_t mask = capture->mask;
+  uint16_t head = capture->head;
+  uint16_t stored = capture->stored;
+
+  if (capture->rle) {
+    return sump_capture_run_rle(capture, use_trigger);
+  }
+
+  /*
+   * Without a trigger there is no history before the first sample, so the
+   * whole window is taken after it instead of padding with the oldest one.
+   */
+  if (!use_trigger) {
+    capture->delay_count = capture->read_count;
+  }
+
+  /* Pre-trigger: fill the ring until the trigger fires. */
+  while (!capture->triggered) {
+    buffer[head] = SUMP_CAPTURE_READ_PROBES();
+
+    if (stored <= mask) {
+      stored++;
+    }
+
+    if (!use_trigger || SUMP_CAPTURE_TRIGGER_FIRED()) {
+      capture->triggered = true;
+      capture->trigger = head;
+      capture->taken = 1;
+    } else if (((head & SUMP_CAPTURE_INPUT_CHECK_MASK) == 0) &&
+               SUMP_CAPTURE_INPUT_READY()) {
+      capture->head = (head + 1) & mask;
+      capture->stored = stored;
+      return SUMP_CAPTURE_ABORTED;
+    }
+
+    head = (head + 1) & mask;
+    SUMP_CAPTURE_WAIT_TICK();
+  }
+
+  /* Post-trigger: take the remaining samples. */
+  while (capture->taken < capture->delay_count) {
+    buffer[head] = SUMP_CAPTURE_READ_PROBES();
+
+    if (stored <= mask) {
+      stored++;
+    }
+
+    capture->taken++;
+    head = (head + 1) & mask;
+    SUMP_CAPTURE_WAIT_TICK();
+  }
+
+  capture->head = head;
+  capture->stored = stored;
+
+  return SUMP_CAPTURE_DONE;
+}
+
+uint8_t sump_capture_sample(const sump_capture_t *capture, uint16_t index) {
+  uint16_t newest = (capture->head - 1) & capture->mask;
+
+  if (capture->rle) {
+    /* The encoded stream starts at the beginning of the buffer. */
+    return capture->buffer[capture->stored - 1 - index];
+  }
+
+  if (index >= capture->stored) {
+    /* Not enough history, repeat the oldest sample. */
+    index = capture->stored - 1;
+  }
+
+  return capture->buffer[(newest - index) & capture->mask];
+}
+
+uint16_t sump_capture_resample_index(uint16_t index, uint16_t period,
+                                     uint16_t base) {
+  return (uint16_t)((((uint32_t)index * period) + (base / 2)) / base);
+}
+
+#endif /* BP_ENABLE_SUMP_SUPPORT */
@@ -0,0 +1,165 @@
+/*
+ * This file is part of the Bus Pirate project
+ * (http://code.google.com/p/the-bus-pirate/).
+ *
+ * Written and maintained by the Bus Pirate project.
+ *
+ * To the extent possible under law, the project has
+ * waived all copyright and related or neighboring rights to Bus Pirate. This
+ * work is published from United States.
+ *
+ * For details see: http://creativecommons.org/publicdomain/zero/1.0/.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef BP_SUMP_CAPTURE_H
+#define BP_SUMP_CAPTURE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Circular SUMP capture engine.
+ *
+ * While armed the sampler writes every sample into a ring buffer, so that
+ * when the trigger fires the samples taken before it are still available.
+ * After the trigger, "delay count" more samples are taken (the trigger sample
+ * included) and the last "read count" samples form the capture window.
+ *
+ * In run-length encoded mode nothing is stored before the trigger.  From the
+ * trigger on, a sample equal to the previous one only bumps a count byte, so
+ * quiet lines cover many more samples in the same memory.  The buffer then
+ * holds, in time order, value bytes optionally followed by a count byte with
+ * bit 7 set: 0x80 | n means the value before it lasted n more samples, for a
+ * total of n + 1.  Runs longer than 128 samples repeat the value.  Sent
+ * newest first, this is the SUMP RLE stream where a count precedes the value
+ * it applies to.
+ *
+ * The engine does not touch any peripheral directly.  Probes, sample clock,
+ * trigger and abort checks go through the SUMP_CAPTURE_* hooks defined in
+ * sump_capture.c, which map to PORTB, timer #4/#5 and the change notification
+ * flag on the Bus Pirate, or to a simulation when built on the host with
+ * SUMP_CAPTURE_HOST defined.
+ */
+
+/**
+ * Capture outcome.
+ */
+typedef enum {
+  /** The trigger fired and all post-trigger samples were taken. */
+  SUMP_CAPTURE_DONE = 0,
+
+  /** A byte arrived from the host before the trigger fired. */
+  SUMP_CAPTURE_ABORTED
+} sump_capture_result_t;
+
+/**
+ * Flag set on count bytes of a run-length encoded capture.
+ */
+#define SUMP_CAPTURE_RLE_FLAG 0x80
+
+/**
+ * Longest run a single count byte can hold.
+ */
+#define SUMP_CAPTURE_RLE_MAX_COUNT 0x7F
+
+/**
+ * Capture state.
+ */
+typedef struct {
+  /** Sample storage, its size must be a power of two. */
+  uint8_t *buffer;
+
+  /** Buffer size minus one, used to wrap indices. */
+  uint16_t mask;
+
+  /** Samples in the capture window. */
+  uint16_t read_count;
+
+  /** Samples to take once the trigger fired, the trigger sample included. */
+  uint16_t delay_count;
+
+  /** Index of the slot the next sample goes into. */
+  uint16_t head;
+
+  /** Samples stored so far, saturating at the buffer size. */
+  uint16_t stored;
+
+  /** Index of the slot holding the trigger sample. */
+  uint16_t trigger;
+
+  /** Samples taken since the trigger fired. */
+  uint16_t taken;
+
+  /** Whether the trigger fired already. */
+  bool triggered;
+
+  /** Whether the buffer holds run-length encoded data. */
+  bool rle;
+} sump_capture_t;
+
+/**
+ * Prepares a capture.
+ *
+ * Counts are clamped so that delay_count <= read_count <= size.
+ *
+ * @param[out] capture the capture state to initialise.
+ * @param[in] buffer the sample storage.
+ * @param[in] size the sample storage size, must be a power of two.
+ * @param[in] read_count how many samples to send back.
+ * @param[in] delay_count how many samples to take after the trigger.
+ * @param[in] rle true to run-length encode the samples, read_count is then
+ *                the number of bytes to fill and delay_count is ignored.
+ */
+void sump_capture_init(sump_capture_t *capture, uint8_t *buffer, uint16_t size,
+                       uint16_t read_count, uint16_t delay_count, bool rle);
+
+/**
+ * Samples into the ring buffer until the capture completes.
+ *
+ * @param[in, out] capture the capture state.
+ * @param[in] use_trigger false to start on the very first sample, all
+ *                        read_count samples are then taken after it.
+ *
+ * @return SUMP_CAPTURE_DONE when the window is complete, or
+ *         SUMP_CAPTURE_ABORTED if the host sent something before the trigger.
+ */
+sump_capture_result_t sump_capture_run(sump_capture_t *capture,
+                                       bool use_trigger);
+
+/**
+ * Returns a sample of the capture window, newest first.
+ *
+ * Index 0 is the last sample taken and read_count - 1 the oldest one, which
+ * is the order SUMP clients expect samples to be sent in.  If the trigger
+ * fired before enough pre-trigger history was collected, the missing oldest
+ * samples repeat the first sample taken.  For a run-length encoded capture
+ * the index is a byte of the encoded stream rather than a sample.
+ *
+ * @param[in] capture the completed capture.
+ * @param[in] index the sample index, from 0 to read_count - 1.
+ *
+ * @return the sample value.
+ */
+uint8_t sump_capture_sample(const sump_capture_t *capture, uint16_t index);
+
+/**
+ * Maps a sample at one period to the nearest sample taken at a shorter one.
+ *
+ * Used when the sampling loop runs faster than the requested rate: sample
+ * index of the requested period lands on the returned index of the loop,
+ * rounded to the nearest loop sample.  Both periods are in the same unit.
+ *
+ * @param[in] index the sample index at the requested period, oldest first.
+ * @param[in] period the requested sample period.
+ * @param[in] base the sampling loop period, not above period.
+ *
+ * @return the loop sample index, oldest first.
+ */
+uint16_t sump_capture_resample_index(uint16_t index, uint16_t period,
+                                     uint16_t base);
+
+#endif /* BP_SUMP_CAPTURE_H */
@@ -0,0 +1,370 @@
+/*
+ * This file is part of the Bus Pirate project
+ * (http://code.google.com/p/the-bus-pirate/).
+ *
+ * Written and maintained by the Bus Pirate project.
+ *
+ * To the extent possible under law, the project has
+ * waived all copyright and related or neighboring rights to Bus Pirate. This
+ * work is published from United States.
+ *
+ * For details see: http://creativecommons.org/publicdomain/zero/1.0/.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/*
+ * Host test of the terminal number formatters in baseIO.c, built for a v3
+ * against the stand-in device header in host/.
+ *
+ * Every byte the formatters send ends up in host_uart_sent[].  The
+ * reference_ functions are the formatters as they were before they rendered
+ * into a buffer, one UART1TX() per character, and send into their own sink.
+ * Both are run over every 16 bit value, a sweep of the 32 bit range and the
+ * edge values, and the bytes must be the same.  A few fixed strings check
+ * the reference itself.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "base.h"
+#include "bus_pirate_core.h"
+
+#define SINK_SIZE 64
+
+bus_pirate_configuration_t bus_pirate_configuration;
+
+host_u1sta_t U1STAbits;
+host_u1mode_t U1MODEbits;
+host_iec0_t IEC0bits;
+host_ifs0_t IFS0bits;
+host_porta_t PORTAbits;
+host_t1con_t T1CONbits;
+uint16_t U1STA;
+uint16_t U1MODE;
+uint16_t U1BRG;
+uint16_t U1RXREG;
+uint16_t TBLPAG;
+uint16_t T1CON;
+uint16_t TMR1;
+uint16_t PR1;
+
+uint8_t host_uart_sent[SINK_SIZE];
+unsigned int host_uart_sent_length;
+
+static uint8_t reference_sent[SINK_SIZE];
+static unsigned int reference_sent_length;
+static int failures;
+
+#define CHECK(cond, ...)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf(" FAIL: " __VA_ARGS__);                                           \
+      printf("\n");                                                            \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static void reference_tx(char c) {
+  reference_sent[reference_sent_length++] = (uint8_t)c;
+}
+
+static void reference_string(const char *string) {
+  while (*string) {
+    reference_tx(*string++);
+  }
+}
+
+static void reference_line(const char *string) {
+  reference_string(string);
+  reference_tx(0x0D);
+  reference_tx(0x0A);
+}
+
+static void reference_bin(unsigned char c) {
+  unsigned char i;
+  unsigned char j = 0x80;
+
+  reference_string("0b");
+  for (i = 0; i < 8; i++) {
+    reference_tx((c & j) ? '1' : '0');
+    j >>= 1;
+  }
+}
+
+static void reference_longdec(uint32_t l) {
+  uint32_t c = 100000000;
+  uint32_t m;
+  unsigned char j;
+  unsigned char k = 0;
+
+  for (j = 0; j < 8; j++) {
+    m = l / c;
+    if (k || m) {
+      reference_tx(m + '0');
+      l = l - (m * c);
+      k = 1;
+    }
+    c /= 10;
+  }
+  reference_tx(l + '0');
+}
+
+static void reference_intdec(uint16_t i) {
+  uint16_t c = 10000;
+  uint16_t m;
+  unsigned char j;
+  unsigned char k = 0;
+
+  for (j = 0; j < 4; j++) {
+    m = i / c;
+    if (k || m) {
+      reference_tx(m + '0');
+      i = i - (m * c);
+      k = 1;
+    }
+    c /= 10;
+  }
+  reference_tx(i + '0');
+}
+
+static void reference_dec(unsigned char c) {
+  unsigned char d = 100;
+  unsigned char j;
+  unsigned char m;
+  unsigned char k = 0;
+
+  for (j = 0; j < 2; j++) {
+    m = c / d;
+    if (k || m) {
+      reference_tx(m + '0');
+      c = c - (m * d);
+      k = 1;
+    }
+    d /= 10;
+  }
+  reference_tx(c + '0');
+}
+
+static void reference_longdecf(uint32_t l) {
+  uint32_t temp;
+  int mld = 0;
+  int mil = 0;
+
+  if (l >= 1000000) {
+    temp = l / 1000000;
+    reference_intdec(temp);
+    reference_tx(',');
+    l %= 1000000;
+    if (l < 1000) {
+      reference_string("000,");
+    }
+    mld = 1;
+    mil = 1;
+  }
+  if (l >= 1000) {
+    temp = l / 1000;
+    if (temp >= 100) {
+      reference_intdec(temp);
+    } else if (mld) {
+      reference_string((temp >= 10) ? "0" : "00");
+      reference_intdec(temp);
+    } else {
+      reference_intdec(temp);
+    }
+    reference_tx(',');
+    l %= 1000;
+    mil = 1;
+  }
+  if (l >= 100) {
+    reference_intdec(l);
+  } else if (mil) {
+    reference_string((l >= 10) ? "0" : "00");
+    reference_intdec(l);
+  } else {
+    reference_intdec(l);
+  }
+}
+
+static void reference_hex(uint16_t c) {
+  static const char hex[] = "0123456789ABCDEF";
+
+  reference_string("0x");
+  reference_tx(hex[(c >> 4) & 0x0F]);
+  reference_tx(hex[c & 0x0F]);
+}
+
+static void reference_inthex(uint16_t c) {
+  static const char hex[] = "0123456789ABCDEF";
+
+  reference_string("0x");
+  reference_tx(hex[(c >> 12) & 0x0F]);
+  reference_tx(hex[(c >> 8) & 0x0F]);
+  reference_tx(hex[(c >> 4) & 0x0F]);
+  reference_tx(hex[c & 0x0F]);
+}
+
+static void reference_volts(uint16_t adc) {
+  const uint16_t centivolt = (adc * 29) / 45;
+
+  reference_dec(centivolt / 100);
+  reference_tx('.');
+  if ((centivolt % 100) < 10) {
+    reference_tx('0');
+  }
+  reference_dec(centivolt % 100);
+}
+
+typedef enum {
+  FORMAT_LONGDEC,
+  FORMAT_LONGDECF,
+  FORMAT_INTDEC,
+  FORMAT_DEC,
+  FORMAT_HEX,
+  FORMAT_INTHEX,
+  FORMAT_BIN,
+  FORMAT_VOLTS,
+  FORMAT_COUNT
+} format_t;
+
+static const char *const format_names[FORMAT_COUNT] = {
+    "bpWlongdec", "bpWlongdecf", "bpWintdec", "bpWdec",
+    "bpWhex",     "bpWinthex",   "bpWbin",    "bpWvolts"};
+
+static void run(format_t format, uint32_t value) {
+  host_uart_sent_length = 0;
+  reference_sent_length = 0;
+
+  switch (format) {
+  case FORMAT_LONGDEC:
+    bpWlongdec(value);
+    reference_longdec(value);
+    break;
+  case FORMAT_LONGDECF:
+    bpWlongdecf(value);
+    reference_longdecf(value);
+    break;
+  case FORMAT_INTDEC:
+    bpWintdec((uint16_t)value);
+    reference_intdec((uint16_t)value);
+    break;
+  case FORMAT_DEC:
+    bpWdec((uint8_t)value);
+    reference_dec((uint8_t)value);
+    break;
+  case FORMAT_HEX:
+    bpWhex((uint16_t)value);
+    reference_hex((uint16_t)value);
+    break;
+  case FORMAT_INTHEX:
+    bpWinthex((uint16_t)value);
+    reference_inthex((uint16_t)value);
+    break;
+  case FORMAT_BIN:
+    bpWbin((uint8_t)value);
+    reference_bin((uint8_t)value);
+    break;
+  case FORMAT_VOLTS:
+    /* the ADC is 10 bits */
+    bpWvolts(value & 0x3FF);
+    reference_volts(value & 0x3FF);
+    break;
+  default:
+    break;
+  }
+}
+
+static bool same(void) {
+  return (host_uart_sent_length == reference_sent_length) &&
+         (memcmp(host_uart_sent, reference_sent, reference_sent_length) == 0);
+}
+
+static void compare(format_t format, uint32_t value) {
+  run(format, value);
+  CHECK(same(), "%s(%u) sent '%.*s', expected '%.*s'", format_names[format],
+        value, (int)host_uart_sent_length, host_uart_sent,
+        (int)reference_sent_length, reference_sent);
+}
+
+static void expect(format_t format, uint32_t value, const char *text) {
+  run(format, value);
+  CHECK(reference_sent_length == strlen(text) &&
+            memcmp(reference_sent, text, reference_sent_length) == 0,
+        "%s(%u) reference sent '%.*s', expected '%s'", format_names[format],
+        value, (int)reference_sent_length, reference_sent, text);
+  CHECK(same(), "%s(%u) sent '%.*s', expected '%s'", format_names[format],
+        value, (int)host_uart_sent_length, host_uart_sent, text);
+}
+
+static void test_known_values(void) {
+  expect(FORMAT_LONGDEC, 0, "0");
+  expect(FORMAT_LONGDEC, 123456789, "123456789");
+  /* values from 10^9 have a first "digit" over 9, kept as it always was */
+  expect(FORMAT_LONGDEC, 4294967295UL, "Z94967295");
+  expect(FORMAT_LONGDECF, 1234567, "1,234,567");
+  expect(FORMAT_LONGDECF, 1000001, "1,000,001");
+  expect(FORMAT_LONGDECF, 5020, "5,020");
+  expect(FORMAT_INTDEC, 65535, "65535");
+  expect(FORMAT_DEC, 7, "7");
+  expect(FORMAT_HEX, 0xA5, "0xA5");
+  expect(FORMAT_INTHEX, 0xBEEF, "0xBEEF");
+  expect(FORMAT_BIN, 0xA5, "0b10100101");
+  expect(FORMAT_VOLTS, 1023, "6.59");
+  expect(FORMAT_VOLTS, 20, "0.12");
+}
+
+static void test_sweep(void) {
+  static const uint32_t edges[] = {
+      0,          9,          10,         99,         100,
+      999,        1000,       9999,       10000,      65535,
+      65536,      99999,      100000,     999999,     1000000,
+      9999999,    10000000,   99999999,   100000000,  999999999,
+      1000000000, 2147483647, 2147483648, 4294967295UL};
+  unsigned int format;
+  unsigned int i;
+  uint32_t value;
+
+  for (format = 0; format < FORMAT_COUNT; format++) {
+    for (value = 0; value <= 0xFFFF; value++) {
+      compare(format, value);
+    }
+    for (i = 0; i < sizeof(edges) / sizeof(edges[0]); i++) {
+      compare(format, edges[i]);
+    }
+  }
+
+  for (value = 0; value < 4294967295UL - 1000003; value += 1000003) {
+    compare(FORMAT_LONGDEC, value);
+    compare(FORMAT_LONGDECF, value);
+  }
+}
+
+static void test_strings(void) {
+  host_uart_sent_length = 0;
+  reference_sent_length = 0;
+  bp_write_line("abc");
+  bp_write_string("de");
+  reference_line("abc");
+  reference_string("de");
+  CHECK(same(), "bp_write_line/bp_write_string sent '%.*s'",
+        (int)host_uart_sent_length, host_uart_sent);
+}
+
+int main(void) {
+  test_known_values();
+  test_sweep();
+  test_strings();
+
+  if (failures) {
+    printf("%d checks failed\n", failures);
+    return 1;
+  }
+
+  printf("baseIO formatter tests passed\n");
+  return 0;
+}
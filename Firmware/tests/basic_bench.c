@@ -0,0 +1,108 @@
+/*
+ * This file is part of the Bus Pirate project
+ * (http://code.google.com/p/the-bus-pirate/).
+ *
+ * Written and maintained by the Bus Pirate project.
+ *
+ * To the extent possible under law, the project has
+ * waived all copyright and related or neighboring rights to Bus Pirate. This
+ * work is published from United States.
+ *
+ * For details see: http://creativecommons.org/publicdomain/zero/1.0/.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/*
+ * Host benchmark of the BASIC interpreter, see basic_bench.sh.
+ *
+ * Times a loop of LOOP_COUNT iterations placed after the given number of
+ * lines, so that each jump back has to get past them, and entering
+ * ENTER_COUNT lines at the prompt.  Times are the best of RUNS runs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "basic_host.h"
+
+#define LOOP_COUNT 30000
+#define ENTER_COUNT 2000
+#define RUNS 5
+
+static double elapsed_ms(clock_t start) {
+  return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static double time_entering(void) {
+  clock_t start;
+  int i;
+
+  basic_host_reset();
+  start = clock();
+  for (i = 0; i < ENTER_COUNT; i++) {
+    basic_host_enter("10 IF A<100 THEN GOSUB 20 ELSE PRINT A");
+  }
+  return elapsed_ms(start);
+}
+
+static double time_loop(int lines_before) {
+  char line[48];
+  clock_t start;
+  double t;
+  int i;
+
+  basic_host_reset();
+  basic_host_enter("10 LET A=0");
+  for (i = 0; i < lines_before; i++) {
+    snprintf(line, sizeof(line), "%d LET B=%d", 100 + (i * 10), i);
+    basic_host_enter(line);
+  }
+  basic_host_enter("5000 LET A=A+1");
+  snprintf(line, sizeof(line), "5010 IF A<%d THEN GOTO 5000", LOOP_COUNT);
+  basic_host_enter(line);
+  basic_host_enter("5020 PRINT A");
+  basic_host_enter("5030 END");
+
+  start = clock();
+  basic_host_enter("RUN");
+  t = elapsed_ms(start);
+
+  snprintf(line, sizeof(line), "%d\r\n", LOOP_COUNT);
+  if (!basic_host_printed(line)) {
+    fprintf(stderr, "the loop printed '%s'\n", basic_host_output());
+    exit(1);
+  }
+  return t;
+}
+
+int main(int argc, char **argv) {
+  double loop = 0;
+  double entering = 0;
+  double t;
+  int lines_before;
+  int i;
+
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s lines_before_the_loop\n", argv[0]);
+    return 1;
+  }
+  lines_before = atoi(argv[1]);
+
+  for (i = 0; i < RUNS; i++) {
+    t = time_loop(lines_before);
+    if (i == 0 || t < loop) {
+      loop = t;
+    }
+    t = time_entering();
+    if (i == 0 || t < entering) {
+      entering = t;
+    }
+  }
+
+  printf("%d %.1f %.1f\n", lines_before, loop, entering);
+  return 0;
+}
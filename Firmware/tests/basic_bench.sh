@@ -0,0 +1,35 @@
+#!/bin/sh
+#
+# Times the BASIC interpreter built on the host with basic_bench.c, basic.c
+# of a git revision against the one in the working tree, e.g. for the change
+# that added the line index:
+#
+#   Firmware/tests/basic_bench.sh <revision before the change>
+#
+# The loop times are for 30000 GOTOs back over the given number of lines,
+# the entry time for 2000 lines typed at the prompt.
+
+set -e
+
+if [ $# -ne 1 ]; then
+	echo "usage: $0 revision" >&2
+	exit 1
+fi
+
+cd "$(dirname "$0")"
+
+CC=${CC:-cc}
+FLAGS="-O2 -fgnu89-inline -D__PIC24FJ256GB106__ -Ihost -I.."
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+git show "$1:Firmware/basic.c" > "$TMP/basic.c"
+$CC $FLAGS -o "$TMP/before" basic_bench.c basic_host.c "$TMP/basic.c"
+$CC $FLAGS -o "$TMP/after" basic_bench.c basic_host.c ../basic.c
+
+printf "%6s %12s %12s\n" lines before after
+for lines in 0 30 60 90; do
+	set -- $("$TMP/before" $lines) $("$TMP/after" $lines)
+	printf "%6s %10sms %10sms\n" $lines $2 $5
+done
+printf "%6s %10sms %10sms\n" entry $3 $6
@@ -0,0 +1,381 @@
+/*
+ * This file is part of the Bus Pirate project
+ * (http://code.google.com/p/the-bus-pirate/).
+ *
+ * Written and maintained by the Bus Pirate project.
+ *
+ * To the extent possible under law, the project has
+ * waived all copyright and related or neighboring rights to Bus Pirate. This
+ * work is published from United States.
+ *
+ * For details see: http://creativecommons.org/publicdomain/zero/1.0/.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/*
+ * Host test of the BASIC SAVE, LOAD and FORMAT commands against a simulated
+ * 24LC256 on the bit banged I2C pins, built with BP_BASIC_I2C_FILESYSTEM.
+ *
+ * basic.c drives SDA and SCL through LATD and TRISD and calls bp_delay_us()
+ * after each change, so the model looks at the bus there and keeps the time.
+ * It acknowledges, takes page writes on the STOP, NACKs its address for
+ * EEPROM_TWC_US after each of them, and does random and sequential reads.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "base.h"
+#include "basic.h"
+
+#include "basic_host.h"
+
+#define EEPROM_SIZE 0x8000
+#define EEPROM_PAGE 64
+#define EEPROM_ADDRESS 0xA0
+/* the longest write cycle (tWC) in the datasheet */
+#define EEPROM_TWC_US 5000
+
+#define SDA 0x01
+#define SCL 0x02
+
+#define SLOT 3
+
+extern unsigned char pgmspace[];
+
+uint16_t LATD;
+uint16_t TRISD = SDA | SCL;
+
+static int failures;
+
+#define CHECK(cond, ...)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf(" FAIL: " __VA_ARGS__);                                           \
+      printf("\n");                                                            \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static struct {
+  uint8_t memory[EEPROM_SIZE];
+  uint8_t page[EEPROM_PAGE];
+  unsigned long now_us;
+  unsigned long busy_until_us;
+  /* the write cycle never ends */
+  bool wedged;
+  bool present;
+  /* what the model drives on SDA, 1 is released */
+  int sda_out;
+  int last_sda;
+  int last_scl;
+  bool active;
+  bool reading;
+  bool read_started;
+  int bit;
+  int byte_count;
+  unsigned int shift;
+  unsigned int address;
+  unsigned int page_start;
+  unsigned int page_count;
+  /* what the test looks at */
+  int page_writes;
+  int crossing_writes;
+  int busy_polls;
+} eeprom;
+
+static int pin(int mask) {
+  /* open collector, pulled up unless driven low */
+  return ((TRISD & mask) || (LATD & mask)) ? 1 : 0;
+}
+
+static int sda_line(void) { return pin(SDA) & eeprom.sda_out; }
+
+uint16_t host_read_portd(void) {
+  return (sda_line() ? SDA : 0) | (pin(SCL) ? SCL : 0);
+}
+
+static void eeprom_write_cycle(void) {
+  unsigned int i;
+
+  for (i = 0; i < eeprom.page_count && i < EEPROM_PAGE; i++) {
+    /* the address wraps inside the page */
+    eeprom.memory[(eeprom.page_start & ~(EEPROM_PAGE - 1)) |
+                  ((eeprom.page_start + i) & (EEPROM_PAGE - 1))] =
+        eeprom.page[i];
+  }
+  if ((eeprom.page_start % EEPROM_PAGE) + eeprom.page_count > EEPROM_PAGE) {
+    eeprom.crossing_writes++;
+  }
+  eeprom.page_writes++;
+  eeprom.busy_until_us = eeprom.now_us + EEPROM_TWC_US;
+}
+
+static bool eeprom_busy(void) {
+  return eeprom.wedged ? (eeprom.page_writes > 0)
+                       : (eeprom.now_us < eeprom.busy_until_us);
+}
+
+/* the master wrote a byte, tells whether it is acknowledged */
+static bool eeprom_take_byte(uint8_t byte) {
+  switch (eeprom.byte_count++) {
+  case 0:
+    if (!eeprom.present || (byte & 0xFE) != EEPROM_ADDRESS) {
+      return false;
+    }
+    if (eeprom_busy()) {
+      eeprom.busy_polls++;
+      return false;
+    }
+    eeprom.reading = byte & 0x01;
+    eeprom.read_started = false;
+    return true;
+  case 1:
+    eeprom.address = (byte & 0x7F) << 8;
+    return true;
+  case 2:
+    eeprom.address |= byte;
+    eeprom.page_start = eeprom.address;
+    eeprom.page_count = 0;
+    return true;
+  default:
+    eeprom.page[eeprom.page_count++ % EEPROM_PAGE] = byte;
+    return true;
+  }
+}
+
+static void eeprom_scl_rising(int sda) {
+  if (eeprom.bit < 8) {
+    if (!eeprom.reading) {
+      eeprom.shift = (eeprom.shift << 1) | sda;
+    }
+  } else if (eeprom.reading && sda) {
+    /* NACK from the master ends the read */
+    eeprom.active = false;
+  }
+  eeprom.bit++;
+}
+
+static void eeprom_scl_falling(void) {
+  if (eeprom.bit == 8) {
+    if (eeprom.reading && eeprom.read_started) {
+      /* the master acknowledges */
+      eeprom.sda_out = 1;
+    } else if (eeprom_take_byte(eeprom.shift & 0xFF)) {
+      eeprom.sda_out = 0;
+    } else {
+      eeprom.sda_out = 1;
+      eeprom.active = false;
+    }
+  } else if (eeprom.bit == 9) {
+    eeprom.bit = 0;
+    eeprom.shift = 0;
+    eeprom.sda_out = 1;
+    if (eeprom.reading) {
+      if (eeprom.read_started) {
+        eeprom.address = (eeprom.address + 1) % EEPROM_SIZE;
+      }
+      eeprom.read_started = true;
+    }
+  }
+
+  if (eeprom.active && eeprom.reading && eeprom.bit < 8) {
+    eeprom.sda_out = (eeprom.memory[eeprom.address] >> (7 - eeprom.bit)) & 1;
+  }
+}
+
+void bp_delay_us(unsigned int microseconds) {
+  const int sda = sda_line();
+  const int scl = pin(SCL);
+
+  if (scl && eeprom.last_scl && eeprom.last_sda && !sda) {
+    /* START, or a repeated one */
+    eeprom.active = true;
+    eeprom.reading = false;
+    eeprom.bit = 0;
+    eeprom.byte_count = 0;
+    eeprom.shift = 0;
+    eeprom.sda_out = 1;
+  } else if (scl && eeprom.last_scl && !eeprom.last_sda && sda) {
+    /* STOP, a write with data after the address starts the write cycle */
+    if (eeprom.active && !eeprom.reading && eeprom.byte_count > 3) {
+      eeprom_write_cycle();
+    }
+    eeprom.active = false;
+    eeprom.sda_out = 1;
+  } else if (eeprom.active && scl && !eeprom.last_scl) {
+    eeprom_scl_rising(sda);
+  } else if (eeprom.active && !scl && eeprom.last_scl) {
+    eeprom_scl_falling();
+  }
+
+  eeprom.last_sda = sda_line();
+  eeprom.last_scl = scl;
+  eeprom.now_us += microseconds;
+}
+
+static void eeprom_reset(void) {
+  memset(&eeprom, 0, sizeof(eeprom));
+  memset(eeprom.memory, 0xFF, sizeof(eeprom.memory));
+  eeprom.present = true;
+  eeprom.sda_out = 1;
+  eeprom.last_sda = 1;
+  eeprom.last_scl = 1;
+  LATD = 0;
+  TRISD = SDA | SCL;
+}
+
+static uint16_t crc16(const uint8_t *data, size_t length) {
+  uint16_t crc = 0xFFFF;
+  size_t i;
+  int j;
+
+  for (i = 0; i < length; i++) {
+    crc ^= data[i] << 8;
+    for (j = 0; j < 8; j++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+static size_t message_of(void (*send)(void)) {
+  basic_host_reset_output();
+  send();
+  return basic_host_last_message();
+}
+
+static void send_timeout(void) { BPMSG1286; }
+static void send_invalid_slot(void) { BPMSG1057; }
+static void send_no_eeprom(void) { BPMSG1053; }
+
+static void fill_program(uint8_t *program) {
+  int i;
+
+  for (i = 0; i < PGMSIZE; i++) {
+    program[i] = (uint8_t)rand();
+  }
+  memcpy(pgmspace, program, PGMSIZE);
+}
+
+static void test_save_load(void) {
+  static uint8_t program[PGMSIZE];
+  const uint8_t *stored = eeprom.memory + (SLOT * PGMSIZE);
+  uint16_t crc;
+
+  eeprom_reset();
+  fill_program(program);
+  crc = crc16(program, PGMSIZE);
+
+  basic_host_reset_output();
+  basic_host_enter("SAVE 3");
+  CHECK(memcmp(stored, program, PGMSIZE) == 0, "SAVE, slot %d differs", SLOT);
+  CHECK(eeprom.memory[SLOT * 2] == (crc >> 8) &&
+            eeprom.memory[(SLOT * 2) + 1] == (crc & 0xFF),
+        "SAVE, stored CRC %02X%02X, expected %04X", eeprom.memory[SLOT * 2],
+        eeprom.memory[(SLOT * 2) + 1], crc);
+  /* one write per page and the CRC */
+  CHECK(eeprom.page_writes == (PGMSIZE / EEPROM_PAGE) + 1,
+        "SAVE, %d page writes", eeprom.page_writes);
+  CHECK(eeprom.crossing_writes == 0, "SAVE, %d writes crossed a page",
+        eeprom.crossing_writes);
+  CHECK(eeprom.busy_polls > 0, "SAVE did not poll the write cycle");
+  CHECK(basic_host_last_message() != message_of(send_timeout),
+        "SAVE timed out: '%s'", basic_host_output());
+
+  memset(pgmspace, 0, PGMSIZE);
+  basic_host_reset_output();
+  basic_host_enter("LOAD 3");
+  CHECK(memcmp(pgmspace, program, PGMSIZE) == 0, "LOAD, program differs");
+  CHECK(!basic_host_printed("Checksum error"), "LOAD printed '%s'",
+        basic_host_output());
+}
+
+static void test_checksum_error(void) {
+  static uint8_t program[PGMSIZE];
+  static uint8_t cleared[PGMSIZE];
+
+  eeprom_reset();
+  basic_host_reset();
+  memcpy(cleared, pgmspace, PGMSIZE);
+  fill_program(program);
+  basic_host_enter("SAVE 3");
+  eeprom.memory[(SLOT * PGMSIZE) + 500] ^= 0x01;
+
+  basic_host_reset_output();
+  basic_host_enter("LOAD 3");
+  CHECK(basic_host_printed("Checksum error"), "corrupted LOAD printed '%s'",
+        basic_host_output());
+  CHECK(memcmp(pgmspace, cleared, PGMSIZE) == 0,
+        "corrupted LOAD left the program");
+}
+
+/* the slots are PGMSIZE bytes, slot 0 holds the CRCs */
+static void test_invalid_slot(void) {
+  static uint8_t program[PGMSIZE];
+  size_t message = message_of(send_invalid_slot);
+
+  eeprom_reset();
+  fill_program(program);
+  basic_host_reset_output();
+  basic_host_enter("SAVE 32");
+  CHECK(basic_host_last_message() == message, "SAVE 32 printed '%s'",
+        basic_host_output());
+  CHECK(eeprom.page_writes == 0, "SAVE 32 wrote %d pages", eeprom.page_writes);
+}
+
+static void test_no_eeprom(void) {
+  size_t message = message_of(send_no_eeprom);
+
+  eeprom_reset();
+  eeprom.present = false;
+  basic_host_reset_output();
+  basic_host_enter("SAVE 3");
+  CHECK(basic_host_last_message() == message, "SAVE without EEPROM printed '%s'",
+        basic_host_output());
+}
+
+/* a write cycle that never ends gives an error, not a hang */
+static void test_timeout(const char *command) {
+  static uint8_t program[PGMSIZE];
+  size_t message = message_of(send_timeout);
+  unsigned long waited;
+
+  eeprom_reset();
+  eeprom.wedged = true;
+  fill_program(program);
+  basic_host_reset_output();
+  basic_host_enter(command);
+  CHECK(basic_host_last_message() == message, "wedged %s printed '%s'", command,
+        basic_host_output());
+  CHECK(eeprom.page_writes == 1, "wedged %s wrote %d pages", command,
+        eeprom.page_writes);
+  /* polls for longer than a write cycle, short enough not to look hung */
+  waited = eeprom.now_us - (eeprom.busy_until_us - EEPROM_TWC_US);
+  CHECK(waited > 2 * EEPROM_TWC_US && waited < 50000,
+        "wedged %s gave up after %luus", command, waited);
+}
+
+int main(void) {
+  srand(1);
+
+  test_save_load();
+  test_checksum_error();
+  test_invalid_slot();
+  test_no_eeprom();
+  test_timeout("SAVE 3");
+  test_timeout("FORMAT");
+
+  if (failures) {
+    printf("%d checks failed\n", failures);
+    return 1;
+  }
+
+  printf("basic EEPROM tests passed\n");
+  return 0;
+}
@@ -0,0 +1,169 @@
+/*
+ * This file is part of the Bus Pirate project
+ * (http://code.google.com/p/the-bus-pirate/).
+ *
+ * Written and maintained by the Bus Pirate project.
+ *
+ * To the extent possible under law, the project has
+ * waived all copyright and related or neighboring rights to Bus Pirate. This
+ * work is published from United States.
+ *
+ * For details see: http://creativecommons.org/publicdomain/zero/1.0/.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/*
+ * The parts of the firmware basic.c calls, for a host build.  The number
+ * formatters print as the board does for a 16 bit int, the command line
+ * functions take what the terminal hands to basiccmdline(), a line and its
+ * NUL terminator, and there is no bus: programs under test must not use
+ * the bus statements.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "base.h"
+#include "AUXpin.h"
+#include "basic.h"
+#include "bus_pirate_core.h"
+#include "procMenu.h"
+
+#include "basic_host.h"
+
+#define OUTPUT_SIZE 65536
+
+bus_pirate_configuration_t bus_pirate_configuration;
+mode_configuration_t mode_configuration;
+bus_pirate_protocol_t protos[MAXPROTO];
+
+host_portb_t PORTBbits;
+host_porte_t PORTEbits;
+host_trisb_t TRISBbits;
+host_trise_t TRISEbits;
+host_ad1con1_t AD1CON1bits;
+
+int PWMfreq;
+int PWMduty;
+
+char cmdbuf[BP_COMMAND_BUFFER_SIZE];
+unsigned int cmdstart;
+unsigned int cmdend;
+
+static char output[OUTPUT_SIZE];
+static size_t output_length;
+static size_t last_message = BASIC_HOST_NO_MESSAGE;
+
+void basic_host_reset(void) {
+  bp_clear_basic_program_area();
+  basic_host_reset_output();
+}
+
+void basic_host_reset_output(void) {
+  output_length = 0;
+  output[0] = '\0';
+  last_message = BASIC_HOST_NO_MESSAGE;
+}
+
+void basic_host_enter(const char *line) {
+  size_t length = strlen(line);
+
+  memcpy(cmdbuf, line, length + 1);
+  cmdstart = 0;
+  cmdend = (length + 1) & CMDLENMSK;
+  basiccmdline();
+}
+
+const char *basic_host_output(void) { return output; }
+
+bool basic_host_printed(const char *text) {
+  return strstr(output, text) != NULL;
+}
+
+size_t basic_host_last_message(void) { return last_message; }
+
+void UART1TX(char c) {
+  if (bus_pirate_configuration.quiet) {
+    return;
+  }
+  if (output_length < OUTPUT_SIZE - 1) {
+    output[output_length++] = c;
+    output[output_length] = '\0';
+  }
+}
+
+void bp_write_string(const char *string) {
+  while (*string) {
+    UART1TX(*string++);
+  }
+}
+
+void bp_write_line(const char *string) {
+  bp_write_string(string);
+  UART1TX(0x0D);
+  UART1TX(0x0A);
+}
+
+void bp_message_write_buffer(size_t offset, size_t length) {
+  char text[32];
+
+  last_message = offset;
+  snprintf(text, sizeof(text), "<%zu>", offset);
+  bp_write_string(text);
+}
+
+void bp_message_write_line(size_t offset, size_t length) {
+  bp_message_write_buffer(offset, length);
+  bp_write_line("");
+}
+
+void bpWintdec(unsigned int i) {
+  char text[8];
+
+  snprintf(text, sizeof(text), "%u", (uint16_t)i);
+  bp_write_string(text);
+}
+
+void bpWdec(unsigned char c) { bpWintdec(c); }
+
+void bpWhex(unsigned int c) {
+  char text[8];
+
+  snprintf(text, sizeof(text), "0x%02X", (uint8_t)c);
+  bp_write_string(text);
+}
+
+void consumewhitechars(void) {
+  while (cmdbuf[cmdstart] == ' ') {
+    cmdstart = (cmdstart + 1) & CMDLENMSK;
+  }
+}
+
+int getint(void) {
+  int number = 0;
+
+  while ((cmdbuf[cmdstart] >= '0') && (cmdbuf[cmdstart] <= '9')) {
+    number = (number * 10) + (cmdbuf[cmdstart] - '0');
+    cmdstart = (cmdstart + 1) & CMDLENMSK;
+  }
+
+  return number;
+}
+
+int getnumber(int def, int min, int max, int x) { return def; }
+
+void bp_delay_ms(unsigned int milliseconds) {}
+
+unsigned int bp_read_adc(unsigned int channel) { return 0; }
+
+void bpAuxHigh(void) {}
+
+void bpAuxLow(void) {}
+
+unsigned int bpAuxRead(void) { return 0; }
+
+void updatePWM(void) {}
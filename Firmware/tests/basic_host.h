@@ -0,0 +1,67 @@
+/*
+ * This file is part of the Bus Pirate project
+ * (http://code.google.com/p/the-bus-pirate/).
+ *
+ * Written and maintained by the Bus Pirate project.
+ *
+ * To the extent possible under law, the project has
+ * waived all copyright and related or neighboring rights to Bus Pirate. This
+ * work is published from United States.
+ *
+ * For details see: http://creativecommons.org/publicdomain/zero/1.0/.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#ifndef BP_TESTS_BASIC_HOST_H
+#define BP_TESTS_BASIC_HOST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Host environment for basic.c, built for a v4: the terminal, the command
+ * line and the rest of the firmware the interpreter calls.  Terminal output
+ * is kept, as the board would show it, until basic_host_reset().
+ */
+
+/**
+ * Clears the program area and the kept terminal output.
+ */
+void basic_host_reset(void);
+
+/**
+ * Clears the kept terminal output, the program stays.
+ */
+void basic_host_reset_output(void);
+
+/**
+ * Hands a line to the interpreter as if it was typed in BASIC mode.
+ *
+ * @param[in] line the line, without the line ending.
+ */
+void basic_host_enter(const char *line);
+
+/**
+ * Terminal output since the last reset, NUL terminated.
+ */
+const char *basic_host_output(void);
+
+/**
+ * Tells whether the terminal output since the last reset contains a string.
+ *
+ * @param[in] text the string to look for.
+ */
+bool basic_host_printed(const char *text);
+
+/**
+ * Offset of the last packed message (BPMSGxxxx) sent, to compare with the
+ * one a BPMSGxxxx macro sends.  BASIC_HOST_NO_MESSAGE after a reset.
+ */
+size_t basic_host_last_message(void);
+
+#define BASIC_HOST_NO_MESSAGE ((size_t)-1)
+
+#endif /* BP_TESTS_BASIC_HOST_H */
@@ -0,0 +1,187 @@
+/*
+ * This file is part of the Bus Pirate project
+ * (http://code.google.com/p/the-bus-pirate/).
+ *
+ * Written and maintained by the Bus Pirate project.
+ *
+ * To the extent possible under law, the project has
+ * waived all copyright and related or neighboring rights to Bus Pirate. This
+ * work is published from United States.
+ *
+ * For details see: http://creativecommons.org/publicdomain/zero/1.0/.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/*
+ * Host test of the BASIC interpreter jumps: GOTO and GOSUB go through the
+ * line index and the jump cache while a program runs, and through the walk
+ * over pgmspace when the program has too many lines for the index.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "base.h"
+#include "basic.h"
+
+#include "basic_host.h"
+
+extern unsigned char pgmspace[];
+extern int lineindexlen;
+
+static int failures;
+
+#define CHECK(cond, ...)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf(" FAIL: " __VA_ARGS__);                                           \
+      printf("\n");                                                            \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static void enter_lines(const char *const *lines) {
+  while (*lines) {
+    basic_host_enter(*lines++);
+  }
+}
+
+/* what RUN prints for an error, up to the line number */
+static void error_text(char *text, size_t size, int error) {
+  size_t message;
+
+  basic_host_reset();
+  BPMSG1047;
+  message = basic_host_last_message();
+  snprintf(text, size, "<%zu>%d<", message, error);
+}
+
+static void test_loop(void) {
+  static const char *const program[] = {"10 LET A=0", "20 LET A=A+1",
+                                        "30 IF A<1000 THEN GOTO 20",
+                                        "40 PRINT A", "50 END", NULL};
+
+  basic_host_reset();
+  enter_lines(program);
+  basic_host_enter("RUN");
+  CHECK(strcmp(basic_host_output(), "1000\r\n\r\n") == 0,
+        "loop printed '%s'", basic_host_output());
+}
+
+/* the targets share a jump cache slot, line numbers modulo 8 */
+static void test_cache_slots(void) {
+  static const char *const program[] = {
+      "5 LET I=0",   "10 GOSUB 26",  "12 GOSUB 34",         "14 GOSUB 18",
+      "15 LET I=I+1", "16 IF I<3 THEN GOTO 10", "17 END",   "18 PRINT \"B\";",
+      "20 RETURN",   "26 PRINT \"A\";", "28 RETURN",        "34 PRINT \"C\";",
+      "36 RETURN",   NULL};
+
+  basic_host_reset();
+  enter_lines(program);
+  basic_host_enter("RUN");
+  CHECK(strcmp(basic_host_output(), "ACBACBACB\r\n") == 0,
+        "shared cache slots printed '%s'", basic_host_output());
+}
+
+static void test_missing_line(void) {
+  static const char *const program[] = {"10 GOTO 25", "20 END", NULL};
+  char expected[32];
+
+  error_text(expected, sizeof(expected), GOTOERROR);
+  basic_host_reset();
+  enter_lines(program);
+  basic_host_enter("RUN");
+  CHECK(basic_host_printed(expected), "GOTO to a missing line printed '%s'",
+        basic_host_output());
+}
+
+/* lines are indexed again on every RUN */
+static void test_edit(void) {
+  static const char *const program[] = {"10 GOTO 30", "20 PRINT \"X\"",
+                                        "30 PRINT \"Y\"", "40 END", NULL};
+
+  basic_host_reset();
+  enter_lines(program);
+  basic_host_enter("RUN");
+  CHECK(strcmp(basic_host_output(), "Y\r\n\r\n") == 0, "first run printed '%s'",
+        basic_host_output());
+
+  basic_host_enter("10 GOTO 20");
+  basic_host_enter("30 END");
+  basic_host_enter("25 PRINT \"Z\"");
+  basic_host_reset_output();
+  basic_host_enter("RUN");
+  CHECK(strcmp(basic_host_output(), "X\r\nZ\r\n\r\n") == 0,
+        "run after editing printed '%s'", basic_host_output());
+}
+
+/* more lines than LINEINDEXMAX, the jumps walk pgmspace */
+static void test_long_program(void) {
+  char line[32];
+  int i;
+
+  basic_host_reset();
+  for (i = 0; i < LINEINDEXMAX + 10; i++) {
+    snprintf(line, sizeof(line), "%d REMX", 100 + i);
+    basic_host_enter(line);
+  }
+  basic_host_enter("10 LET A=0");
+  basic_host_enter("20 GOTO 5000");
+  basic_host_enter("30 PRINT A");
+  basic_host_enter("40 END");
+  basic_host_enter("5000 LET A=A+1");
+  basic_host_enter("5010 IF A<50 THEN GOTO 5000");
+  basic_host_enter("5020 GOTO 30");
+
+  buildlineindex();
+  CHECK(lineindexlen == -1, "%d lines were indexed", lineindexlen);
+  lineindexlen = -1;
+
+  basic_host_enter("RUN");
+  CHECK(strcmp(basic_host_output(), "50\r\n\r\n") == 0,
+        "long program printed '%s'", basic_host_output());
+}
+
+/* a line that does not fit is refused, the program is left as it was */
+static void test_full_program(void) {
+  static unsigned char before[PGMSIZE];
+  char line[48];
+  size_t message;
+  int i;
+
+  basic_host_reset();
+  BPMSG1051;
+  message = basic_host_last_message();
+
+  basic_host_reset();
+  for (i = 0; basic_host_last_message() == BASIC_HOST_NO_MESSAGE; i++) {
+    memcpy(before, pgmspace, PGMSIZE);
+    snprintf(line, sizeof(line), "%d REM FILLING THE PROGRAM AREA", 10 + i);
+    basic_host_enter(line);
+  }
+
+  CHECK(basic_host_last_message() == message, "full program, message <%zu>",
+        basic_host_last_message());
+  CHECK(memcmp(before, pgmspace, PGMSIZE) == 0,
+        "full program, pgmspace changed by the refused line");
+}
+
+int main(void) {
+  test_loop();
+  test_cache_slots();
+  test_missing_line();
+  test_edit();
+  test_long_program();
+  test_full_program();
+
+  if (failures) {
+    printf("%d checks failed\n", failures);
+    return 1;
+  }
+
+  printf("basic tests passed\n");
+  return 0;
+}
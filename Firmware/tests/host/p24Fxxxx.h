@@ -0,0 +1,128 @@
+/*
+ * This file is part of the Bus Pirate project
+ * (http://code.google.com/p/the-bus-pirate/).
+ *
+ * Written and maintained by the Bus Pirate project.
+ *
+ * To the extent possible under law, the project has
+ * waived all copyright and related or neighboring rights to Bus Pirate. This
+ * work is published from United States.
+ *
+ * For details see: http://creativecommons.org/publicdomain/zero/1.0/.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/*
+ * Host stand-in for the device header, enough of a PIC24FJ64GA002 and a
+ * PIC24FJ256GB106 to build baseIO.c and perf_counters.c for a v3 and
+ * basic.c for a v4 with gcc.  The UART never fills up and the bytes written
+ * to it are kept by the test, PORTD reads come from the test as well.
+ */
+
+#ifndef BP_TESTS_HOST_P24FXXXX_H
+#define BP_TESTS_HOST_P24FXXXX_H
+
+#include <stdint.h>
+
+#define interrupt
+#define no_auto_psv
+#define section(name)
+
+typedef struct {
+  unsigned URXDA : 1;
+  unsigned OERR : 1;
+  unsigned TRMT : 1;
+  unsigned UTXBF : 1;
+  unsigned UTXEN : 1;
+  unsigned UTXISEL0 : 1;
+  unsigned UTXISEL1 : 1;
+} host_u1sta_t;
+
+typedef struct {
+  unsigned UARTEN : 1;
+  unsigned BRGH : 1;
+} host_u1mode_t;
+
+typedef struct {
+  unsigned T1IE : 1;
+  unsigned U1RXIE : 1;
+  unsigned U1TXIE : 1;
+} host_iec0_t;
+
+typedef struct {
+  unsigned T1IF : 1;
+  unsigned U1RXIF : 1;
+  unsigned U1TXIF : 1;
+} host_ifs0_t;
+
+typedef struct {
+  unsigned TON : 1;
+  unsigned TCKPS : 2;
+} host_t1con_t;
+
+typedef struct {
+  unsigned RA1 : 1;
+} host_porta_t;
+
+typedef struct {
+  unsigned RB7 : 1;
+  unsigned RB8 : 1;
+  unsigned RB9 : 1;
+  unsigned RB10 : 1;
+} host_portb_t;
+
+typedef struct {
+  unsigned RE4 : 1;
+} host_porte_t;
+
+typedef struct {
+  unsigned TRISB9 : 1;
+} host_trisb_t;
+
+typedef struct {
+  unsigned TRISE4 : 1;
+} host_trise_t;
+
+typedef struct {
+  unsigned ADON : 1;
+} host_ad1con1_t;
+
+extern host_u1sta_t U1STAbits;
+extern host_u1mode_t U1MODEbits;
+extern host_iec0_t IEC0bits;
+extern host_ifs0_t IFS0bits;
+extern host_porta_t PORTAbits;
+extern host_t1con_t T1CONbits;
+extern host_portb_t PORTBbits;
+extern host_porte_t PORTEbits;
+extern host_trisb_t TRISBbits;
+extern host_trise_t TRISEbits;
+extern host_ad1con1_t AD1CON1bits;
+extern uint16_t U1STA;
+extern uint16_t U1MODE;
+extern uint16_t U1BRG;
+extern uint16_t U1RXREG;
+extern uint16_t TBLPAG;
+extern uint16_t T1CON;
+extern uint16_t TMR1;
+extern uint16_t PR1;
+extern uint16_t LATD;
+extern uint16_t TRISD;
+
+uint16_t host_read_portd(void);
+#define PORTD host_read_portd()
+
+/* Each write to U1TXREG is appended to host_uart_sent[]. */
+extern uint8_t host_uart_sent[];
+extern unsigned int host_uart_sent_length;
+#define U1TXREG host_uart_sent[host_uart_sent_length++]
+
+#define Nop() do {} while (0)
+
+#define __builtin_tblrdh(address) 0
+#define __builtin_tblrdl(address) 0
+
+#endif /* BP_TESTS_HOST_P24FXXXX_H */
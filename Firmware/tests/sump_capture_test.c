@@ -0,0 +1,295 @@
+/*
+ * This file is part of the Bus Pirate project
+ * (http://code.google.com/p/the-bus-pirate/).
+ *
+ * Written and maintained by the Bus Pirate project.
+ *
+ * To the extent possible under law, the project has
+ * waived all copyright and related or neighboring rights to Bus Pirate. This
+ * work is published from United States.
+ *
+ * For details see: http://creativecommons.org/publicdomain/zero/1.0/.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/*
+ * Host test of the SUMP capture engine, built with SUMP_CAPTURE_HOST.
+ *
+ * PORTB is a precomputed signal indexed by the sample clock, with the
+ * non-probe bits filled with noise so that the probe mask is exercised.
+ * The trigger fires on a given tick, as the change notification flag would
+ * on the edge.  The tests check where the trigger sample lands in the
+ * window, the short history case, a capture without trigger, the abort, that the run-length encoded
+ * stream decodes back to the sampled signal, and where samples at a rate
+ * the fast loops cannot produce are picked from.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sump_capture.h"
+
+#define SIGNAL_LENGTH 65536
+#define BUFFER_SIZE 4096
+
+static uint16_t signal[SIGNAL_LENGTH];
+static uint32_t tick;
+static uint32_t trigger_tick;
+static uint32_t abort_tick;
+static uint8_t buffer[BUFFER_SIZE];
+static int failures;
+
+#define CHECK(cond, ...)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf(" FAIL: " __VA_ARGS__);                                           \
+      printf("\n");                                                            \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+uint16_t sump_host_read_portb(void) { return signal[tick % SIGNAL_LENGTH]; }
+
+void sump_host_wait_tick(void) { tick++; }
+
+bool sump_host_trigger_fired(void) { return tick >= trigger_tick; }
+
+bool sump_host_input_ready(void) { return tick >= abort_tick; }
+
+static uint8_t probes(uint32_t at) {
+  return (uint8_t)((signal[at % SIGNAL_LENGTH] >> 6) & 0x1F);
+}
+
+/*
+ * Fills PORTB.  Probes change with the given odds per sample (out of 256),
+ * the other bits are random every sample.
+ */
+static void make_signal(unsigned int change_odds, unsigned int seed) {
+  uint16_t value = 0;
+  uint32_t i;
+
+  srand(seed);
+  for (i = 0; i < SIGNAL_LENGTH; i++) {
+    if ((unsigned int)(rand() & 0xFF) < change_odds) {
+      value = (uint16_t)((rand() & 0x1F) << 6);
+    }
+    signal[i] = value | (uint16_t)(rand() & ~(0x1F << 6));
+  }
+}
+
+static void start(uint32_t trigger, uint32_t abort_at) {
+  tick = 0;
+  trigger_tick = trigger;
+  abort_tick = abort_at;
+}
+
+static void test_trigger_placement(uint16_t read_count, uint16_t delay_count,
+                                   uint32_t trigger) {
+  sump_capture_t capture;
+  uint32_t newest;
+  uint16_t i;
+  uint16_t bad = 0;
+
+  make_signal(64, trigger);
+  start(trigger, UINT32_MAX);
+  sump_capture_init(&capture, buffer, BUFFER_SIZE, read_count, delay_count,
+                    false);
+
+  CHECK(sump_capture_run(&capture, true) == SUMP_CAPTURE_DONE,
+        "read %u delay %u, capture did not complete", read_count,
+        delay_count);
+
+  /* The trigger sample is delay_count - 1 samples before the newest one. */
+  newest = trigger + capture.delay_count - 1;
+  CHECK(tick == newest + 1, "read %u delay %u, took %u samples, expected %u",
+        read_count, delay_count, tick, newest + 1);
+
+  for (i = 0; i < capture.read_count; i++) {
+    uint32_t at = newest - i;
+
+    /* Not enough history, the oldest sample repeats. */
+    if (newest >= capture.read_count || i <= newest) {
+      bad += sump_capture_sample(&capture, i) != probes(at);
+    } else {
+      bad += sump_capture_sample(&capture, i) != probes(0);
+    }
+  }
+
+  CHECK(bad == 0, "read %u delay %u trigger %u, %u samples misplaced",
+        read_count, delay_count, trigger, bad);
+  CHECK(sump_capture_sample(&capture, capture.delay_count - 1) ==
+            probes(trigger),
+        "read %u delay %u, trigger sample not at delay count", read_count,
+        delay_count);
+}
+
+/* Without a trigger the whole window is sampled, none of it is padding. */
+static void test_untriggered(uint16_t read_count, uint16_t delay_count) {
+  sump_capture_t capture;
+  uint16_t i;
+  uint16_t bad = 0;
+
+  make_signal(64, read_count);
+  start(UINT32_MAX, UINT32_MAX);
+  sump_capture_init(&capture, buffer, BUFFER_SIZE, read_count, delay_count,
+                    false);
+
+  CHECK(sump_capture_run(&capture, false) == SUMP_CAPTURE_DONE,
+        "untriggered read %u delay %u, capture did not complete", read_count,
+        delay_count);
+  CHECK(tick == read_count,
+        "untriggered read %u delay %u, took %u samples, expected %u",
+        read_count, delay_count, tick, read_count);
+
+  for (i = 0; i < capture.read_count; i++) {
+    bad += sump_capture_sample(&capture, i) != probes(read_count - 1 - i);
+  }
+
+  CHECK(bad == 0, "untriggered read %u delay %u, %u samples wrong", read_count,
+        delay_count, bad);
+}
+
+static void test_abort(void) {
+  sump_capture_t capture;
+
+  make_signal(64, 1);
+  start(UINT32_MAX, 1000);
+  sump_capture_init(&capture, buffer, BUFFER_SIZE, 1024, 512, false);
+  CHECK(sump_capture_run(&capture, true) == SUMP_CAPTURE_ABORTED,
+        "input before the trigger did not abort");
+  CHECK(tick < 1000 + 256 + 1, "abort noticed after %u samples", tick);
+
+  start(UINT32_MAX, 1000);
+  sump_capture_init(&capture, buffer, BUFFER_SIZE, 1024, 512, true);
+  CHECK(sump_capture_run(&capture, true) == SUMP_CAPTURE_ABORTED,
+        "input before the trigger did not abort an RLE capture");
+}
+
+/*
+ * Decodes the stream as a SUMP client receives it, newest first: a count
+ * byte 0x80 | n precedes the value it applies to, which lasted n + 1
+ * samples.  The samples come out newest first.
+ */
+static uint32_t rle_decode(const sump_capture_t *capture, uint8_t *samples) {
+  uint32_t decoded = 0;
+  uint16_t count = 0;
+  uint16_t i;
+  uint16_t j;
+
+  for (i = 0; i < capture->read_count && i < capture->stored; i++) {
+    uint8_t byte = sump_capture_sample(capture, i);
+
+    if (byte & SUMP_CAPTURE_RLE_FLAG) {
+      count = byte & SUMP_CAPTURE_RLE_MAX_COUNT;
+      continue;
+    }
+
+    for (j = 0; j <= count; j++) {
+      samples[decoded++] = byte;
+    }
+    count = 0;
+  }
+
+  return decoded;
+}
+
+static void test_rle_round_trip(unsigned int change_odds, uint16_t read_count,
+                                uint32_t trigger) {
+  static uint8_t samples[BUFFER_SIZE * (SUMP_CAPTURE_RLE_MAX_COUNT + 1)];
+  sump_capture_t capture;
+  uint32_t decoded;
+  uint32_t i;
+  uint32_t bad = 0;
+
+  make_signal(change_odds, change_odds + read_count);
+  start(trigger, UINT32_MAX);
+  sump_capture_init(&capture, buffer, BUFFER_SIZE, read_count, 0, true);
+
+  CHECK(sump_capture_run(&capture, true) == SUMP_CAPTURE_DONE,
+        "RLE odds %u, capture did not complete", change_odds);
+  CHECK(capture.stored <= read_count, "RLE odds %u, %u bytes for %u",
+        change_odds, capture.stored, read_count);
+
+  decoded = rle_decode(&capture, samples);
+
+  /* The last sample read did not fit and was dropped. */
+  CHECK(decoded == tick - trigger, "RLE odds %u, decoded %u samples of %u",
+        change_odds, decoded, tick - trigger);
+
+  for (i = 0; i < decoded; i++) {
+    bad += samples[decoded - 1 - i] != probes(trigger + i);
+  }
+
+  CHECK(bad == 0, "RLE odds %u, %u samples differ", change_odds, bad);
+}
+
+/*
+ * Every SUMP divider that ends up in the fast loops, with the loop period
+ * sump_acquire_fast picks: the resampled index must be the nearest loop
+ * sample, exact when the period is a multiple of the loop period.
+ */
+static void test_resample(void) {
+  uint32_t divider;
+  uint16_t index;
+
+  for (divider = 0; divider < 100; divider++) {
+    uint16_t period = (uint16_t)((divider + 1) * 4);
+    uint16_t base;
+    uint16_t bad = 0;
+
+    if (period < 4 * 25) {
+      base = 25;
+    } else if (period < 6 * 25) {
+      base = 4 * 25;
+    } else {
+      base = (period / 25) * 25;
+    }
+
+    for (index = 0; index < BUFFER_SIZE; index++) {
+      uint16_t picked = sump_capture_resample_index(index, period, base);
+      int32_t error = (int32_t)picked * base - (int32_t)index * period;
+
+      if ((error * 2 > base) || (error * 2 < -(int32_t)base)) {
+        bad++;
+      } else if (((period % base) == 0) && (error != 0)) {
+        bad++;
+      }
+    }
+
+    CHECK(bad == 0, "divider %u, %u samples picked off the period", divider,
+          bad);
+  }
+}
+
+int main(void) {
+  test_trigger_placement(1024, 512, 5000);
+  test_trigger_placement(4096, 1, 10000);
+  test_trigger_placement(4096, 4096, 300);
+  test_trigger_placement(2048, 100, 100);
+  test_trigger_placement(512, 256, 0);
+  test_untriggered(1024, 512);
+  test_untriggered(4096, 1);
+  test_untriggered(3, 3);
+  test_abort();
+
+  test_rle_round_trip(0, 4096, 700);
+  test_rle_round_trip(1, 4096, 0);
+  test_rle_round_trip(16, 2048, 1234);
+  test_rle_round_trip(255, 1024, 99);
+  test_rle_round_trip(128, 3, 5);
+
+  test_resample();
+
+  if (failures) {
+    printf("%d checks failed\n", failures);
+    return 1;
+  }
+
+  printf("sump capture tests passed\n");
+  return 0;
+}
@@ -13,7 +13,6 @@
 #endif
 
 #include "serial.h"
-#include "buspirate.h"
 
 
 #define  JTAG_RESET        0x01
@@ -65,20 +65,92 @@ QByteArray BinMode::command(unsigned short command)
 	return res;
 }
 
+/* Resync Helpers */
+#define RESYNC_WAIT     40      // ms to wait for a reply, covers the FTDI latency timer
+#define RESYNC_QUIET    20      // ms without input before the line counts as drained
+#define RESYNC_ATTEMPTS 3
+
+// 0x00 resets sent per step, the terminal needs 20 in a row, BBIO and the sub-modes one
+static const int resync_steps[] = { 1, 4, 5, 10, 5, 5 };
+
+QByteArray BinMode::read_timed(int len, int msec)
+{
+	QByteArray res;
+	QElapsedTimer timer;
+	timer.start();
+	while (res.size() < len) {
+		if (serial->bytesAvailable() > 0) {
+			res.append(serial->read(len - res.size()));
+			timer.restart();
+		} else if (timer.elapsed() >= msec) {
+			break;
+		} else {
+			QThread::msleep(1);
+		}
+	}
+	return res;
+}
+
+int BinMode::drain(void)
+{
+	int total = 0;
+	QByteArray junk;
+	do {
+		junk = read_timed(256, RESYNC_QUIET);
+		total += junk.size();
+	} while (!junk.isEmpty() && total < 65536);
+	return total;
+}
+
 /* BBIO */
+/*
+ * Works from the terminal, BBIO or any sub-mode: drain the input, ask for the
+ * version string with 0x01 to log the mode we were in, then send 0x00 in the
+ * steps of resync_steps until "BBIO1" is read. After draining the surplus
+ * replies one more 0x00 must answer exactly "BBIO1".
+ */
 int BinMode::enter_mode_bbio(void)
 {
-	int ret=0;
-	QByteArray res;
-	if (reset_bbio()) return ret;
-	serial->flush();
-	serial->write("\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00", 20);
-	serial->flush();
-	res = serial->readAll();
-	serial->flush();
-	if (res.contains("BBIO")) ret = 1;
-	if (ret) qDebug() << "BBIO Ready!";
-	return ret;
+	QElapsedTimer timer;
+	QByteArray res, probe;
+	int resets = 0, stale;
+	timer.start();
+
+	stale = drain();
+	serial->write("\x01", 1);
+	probe = read_timed(4, RESYNC_WAIT);
+	stale += drain();
+	qDebug() << "BBIO - probe:" << probe;
+
+	for (int attempt = 0; attempt < RESYNC_ATTEMPTS; attempt++) {
+		bool found = false;
+		res.clear();
+		for (unsigned int step = 0; step < sizeof(resync_steps) / sizeof(resync_steps[0]) && !found; step++) {
+			serial->write(QByteArray(resync_steps[step], '\x00'));
+			resets += resync_steps[step];
+			QByteArray chunk;
+			while (!found && !(chunk = read_timed(64, RESYNC_WAIT)).isEmpty()) {
+				res.append(chunk);
+				found = res.contains("BBIO1");
+			}
+		}
+		if (!found)
+			continue;
+		stale += drain();
+
+		/* confirm, one reset must now give exactly one version string */
+		serial->write("\x00", 1);
+		resets++;
+		res = read_timed(5, RESYNC_WAIT);
+		if (res == "BBIO1" && read_timed(1, RESYNC_QUIET).isEmpty()) {
+			qDebug() << "BBIO Ready! resets:" << resets << "stale:" << stale << "ms:" << timer.elapsed();
+			return 1;
+		}
+		stale += res.size() + drain();
+	}
+
+	qDebug() << "BBIO failed, resets:" << resets << "ms:" << timer.elapsed();
+	return 0;
 }
 
 int BinMode::reset_bbio(void)
@@ -86,12 +158,10 @@ int BinMode::reset_bbio(void)
 	QByteArray version_string;
 	int ret = 0;
 
-	serial->flush();
+	drain();
 	serial->write("\x00", 1);
-	serial->flush();
-	version_string = serial->readAll();
-	serial->flush();
-	if (version_string.contains("BBIO")) ret = 1;
+	version_string = read_timed(5, RESYNC_WAIT);
+	if (version_string == "BBIO1" && read_timed(1, RESYNC_QUIET).isEmpty()) ret = 1;
 	qDebug() << "BBIO - text:" << version_string;
 	return ret;
 }
@@ -80,6 +80,10 @@ public slots:
 	/* Port Manipulation */
 	bool       port_open(void);
 	void       port_close(void);
+private:
+	/* Resync Helpers */
+	QByteArray read_timed(int len, int msec);
+	int        drain(void);
 };
 
 #endif
@@ -66,6 +66,8 @@ int main(int argc, char** argv)
   int flag=0,firsttime=0;
   char *param_port = NULL;
   char *param_speed = NULL;
+  static BP_Batch batch;
+  uint8_t blink[2] = { 0x00, 0xFF }, reply[2];
 
     printf("-------------------------------------------------------\n");
     printf("\n");
@@ -163,6 +165,10 @@ while ((opt = getopt(argc, argv, "ms:d:")) != -1) {
         return -1;
     }
 
+    //SPI is left at the default 30kHz, slower than the UART, so the batch paces itself
+    BP_BatchInit(&batch, fd, SPI);
+    BP_BatchSetBusSpeed(&batch, 30000, atoi(param_speed));
+
     flag=0;
     //
     // Loop and repeat test as needed for manufacturing
@@ -223,36 +229,22 @@ while ((opt = getopt(argc, argv, "ms:d:")) != -1) {
 
         printf(" Press any key to continue...\n");
         firsttime=1;
-        while(1){
-            i=0x10;//send data
-            if (BP_WriteToPirate(fd, &i))
-                 printf("WARNING.. Not Good\n");
-
-             i=0x00;//data
-             BP_WriteToPirateNoCheck(fd, &i);
-
-            i=0x03;//cs High
-            if (BP_WriteToPirate(fd, &i))
-                 printf("WARNING.. Not Good\n");
-
-            i=0x02;//cs low
-            if (BP_WriteToPirate(fd, &i))
-                 printf("WARNING.. Not Good\n");
-
-
-             i=0x10;//send data
-            if (BP_WriteToPirate(fd, &i))
-                 printf("WARNING.. Not Good\n");
 
-             i=0xFF;//data
-             BP_WriteToPirateNoCheck(fd, &i);
+        //all outputs low, then high, one round trip per blink
+        //power and pin setup go along, a resynced Bus Pirate comes back with them off
+        BP_BatchClear(&batch);
+        BP_BatchCommand(&batch, 0x48); //power on
+        BP_BatchCommand(&batch, 0x8A); //3.3v outputs, CKE edge
+        BP_BatchSPIBulk(&batch, &blink[0], 1);
+        BP_BatchCommand(&batch, 0x03); //cs High
+        BP_BatchCommand(&batch, 0x02); //cs low
+        BP_BatchSPIBulk(&batch, &blink[1], 1);
+        BP_BatchCommand(&batch, 0x03); //cs High
+        BP_BatchCommand(&batch, 0x02); //cs low
 
-            i=0x03;//cs High
-            if (BP_WriteToPirate(fd, &i))
-                 printf("WARNING.. Not Good\n");
-
-            i=0x02;//cs low
-            if (BP_WriteToPirate(fd, &i))
+        while(1){
+            //on lost replies the batch has already resynced the Bus Pirate, so just go again
+            if (BP_BatchRun(&batch, reply, sizeof(reply)) != 0)
                  printf("WARNING.. Not Good\n");
 
             Sleep(1);
@@ -29,14 +29,16 @@
 #include "buspirate.h"
 #include "serial.h"
 
+//largest data record the firmware sends, must match SNIFF_RECORD_MAX_PAIRS in Firmware/spi.c
+#define SNIFF_RECORD_HEADER 6
+#define SNIFF_RECORD_MAX_PAIRS 29
+
 int modem =FALSE;   //set this to TRUE of testing a MODEM
 int verbose = 0;
 int disable_comport = 0;   //1 to say yes, disable comport, any value to enable port default is 0 meaning port is enable.
 int dumphandle;     // use by dump file when using the -d dumfile.txt parameter
 char *dumpfile;
 
-#define SPI 0x01
-
 int print_usage(char * appname)
 	{
 		//print usage
@@ -54,6 +56,7 @@ int print_usage(char * appname)
 		printf("                  -e ClockEdge is 0 or 1  default is 1 \n");
 		printf("                  -p Polarity  is 0 or 1  default is 0 \n");
 		printf("                  -r RawData is 0 or 1  default is 0 \n");
+		printf("                  -t Timestamps is 0 or 1  default is 0 \n");
 		printf("\n");
 
         printf("\n");
@@ -79,6 +82,12 @@ int opt;
   char *param_polarity=NULL;
   char *param_clockedge=NULL;
   char *param_rawdata=NULL;
+  char *param_timestamps=NULL;
+  int timestamps;
+  uint8_t record[SNIFF_RECORD_HEADER + SNIFF_RECORD_MAX_PAIRS*2];
+  int rec_len=0, rec_need=1;
+  int stopped=0;
+  static BP_Batch batch;
 
 //  int clock_edge;
 // int polarity;
@@ -105,7 +114,7 @@ if (argc <= 1)  {
 		exit(-1);
 	}
 
-while ((opt = getopt(argc, argv, "ms:p:e:d:r:")) != -1) {
+while ((opt = getopt(argc, argv, "ms:p:e:d:r:t:")) != -1) {
        // printf("%c  \n",opt);
 		switch (opt) {
 
@@ -147,6 +156,14 @@ while ((opt = getopt(argc, argv, "ms:p:e:d:r:")) != -1) {
 				}
 				param_rawdata = strdup(optarg);
 
+				break;
+			case 't':      // timestamped records
+ 				if (param_timestamps != NULL) {
+					printf("Timestamps should be 0 or 1\n");
+					exit(-1);
+				}
+				param_timestamps = strdup(optarg);
+
 				break;
 			case 'm':    //modem debugging for testing
                    modem =TRUE;   // enable modem mode
@@ -184,6 +201,10 @@ while ((opt = getopt(argc, argv, "ms:p:e:d:r:")) != -1) {
     if (param_rawdata==NULL)
           param_rawdata=strdup("0");
 
+    if (param_timestamps==NULL)
+          param_timestamps=strdup("0");
+    timestamps=(strncmp(param_timestamps, "1", 1)==0);
+
 
     printf("\n  Parameters used: Device = %s,  Speed = %s, Clock Edge= %s, Polarity= %s\n\n",param_port,param_speed,param_clockedge,param_polarity);
 
@@ -230,7 +251,10 @@ while ((opt = getopt(argc, argv, "ms:p:e:d:r:")) != -1) {
 
 
           fprintf(stderr, " Configuring Bus Pirate...\n");
-   	      BP_EnableMode(fd, SPI); //enter BBIO then SPI
+   	      if (BP_EnableBinary(fd) != BBIO || BP_EnableMode(fd, SPI) != SPI) { //enter BBIO then SPI
+   	            fprintf(stderr, " Could not enter SPI mode\n");
+   	            exit(-1);
+   	      }
     //
 	//Start sniffer
 	//
@@ -243,10 +267,17 @@ while ((opt = getopt(argc, argv, "ms:p:e:d:r:")) != -1) {
             if(strncmp(param_polarity, "1", 1)==0)
                 i|=0x04;
 
-            BP_WriteToPirate(fd, &i);
+            BP_BatchInit(&batch, fd, SPI);
+            BP_BatchCommand(&batch, i);
+
+    //start the sniffer, its 0x01 is eaten here so it is not taken for a record
+            //0x0C - timestamped records, CS low; 0x0E - escaped bytes, CS low
+            BP_BatchCommand(&batch, timestamps ? 0x0C : 0x0E);
 
-    //start the sniffer
-             serial_write( fd, "\x0E", 1);
+            if (BP_BatchRun(&batch, (uint8_t *)buffer, sizeof(buffer)) != 0) {
+                fprintf(stderr, " Could not start the sniffer\n");
+                exit(-1);
+            }
 
     //
     // Done with setup
@@ -267,6 +298,75 @@ while ((opt = getopt(argc, argv, "ms:p:e:d:r:")) != -1) {
         if(res>0){
             for(c=0; c<res; c++){
             if(strncmp(param_rawdata, "1", 1)==0) printf("%02X ", (uint8_t)buffer[c]);
+	    else if (timestamps) {
+		record[rec_len++]=(uint8_t)buffer[c];
+		if (rec_len==1) {
+			switch (record[0]) {
+				case 0x01:	// CS low + time
+				case 0x02:	// CS high + time
+					rec_need=5;
+					break;
+				case 0x03:	// time + count + pairs
+					rec_need=6;
+					break;
+				case 0x04:	// dropped count
+					rec_need=3;
+					break;
+				case 0x00:	// end, the sniffer stopped
+					rec_need=1;
+					break;
+				default:
+					printf("Sync\n");
+					rec_len=0;
+					continue;
+			}
+		}
+		if (rec_len==SNIFF_RECORD_HEADER && record[0]==0x03) {
+			if (record[5]>SNIFF_RECORD_MAX_PAIRS) {
+				//not a record the firmware sends, wait for the next type byte
+				printf("Sync\n");
+				rec_len=0;
+				rec_need=1;
+				continue;
+			}
+			rec_need=SNIFF_RECORD_HEADER+record[5]*2;
+		}
+		if (rec_len<rec_need)
+			continue;
+
+		switch (record[0]) {
+			case 0x01:
+			case 0x02:
+			case 0x03:
+				// timer ticks are 0.5us
+				printf("%s%10.1fus ", record[0]==0x03 ? "  " : "",
+					((uint32_t)record[1]<<24 | (uint32_t)record[2]<<16 | record[3]<<8 | record[4])/2.0);
+				if (record[0]==0x01) {
+					printf("[\n");
+				} else if (record[0]==0x02) {
+					printf("]\n");
+				} else {
+					for (i=0; i<record[5]; i++)
+						printf("0x%02X(0x%02X)", record[6+i*2], record[7+i*2]);
+					printf("\n");
+				}
+				break;
+			case 0x04:
+				if (record[1]==0xFF && record[2]==0xFF)
+					printf("  (overflow, bytes lost)\n");
+				else
+					printf("  (overflow, %u bytes lost)\n", record[1]<<8 | record[2]);
+				break;
+			case 0x00:
+				printf(" Sniffer stopped\n");
+				stopped=1;
+				break;
+		}
+		rec_len=0;
+		rec_need=1;
+		if (stopped)
+			break;
+	    }
 	    else {
 		switch(state) {
 			default:
@@ -304,6 +404,9 @@ while ((opt = getopt(argc, argv, "ms:p:e:d:r:")) != -1) {
             }
         }
 
+        if (stopped)
+            break;
+
 #ifdef WIN32
         if(kbhit()){
            c = getch();
@@ -5,6 +5,16 @@
 #include "serial.h"
 #include "buspirate.h"
 
+#ifndef WIN32
+#include <sys/time.h>
+#define Sleep(x) usleep(x);
+#endif
+
+#ifndef TRUE
+#define TRUE 1
+#define FALSE 0
+#endif
+
 
 const char *modes[]={
     "BBIO",
@@ -50,13 +60,12 @@ uint32_t BP_WriteToPirate(int fd, char * val) {
 }
 
 uint32_t BP_WriteToPirateNoCheck(int fd, char * val) {
-	int res = -1;
 	char ret = 0;
 
 
     serial_write(fd, val, 1);
     Sleep(1);
-    res = serial_read(fd, &ret, 1);
+    serial_read(fd, &ret, 1);
 
 	return 0;
 }
@@ -65,54 +74,32 @@ int BP_EnableBinary(int fd)   // should return BBIO if ok, ERR if not
 {
 	int ret;
 	char tmp[100] = { [0 ... 20] = 0x00 };
-	int done = 0;
-	//int cmd_sent = 0;
-	int tries=0;
+	BP_ResyncInfo info;
 
 	printf(" Entering binary mode...\n");
 
 	if (fd==-1)   //added because the fd has already returned null
 	{
 	    printf("Port does not exist!");
-	    ret=ERR;
-
+	    return ERR;
 	}
-   else
-   {
-
 
-	while (!done) {
-		tmp[0]=0x00;
-		//printf("Sending 0X%X to port\n",tmp[0]);
+	if (modem==TRUE)
+	{
 		serial_write(fd, tmp, 1);
-		tries++;
-	//	printf("tries: %i Ret %i\n",tries,ret);
-		usleep(1);
 		ret = serial_read(fd, tmp, 5);
-		if (modem==TRUE)
-		{
-            printf("\n Modem Responded = %i\n",ret);
-            done=1;
-		}
-		else {
-		     if (ret != 5 && tries>20) {
-			         fprintf(stderr, " Buspirate did not respond correctly :( %i \n", ret );
-			         ret=ERR;
-		      }
-		      else if (strncmp(tmp, "BBIO1", 5) == 0) {
-			       done=1;
-		            ret=BBIO;
-		           }
-		}
+		printf("\n Modem Responded = %i\n",ret);
+		return ret;
+	}
 
-		if (tries>25){
-		printf(" Buspirate:Too many tries in serial read! -exiting \n - chip not detected, or not readable/writable\n");
-		break;
-		ret=ERR;
-		}
+	ret = BP_Resync(fd, BBIO, &info);
+	if (ret == ERR) {
+		fprintf(stderr, " Buspirate did not respond correctly after %i resets\n", info.resets);
+		return ERR;
 	}
-   }
-   return ret;
+
+	printf(" BBIO1 after %i resets, %i stale bytes, %u ms\n", info.resets, info.stale, info.msec);
+	return BBIO;
 }
 
 
@@ -196,4 +183,484 @@ int BP_EnableMode(int fd, char bbmode)
 
 
 
+static uint32_t BP_Milliseconds(void)
+{
+#ifdef WIN32
+	return GetTickCount();
+#else
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
+#endif
+}
+
+/*
+ * Resynchronisation
+ */
+
+#define BP_RESYNC_WAIT      40      //ms to wait for a reply, covers the FTDI latency timer
+#define BP_RESYNC_QUIET     20      //ms without input before the line counts as drained
+#define BP_RESYNC_DRAIN     65536   //give up draining a device that never stops talking
+#define BP_RESYNC_ATTEMPTS  3
+
+// 0x00 resets sent per step, the terminal needs 20 in a row, BBIO and the sub-modes one
+static const uint8_t resync_steps[] = { 1, 4, 5, 10, 5, 5 };
+
+// read whatever arrives within msec, returns at the first chunk
+static int BP_ReadSome(int fd, uint8_t *buf, int len, int msec)
+{
+#ifdef WIN32
+	uint32_t started = BP_Milliseconds();
+	COMSTAT cs;
+	DWORD errors;
+
+	for (;;) {
+		if (!ClearCommError((HANDLE)fd, &errors, &cs))
+			return 0;
+		if (cs.cbInQue > 0)
+			return serial_read(fd, (char *)buf, cs.cbInQue < (DWORD)len ? (int)cs.cbInQue : len);
+		if (BP_Milliseconds() - started >= (uint32_t)msec)
+			return 0;
+		Sleep(1);
+	}
+#else
+	struct timeval tv = { msec / 1000, (msec % 1000) * 1000 };
+	fd_set fds;
+	int res;
+
+	FD_ZERO(&fds);
+	FD_SET(fd, &fds);
+	if (select(fd + 1, &fds, NULL, NULL, &tv) <= 0)
+		return 0;
+
+	res = read(fd, buf, len);
+	return res > 0 ? res : 0;
+#endif
+}
+
+// read exactly len bytes unless the device goes quiet for msec
+static int BP_ReadTimed(int fd, uint8_t *buf, int len, int msec)
+{
+	int got = 0, n;
+
+	while (got < len && (n = BP_ReadSome(fd, buf + got, len - got, msec)) > 0)
+		got += n;
+
+	return got;
+}
+
+// discard input until the line is quiet, returns the number of bytes dropped
+static int BP_Drain(int fd)
+{
+	uint8_t junk[256];
+	int n, total = 0;
+
+	while (total < BP_RESYNC_DRAIN && (n = BP_ReadSome(fd, junk, sizeof(junk), BP_RESYNC_QUIET)) > 0)
+		total += n;
+
+	return total;
+}
+
+// version string of a sub-mode is its name from modes[] followed by '1'
+static char BP_ParseVersion(const uint8_t *buf, int len)
+{
+	int i;
+
+	if (len != 4 || buf[3] != '1')
+		return ERR;
+
+	for (i = SPI; i <= RAW; i++) {
+		if (strncmp((const char *)buf, modes[i], 3) == 0)
+			return i;
+	}
+
+	return ERR;
+}
+
+// send steps of 0x00 until "BBIO1" shows up in the replies
+static int BP_ResetToBBIO(int fd, BP_ResyncInfo *info)
+{
+	uint8_t zero[32] = { 0 };
+	uint8_t buf[64];
+	int step, len = 0, n, i;
+
+	for (step = 0; step < (int)sizeof(resync_steps); step++) {
+		if (serial_write(fd, (char *)zero, resync_steps[step]) != resync_steps[step])
+			return ERR;
+		info->resets += resync_steps[step];
+
+		while ((n = BP_ReadSome(fd, buf + len, sizeof(buf) - len, BP_RESYNC_WAIT)) > 0) {
+			len += n;
+			for (i = 0; i + 5 <= len; i++) {
+				if (memcmp(&buf[i], "BBIO1", 5) == 0) {
+					info->stale += i;
+					return BBIO;
+				}
+			}
+			//keep the tail, it may hold the start of the version string
+			if (len > 4) {
+				info->stale += len - 4;
+				memmove(buf, buf + len - 4, 4);
+				len = 4;
+			}
+		}
+	}
+
+	return ERR;
+}
+
+/*
+ * Bring the Bus Pirate into mode from whatever state it is in. The input is
+ * drained, then a single 0x01 asks for the version string: a sub-mode answers
+ * with its own, BBIO enters SPI and answers "SPI1", the terminal only moves
+ * the cursor. If that is already the wanted mode nothing else is sent.
+ * Otherwise 0x00 is sent in the steps of resync_steps until "BBIO1" is read,
+ * the surplus replies are drained and one more 0x00 must answer exactly
+ * "BBIO1" before the mode is entered. info, if given, reports the mode found
+ * by the probe, the resets sent, the bytes discarded and the time taken.
+ */
+int BP_Resync(int fd, char mode, BP_ResyncInfo *info)
+{
+	BP_ResyncInfo local;
+	uint32_t started = BP_Milliseconds();
+	uint8_t buf[8];
+	int attempt, n, ret = ERR;
+
+	if (info == NULL)
+		info = &local;
+	memset(info, 0, sizeof(*info));
+	info->found = ERR;
+
+	info->stale = BP_Drain(fd);
+
+	buf[0] = 0x01;
+	if (serial_write(fd, (char *)buf, 1) == 1) {
+		n = BP_ReadTimed(fd, buf, 4, BP_RESYNC_WAIT);
+		info->found = BP_ParseVersion(buf, n);
+		if (info->found == ERR)
+			info->stale += n;
+	}
+	info->stale += BP_Drain(fd);
+
+	if (mode != BBIO && info->found == mode) {
+		info->msec = BP_Milliseconds() - started;
+		return mode;
+	}
+
+	for (attempt = 0; attempt < BP_RESYNC_ATTEMPTS; attempt++) {
+		if (BP_ResetToBBIO(fd, info) != BBIO)
+			continue;
+		info->stale += BP_Drain(fd);
+
+		//confirm, one reset must now give exactly one version string
+		buf[0] = 0x00;
+		if (serial_write(fd, (char *)buf, 1) != 1)
+			continue;
+		info->resets++;
+		n = BP_ReadTimed(fd, buf, 5, BP_RESYNC_WAIT);
+		if (n == 5 && memcmp(buf, "BBIO1", 5) == 0 && BP_ReadSome(fd, buf, 1, BP_RESYNC_QUIET) == 0) {
+			ret = BBIO;
+			break;
+		}
+		info->stale += n + BP_Drain(fd);
+	}
+
+	if (ret == BBIO && mode != BBIO)
+		ret = BP_EnableMode(fd, mode);
+
+	info->msec = BP_Milliseconds() - started;
+	return ret;
+}
+
+void BP_BatchInit(BP_Batch *b, int fd, char mode)
+{
+	memset(b, 0, sizeof(*b));
+	b->fd = fd;
+	b->mode = mode;
+	b->window = BP_RX_FIFO;
+}
+
+// bus clock of the mode, opens the write window if the bus drains bytes well ahead of the UART
+void BP_BatchSetBusSpeed(BP_Batch *b, uint32_t bus_hz, uint32_t baud)
+{
+	//9 clocks per byte covers the I2C ACK, 10 bits per UART byte, twice as fast for the firmware overhead
+	if (bus_hz / 9 >= (baud / 10) * 2)
+		b->window = 0;
+	else
+		b->window = BP_RX_FIFO;
+}
+
+void BP_BatchClear(BP_Batch *b)
+{
+	b->cmd_len = 0;
+	b->items = 0;
+	b->reply_len = 0;
+}
+
+// queue one command, status=1 if the reply starts with 0x01/0x00
+int BP_BatchAdd(BP_Batch *b, const uint8_t *cmd, int cmd_len, int status, int reply_len)
+{
+	BP_BatchItem *it;
+
+	if (b->items >= BP_BATCH_ITEMS || b->cmd_len + cmd_len > BP_BATCH_SIZE) {
+		fprintf(stderr, " Batch full, run it first\n");
+		return ERR;
+	}
+
+	it = &b->item[b->items++];
+	it->cmd_len = cmd_len;
+	it->reply_len = reply_len;
+	it->status = status;
+	it->paced = 0;
+	it->failed = 0;
+
+	memcpy(&b->cmd[b->cmd_len], cmd, cmd_len);
+	b->cmd_len += cmd_len;
+	b->reply_len += reply_len;
+
+	return 0;
+}
+
+// single byte command answered with 0x01 (CS, config, speed, I2C start/stop...)
+int BP_BatchCommand(BP_Batch *b, uint8_t cmd)
+{
+	return BP_BatchAdd(b, &cmd, 1, 1, 0);
+}
+
+// 0001xxxx bulk transfer, split in chunks of 16, one reply byte per data byte
+static int BP_BatchBulk(BP_Batch *b, const uint8_t *data, int len)
+{
+	uint8_t cmd[17];
+	int n;
+
+	while (len > 0) {
+		n = (len > 16) ? 16 : len;
+		cmd[0] = 0x10 | (n - 1);
+		memcpy(&cmd[1], data, n);
+
+		if (BP_BatchAdd(b, cmd, n + 1, 1, n) < 0)
+			return ERR;
+		b->item[b->items - 1].paced = 1;
+
+		data += n;
+		len -= n;
+	}
+	return 0;
+}
+
+// SPI bulk, one read byte per written byte
+int BP_BatchSPIBulk(BP_Batch *b, const uint8_t *data, int len)
+{
+	return BP_BatchBulk(b, data, len);
+}
+
+// SPI 0x04 (cs=1, CS held low) or 0x05 write-then-read
+int BP_BatchSPIWriteRead(BP_Batch *b, const uint8_t *data, uint16_t wlen, uint16_t rlen, int cs)
+{
+	uint8_t cmd[5 + BP_BATCH_SIZE];
+
+	if (wlen > BP_BATCH_SIZE - 5)
+		return ERR;
+
+	cmd[0] = cs ? 0x04 : 0x05;
+	cmd[1] = wlen >> 8;
+	cmd[2] = wlen;
+	cmd[3] = rlen >> 8;
+	cmd[4] = rlen;
+	memcpy(&cmd[5], data, wlen);
+
+	return BP_BatchAdd(b, cmd, wlen + 5, 1, rlen);
+}
+
+// I2C bulk write, one ACK (0)/NACK (1) byte per written byte
+int BP_BatchI2CBulk(BP_Batch *b, const uint8_t *data, int len)
+{
+	return BP_BatchBulk(b, data, len);
+}
+
+// I2C 0x08 write-then-read with start and stop
+int BP_BatchI2CWriteRead(BP_Batch *b, const uint8_t *data, uint16_t wlen, uint16_t rlen)
+{
+	uint8_t cmd[5 + BP_BATCH_SIZE];
+
+	if (wlen > BP_BATCH_SIZE - 5)
+		return ERR;
+
+	cmd[0] = 0x08;
+	cmd[1] = wlen >> 8;
+	cmd[2] = wlen;
+	cmd[3] = rlen >> 8;
+	cmd[4] = rlen;
+	memcpy(&cmd[5], data, wlen);
+
+	return BP_BatchAdd(b, cmd, wlen + 5, 1, rlen);
+}
+
+// raw-wire bulk, read bytes in 3-wire mode, 0x01 per byte in 2-wire mode
+int BP_BatchRawBulk(BP_Batch *b, const uint8_t *data, int len)
+{
+	return BP_BatchBulk(b, data, len);
+}
+
+// UART bridge bulk write, 0x01 per byte
+int BP_BatchUARTWrite(BP_Batch *b, const uint8_t *data, int len)
+{
+	return BP_BatchBulk(b, data, len);
+}
+
+// read exactly len bytes, ERR if the Bus Pirate went quiet
+static int BP_ReadReply(int fd, uint8_t *buf, int len)
+{
+	int got = 0, res;
+
+	while (got < len) {
+		res = serial_read(fd, (char *)buf + got, len - got);
+		if (res <= 0)
+			return ERR;
+		got += res;
+	}
+	return got;
+}
+
+// write queued bytes up to offset upto
+static int BP_BatchPump(BP_Batch *b, int *sent, int upto)
+{
+	int n = upto - *sent;
+
+	if (n <= 0)
+		return 0;
+
+	if (serial_write(b->fd, (char *)&b->cmd[*sent], n) != n) {
+		fprintf(stderr, " Error writing batch\n");
+		return ERR;
+	}
+	*sent += n;
+	b->counters.bytes_out += n;
+
+	return 0;
+}
+
+/*
+ * How far the batch may be written while the replies of item i are read.
+ * pos is where item i starts, done how much of the batch the Bus Pirate is
+ * known to have read.
+ */
+static int BP_BatchLimit(BP_Batch *b, int i, int pos, int done)
+{
+	int end = pos, lim;
+
+	//up to and including the next command that answers more than it sends
+	for (; i < b->items; i++) {
+		end += b->item[i].cmd_len;
+		if (b->item[i].reply_len + b->item[i].status > b->item[i].cmd_len)
+			break;
+	}
+
+	if (b->window > 0) {
+		lim = done + b->window;
+		if (lim < end)
+			end = lim;
+	}
+
+	return end;
+}
+
+/*
+ * Send the queued commands and parse their replies, returns the number of
+ * commands answered with 0x00, or ERR when replies were lost. After ERR the
+ * Bus Pirate is put back into BBIO and the batch mode, the batch is kept so
+ * it can be run again.
+ */
+int BP_BatchRun(BP_Batch *b, uint8_t *reply, int reply_size)
+{
+	uint8_t st;
+	uint32_t started = BP_Milliseconds();
+	int sent = 0, parsed = 0, pos = 0, out = 0, failed = 0;
+	int j, lim;
+
+	if (reply_size < b->reply_len) {
+		fprintf(stderr, " Reply buffer too small, need %i bytes\n", b->reply_len);
+		return ERR;
+	}
+
+	b->counters.batches++;
 
+	for (parsed = 0; parsed < b->items; parsed++) {
+		BP_BatchItem *it = &b->item[parsed];
+
+		//the Bus Pirate answered everything before this item and is reading it
+		lim = BP_BatchLimit(b, parsed, pos, pos);
+
+		//a command that is not paced is read in one go
+		if (!it->paced && lim < pos + it->cmd_len)
+			lim = pos + it->cmd_len;
+
+		if (BP_BatchPump(b, &sent, lim) < 0)
+			goto Lost;
+
+		if (it->status) {
+			if (BP_ReadReply(b->fd, &st, 1) < 0)
+				goto Lost;
+			b->counters.bytes_in++;
+
+			if (st != 0x01) {
+				it->failed = 1;
+				failed++;
+				b->counters.errors++;
+				memset(&reply[out], 0, it->reply_len);
+				out += it->reply_len;
+				b->counters.commands++;
+				pos += it->cmd_len;
+				continue;
+			}
+		}
+
+		if (it->paced && b->window > 0) {
+			//every reply byte frees a byte of the window
+			for (j = 0; j < it->reply_len; j++) {
+				if (BP_BatchPump(b, &sent, BP_BatchLimit(b, parsed, pos, pos + 1 + j)) < 0)
+					goto Lost;
+				if (BP_ReadReply(b->fd, &reply[out], 1) < 0)
+					goto Lost;
+				out++;
+			}
+			b->counters.bytes_in += it->reply_len;
+		} else if (it->reply_len > 0) {
+			if (BP_ReadReply(b->fd, &reply[out], it->reply_len) < 0)
+				goto Lost;
+			b->counters.bytes_in += it->reply_len;
+			out += it->reply_len;
+		}
+		b->counters.commands++;
+		pos += it->cmd_len;
+	}
+
+	b->counters.msec += BP_Milliseconds() - started;
+	return failed;
+
+Lost:
+	fprintf(stderr, " Bus Pirate stopped answering after %i of %i commands\n", parsed, b->items);
+	b->counters.timeouts++;
+	b->counters.msec += BP_Milliseconds() - started;
+	BP_Recover(b);
+	return ERR;
+}
+
+// enter BBIO and the batch mode again after lost replies
+int BP_Recover(BP_Batch *b)
+{
+	b->counters.recoveries++;
+
+	return BP_Resync(b->fd, b->mode, NULL);
+}
+
+void BP_PrintCounters(const BP_Counters *c)
+{
+	printf(" Commands: %u in %u batches, %u errors, %u timeouts, %u recoveries\n",
+		c->commands, c->batches, c->errors, c->timeouts, c->recoveries);
+	printf(" Bytes: %u out, %u in, %u ms", c->bytes_out, c->bytes_in, c->msec);
+	if (c->msec > 0)
+		printf(", %u bytes/s", (uint32_t)(((uint64_t)(c->bytes_out + c->bytes_in) * 1000) / c->msec));
+	printf("\n");
+}
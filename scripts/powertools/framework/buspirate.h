@@ -4,10 +4,6 @@
 #include <stdint.h>
 
 
-
-#endif
-
-
 #define ERR  -1
 #define BBIO 0x00
 #define SPI 0x01
@@ -21,3 +17,89 @@ uint32_t BP_WriteToPirate(int , char *);
 int BP_EnableBinary(int);
 int BP_EnableMode(int , char );
 uint32_t BP_WriteToPirateNoCheck(int fd, char * val);
+
+/*
+ * Resynchronisation
+ *
+ * BP_Resync brings the Bus Pirate into a binary mode from the terminal, BBIO
+ * or any sub-mode, and skips the resets when the version string shows it is
+ * already in the wanted sub-mode. BP_EnableBinary and BP_Recover use it.
+ */
+
+typedef struct {
+	char found;             //sub-mode that answered the version probe, ERR if none
+	int resets;             //0x00 bytes sent
+	int stale;              //input bytes discarded
+	uint32_t msec;          //time taken
+} BP_ResyncInfo;
+
+int BP_Resync(int fd, char mode, BP_ResyncInfo *info);
+
+/*
+ * Batched binary mode access
+ *
+ * Commands are queued with the BP_Batch* builders and sent with BP_BatchRun,
+ * which writes them ahead of the replies and parses the replies in order.
+ * Nothing is written past a command whose reply is longer than the command
+ * itself, the Bus Pirate does not read while it answers. While a slow bus
+ * keeps it busy, the small UART receive FIFO of a v3 is the only buffer, so
+ * no more than BP_RX_FIFO bytes are written ahead of what the replies show
+ * was read. Bulk transfers answer every data byte and keep that window
+ * moving. BP_BatchSetBusSpeed lifts the limit for a bus faster than the UART.
+ *
+ * Data bytes of all replies are stored back to back in the reply buffer, the
+ * status bytes are stripped. A command answered with 0x00 (NACK, bad length)
+ * leaves its data zero filled so later offsets stay valid.
+ */
+
+#define BP_BATCH_SIZE   4096    //bytes of queued commands
+#define BP_BATCH_ITEMS  512     //queued commands
+#define BP_RX_FIFO      4       //bytes a busy v3 can take, its UART receive FIFO
+
+typedef struct {
+	uint32_t commands;      //commands answered
+	uint32_t batches;       //BP_BatchRun calls
+	uint32_t bytes_out;
+	uint32_t bytes_in;
+	uint32_t errors;        //commands answered with 0x00
+	uint32_t timeouts;      //batches that lost their replies
+	uint32_t recoveries;    //times the mode was entered again after a timeout
+	uint32_t msec;          //time spent in BP_BatchRun
+} BP_Counters;
+
+typedef struct {
+	uint16_t cmd_len;
+	uint16_t reply_len;     //reply bytes after the status byte, or all of them without status
+	uint8_t  status;        //first reply byte is 0x01 OK / 0x00 failed
+	uint8_t  paced;         //bulk, each reply byte after the status acks a data byte
+	uint8_t  failed;        //set by BP_BatchRun
+} BP_BatchItem;
+
+typedef struct {
+	int fd;
+	char mode;              //mode entered again after a timeout
+	uint8_t cmd[BP_BATCH_SIZE];
+	int cmd_len;
+	BP_BatchItem item[BP_BATCH_ITEMS];
+	int items;
+	int reply_len;          //data bytes BP_BatchRun will store
+	int window;             //bytes written ahead of the replies, 0 for no limit
+	BP_Counters counters;
+} BP_Batch;
+
+void BP_BatchInit(BP_Batch *b, int fd, char mode);
+void BP_BatchClear(BP_Batch *b);
+void BP_BatchSetBusSpeed(BP_Batch *b, uint32_t bus_hz, uint32_t baud);
+int BP_BatchAdd(BP_Batch *b, const uint8_t *cmd, int cmd_len, int status, int reply_len);
+int BP_BatchCommand(BP_Batch *b, uint8_t cmd);
+int BP_BatchSPIBulk(BP_Batch *b, const uint8_t *data, int len);
+int BP_BatchSPIWriteRead(BP_Batch *b, const uint8_t *data, uint16_t wlen, uint16_t rlen, int cs);
+int BP_BatchI2CBulk(BP_Batch *b, const uint8_t *data, int len);
+int BP_BatchI2CWriteRead(BP_Batch *b, const uint8_t *data, uint16_t wlen, uint16_t rlen);
+int BP_BatchRawBulk(BP_Batch *b, const uint8_t *data, int len);
+int BP_BatchUARTWrite(BP_Batch *b, const uint8_t *data, int len);
+int BP_BatchRun(BP_Batch *b, uint8_t *reply, int reply_size);
+int BP_Recover(BP_Batch *b);
+void BP_PrintCounters(const BP_Counters *c);
+
+#endif
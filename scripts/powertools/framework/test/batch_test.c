@@ -0,0 +1,299 @@
+/*
+ * Host test of the BP_Batch pipelining and recovery in buspirate.c
+ *
+ * serial_read/serial_write are replaced by a simulated Bus Pirate in SPI
+ * mode. It runs on a virtual clock: host bytes arrive one UART byte time
+ * apart, a bulk transfer byte keeps it busy for the bus byte time, and the
+ * receive FIFO overruns if more than BP_RX_FIFO bytes are waiting when it
+ * gets to read the next one. Replies go to a pipe, so the select()/read()
+ * path of BP_Resync sees them too.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/select.h>
+#include "serial.h"
+#include "buspirate.h"
+
+int disable_comport = 0;
+int dumphandle = -1;
+int verbose = 0;
+int modem = 0;
+
+#define SIM_BAUD    115200
+#define SIM_MAX     65536
+
+static struct {
+	int rd, wr;                     //pipe, the host reads replies from rd
+	double now;                     //host clock, us
+	double byte_us;                 //UART byte time
+	double bus_us;                  //bus time of one transferred byte
+
+	double arrival[SIM_MAX];        //host bytes and when they reach the Bus Pirate
+	uint8_t in[SIM_MAX];
+	int in_len, in_pos;
+
+	double reply_at[SIM_MAX];       //reply bytes and when they are sent
+	int out_len;
+
+	double t;                       //Bus Pirate clock
+	int mode;                       //BBIO or SPI
+	int bulk;                       //data bytes left of a bulk transfer
+	int overruns;
+	int drop_in;                    //lose the nth host byte, -1 for none
+} sim;
+
+static void sim_reset(double bus_hz)
+{
+	int p[2];
+
+	if (sim.rd)
+		close(sim.rd), close(sim.wr);
+	memset(&sim, 0, sizeof(sim));
+	if (pipe(p) != 0)
+		exit(1);
+	sim.rd = p[0];
+	sim.wr = p[1];
+	sim.byte_us = 10e6 / SIM_BAUD;
+	sim.bus_us = 8e6 / bus_hz;
+	sim.mode = SPI;
+	sim.drop_in = -1;
+}
+
+static void sim_reply(const char *buf, int len)
+{
+	int i;
+
+	for (i = 0; i < len; i++)
+		sim.reply_at[sim.out_len++] = sim.t;
+	if (write(sim.wr, buf, len) != len)
+		exit(1);
+}
+
+// next host byte, -1 if it was not written yet
+static int sim_peek(void)
+{
+	int i, waiting = 0;
+
+	if (sim.in_pos >= sim.in_len)
+		return -1;
+	if (sim.t < sim.arrival[sim.in_pos])
+		sim.t = sim.arrival[sim.in_pos];
+	//everything that came in while we were busy sat in the FIFO
+	for (i = sim.in_pos; i < sim.in_len && sim.arrival[i] <= sim.t; i++)
+		waiting++;
+	if (waiting > BP_RX_FIFO)
+		sim.overruns++;
+	return sim.in[sim.in_pos];
+}
+
+// run the Bus Pirate until it needs a byte that was not sent yet
+static void sim_run(void)
+{
+	uint8_t c;
+	int d;
+
+	while ((d = sim_peek()) >= 0) {
+		c = d;
+		sim.in_pos++;
+
+		if (sim.bulk > 0) {
+			//read byte for every byte written
+			sim.bulk--;
+			sim.t += sim.bus_us;
+			c ^= 0xFF;
+			sim_reply((char *)&c, 1);
+			continue;
+		}
+
+		if (sim.mode == BBIO) {
+			if (c == 0x00)
+				sim_reply("BBIO1", 5);
+			else if (c == 0x01) {
+				sim.mode = SPI;
+				sim_reply("SPI1", 4);
+			}
+			continue;
+		}
+
+		if ((c & 0xF0) == 0x10) {
+			sim.bulk = (c & 0x0F) + 1;
+			sim_reply("\x01", 1);
+			continue;
+		}
+
+		if (c == 0x00) {
+			sim.mode = BBIO;
+			sim_reply("BBIO1", 5);
+		} else if (c == 0x01) {
+			sim_reply("SPI1", 4);
+		} else {
+			sim_reply("\x01", 1); //CS, config, speed
+		}
+	}
+}
+
+// host clock catches up with the replies it has read
+static void sim_sync(void)
+{
+	int queued = 0, consumed;
+
+	ioctl(sim.rd, FIONREAD, &queued);
+	consumed = sim.out_len - queued;
+	if (consumed > 0 && sim.now < sim.reply_at[consumed - 1])
+		sim.now = sim.reply_at[consumed - 1];
+}
+
+int serial_write(int fd, char *buf, int size)
+{
+	int i;
+
+	sim_sync();
+	for (i = 0; i < size; i++) {
+		if (sim.drop_in-- == 0)
+			continue;
+		sim.now += sim.byte_us;
+		sim.arrival[sim.in_len] = sim.now;
+		sim.in[sim.in_len++] = buf[i];
+	}
+	sim_run();
+	return size;
+}
+
+int serial_read(int fd, char *buf, int size)
+{
+	struct timeval tv = { 0, 50000 };
+	fd_set fds;
+	int n;
+
+	FD_ZERO(&fds);
+	FD_SET(fd, &fds);
+	if (select(fd + 1, &fds, NULL, NULL, &tv) <= 0)
+		return 0;
+	n = read(fd, buf, size);
+	sim_sync();
+	return n;
+}
+
+static int failures;
+
+#define CHECK(cond, ...) do { if (!(cond)) { printf(" FAIL: " __VA_ARGS__); printf("\n"); failures++; } } while (0)
+
+// CS low, 48 bytes of bulk, CS high, the LCD tester pattern
+static void fill(BP_Batch *b, uint8_t *data)
+{
+	int i;
+
+	for (i = 0; i < 48; i++)
+		data[i] = i * 7;
+
+	BP_BatchClear(b);
+	BP_BatchCommand(b, 0x02);
+	BP_BatchSPIBulk(b, data, 48);
+	BP_BatchCommand(b, 0x03);
+}
+
+static int check_reply(const uint8_t *data, const uint8_t *reply)
+{
+	int i;
+
+	for (i = 0; i < 48; i++)
+		if (reply[i] != (uint8_t)(data[i] ^ 0xFF))
+			return 0;
+	return 1;
+}
+
+static void test_slow_bus(void)
+{
+	BP_Batch b;
+	uint8_t data[48], reply[48];
+	int res;
+
+	//30kHz SPI, a byte takes 270us against 87us on the UART
+	sim_reset(30000);
+	BP_BatchInit(&b, sim.rd, SPI);
+	BP_BatchSetBusSpeed(&b, 30000, SIM_BAUD);
+	fill(&b, data);
+
+	res = BP_BatchRun(&b, reply, sizeof(reply));
+	CHECK(res == 0, "slow bus, BP_BatchRun returned %i", res);
+	CHECK(sim.overruns == 0, "slow bus, %i FIFO overruns", sim.overruns);
+	CHECK(check_reply(data, reply), "slow bus, wrong reply data");
+	CHECK(b.counters.commands == 5, "slow bus, %u commands answered", b.counters.commands);
+}
+
+static void test_unpaced_overruns(void)
+{
+	BP_Batch b;
+	uint8_t data[48], reply[48];
+
+	//what the window prevents, the sim must see it
+	sim_reset(30000);
+	BP_BatchInit(&b, sim.rd, SPI);
+	b.window = 0;
+	fill(&b, data);
+
+	BP_BatchRun(&b, reply, sizeof(reply));
+	CHECK(sim.overruns > 0, "no window, the sim saw no overrun");
+}
+
+static void test_fast_bus(void)
+{
+	BP_Batch b;
+	uint8_t data[48], reply[48];
+	int res;
+
+	//2.6MHz SPI keeps up with the UART, everything goes out in one write
+	sim_reset(2600000);
+	BP_BatchInit(&b, sim.rd, SPI);
+	BP_BatchSetBusSpeed(&b, 2600000, SIM_BAUD);
+	CHECK(b.window == 0, "fast bus, window %i", b.window);
+	fill(&b, data);
+
+	res = BP_BatchRun(&b, reply, sizeof(reply));
+	CHECK(res == 0, "fast bus, BP_BatchRun returned %i", res);
+	CHECK(sim.overruns == 0, "fast bus, %i FIFO overruns", sim.overruns);
+	CHECK(check_reply(data, reply), "fast bus, wrong reply data");
+}
+
+static void test_recover(void)
+{
+	BP_Batch b;
+	uint8_t data[48], reply[48];
+	int res;
+
+	//the last data byte is lost, the Bus Pirate takes CS high as data and its reply never comes
+	sim_reset(2600000);
+	BP_BatchInit(&b, sim.rd, SPI);
+	BP_BatchSetBusSpeed(&b, 2600000, SIM_BAUD);
+	fill(&b, data);
+	sim.drop_in = 51;
+
+	res = BP_BatchRun(&b, reply, sizeof(reply));
+	CHECK(res == ERR, "lost byte, BP_BatchRun returned %i", res);
+	CHECK(b.counters.timeouts == 1, "lost byte, %u timeouts", b.counters.timeouts);
+	CHECK(b.counters.recoveries == 1, "lost byte, %u recoveries", b.counters.recoveries);
+	CHECK(sim.mode == SPI, "lost byte, not back in SPI mode");
+
+	//the batch is kept and runs again
+	res = BP_BatchRun(&b, reply, sizeof(reply));
+	CHECK(res == 0, "after recovery, BP_BatchRun returned %i", res);
+	CHECK(check_reply(data, reply), "after recovery, wrong reply data");
+}
+
+int main(void)
+{
+	test_slow_bus();
+	test_unpaced_overruns();
+	test_fast_bus();
+	test_recover();
+
+	if (failures) {
+		printf("%i checks failed\n", failures);
+		return 1;
+	}
+	printf("batch tests passed\n");
+	return 0;
+}
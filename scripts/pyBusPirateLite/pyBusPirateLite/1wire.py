@@ -28,9 +28,13 @@ inary1WIRE mode:
 # 00000100 - read byte
 # 00001000 - ROM search macro (0xf0)
 # 00001001 - ALARM search macro (0xec)
+# 00001010 - ROM search roster, all addresses in one CRC checked reply
+# 00001011 - ALARM search roster
+# 00001100 - Continue search roster, next batch when the last one had bit 0 set
 # 0001xxxx – Bulk transfer, send 1-16 bytes (0=1byte!)
 # 0100wxyz – Configure peripherals w=power, x=pullups, y=AUX, z=CS (
 # 0101wxyz – read peripherals (planned, not implemented)
+# 0110xxxx - Set speed, 0=standard, 1=overdrive, 2=overdrive skip ROM, 3=overdrive match ROM
 """
 
 from .BitBang import *
@@ -49,6 +53,20 @@ class _1WIRE(BBIO):
 		self.timeout(0.1)
 		return self.response(1)
 
+	def overdrive_skip_rom(self):
+		self.port.write("\x62")
+		self.timeout(0.1)
+		return self.response(1)
+
+	def overdrive_match_rom(self, rom):
+		self.port.write("\x63")
+		self.timeout(0.1)
+		if not self.response(1): return 0
+		self.port.write(chr(0x10 | (len(rom)-1)))
+		for byte in rom:
+			self.port.write(chr(byte))
+		return self.response(len(rom)+1, True) == chr(0x01) * (len(rom)+1)
+
 	def rom_search(self):
 		self.port.write("\x08")
 		self.timeout(0.1)
@@ -59,6 +77,26 @@ class _1WIRE(BBIO):
 		self.timeout(0.1)
 		self.__group_response()
 
+	def rom_search_roster(self):
+		return self.__roster_response("\x0A")
+
+	def alarm_search_roster(self):
+		return self.__roster_response("\x0B")
+
+	def __roster_response(self, command):
+		"""Returns (status, [rom, ...]) for the whole bus, status bit 1 = search error."""
+		roms = []
+		while True:
+			self.port.write(command)
+			header = self.port.read(3)
+			if len(header) != 3 or ord(header[0]) != 1: return None
+			data = self.port.read(ord(header[2]) * 8)
+			roms += [data[i:i+8] for i in range(0, len(data), 8)]
+			# bit 0 = more devices, fetch the next batch
+			if not ord(header[1]) & 0x01: break
+			command = "\x0C"
+		return ord(header[1]), roms
+
 	def __group_response(self):
 		EOD = [0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff]
 		while (data = self.port.read(8)) != EOD:
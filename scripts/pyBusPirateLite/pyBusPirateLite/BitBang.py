@@ -22,6 +22,7 @@ along with pyBusPirate.  If not, see <http://www.gnu.org/licenses/>.
 
 import select
 import serial
+import struct
 
 """
 PICSPEED = 24MHZ / 16MIPS
@@ -153,6 +154,42 @@ class BBIO:
 		self.timeout(0.1)
 		return self.response(2, True)
 
+	""" Performance Counters """
+	COUNTER_MODES = ("terminal", "bbio", "spi", "i2c", "uart", "1wire", "rawwire")
+	COUNTER_HANDLERS = ("spi_bulk", "spi_write_read", "i2c_bulk", "i2c_write_read", "rawwire_bulk")
+
+	def read_counters(self):
+		"""Returns the firmware counters as a dict, times in seconds."""
+		self.port.write("\x19")
+		length = ord(self.port.read(1))
+		data = self.port.read(length)
+		if len(data) != length or ord(data[0]) != 1: return None
+		modes, handlers = ord(data[1]), ord(data[2])
+		tick = 0.0000005
+		pos = 3
+		counters = {"clock": struct.unpack(">I", data[pos:pos+4])[0] * tick}
+		pos += 4
+		for i in range(modes):
+			name = i < len(self.COUNTER_MODES) and self.COUNTER_MODES[i] or "mode%d" % i
+			counters[name] = struct.unpack(">II", data[pos:pos+8])
+			pos += 8
+		wait, dropped, peak = struct.unpack(">IHH", data[pos:pos+8])
+		counters["host_wait"] = wait * tick
+		counters["uartbuf_dropped"] = dropped
+		counters["uartbuf_peak"] = peak
+		pos += 8
+		for i in range(handlers):
+			name = i < len(self.COUNTER_HANDLERS) and self.COUNTER_HANDLERS[i] or "handler%d" % i
+			calls, ticks, longest = struct.unpack(">III", data[pos:pos+12])
+			counters[name] = (calls, ticks * tick, longest * tick)
+			pos += 12
+		return counters
+
+	def clear_counters(self):
+		self.port.write("\x1A")
+		self.timeout(0.1)
+		return self.response()
+
 	""" General Commands for Higher-Level Modes """
 	def mode_string(self):
 		self.port.write("\x01")
@@ -64,3 +64,39 @@ class I2C(BBIO):
 		#self.timeout(0.1)
 		return self.response()
 
+
+	""" Timestamped sniffer """
+	SNIFF_TICK = 0.0000005
+
+	def sniff_records(self):
+		"""Starts the timestamped sniffer and yields its records as tuples:
+		("start", seconds since the previous start), ("stop",), ("ack", byte),
+		("nack", byte) and ("dropped", records lost). Keep reading after
+		stop_sniffer(), the generator ends at the sniffer's end record and the
+		port is then ready for the next command. Also ends if the port times
+		out."""
+		self.port.write("\x0E")
+		if self.response() != 1: return
+		while True:
+			kind = self.port.read(1)
+			if not kind: return
+			kind = ord(kind)
+			if kind == 0x01 or kind == 0x02:
+				data = self.port.read(kind == 0x01 and 2 or 4)
+				delta = 0
+				for c in data: delta = (delta << 8) | ord(c)
+				yield ("start", delta * self.SNIFF_TICK)
+			elif kind == 0x03:
+				yield ("stop",)
+			elif kind == 0x04 or kind == 0x05:
+				yield (kind == 0x04 and "ack" or "nack", ord(self.port.read(1)))
+			elif kind == 0x06:
+				data = self.port.read(2)
+				yield ("dropped", (ord(data[0]) << 8) | ord(data[1]))
+			elif kind == 0x00:
+				return # the end record, the sniffer stopped
+			else:
+				return # not a record, out of step
+
+	def stop_sniffer(self):
+		self.port.write("\x00")
@@ -9,12 +9,13 @@
 
 from .BitBang import *
 
-# 011000xx – Set speed, 3=~400kHz, 2=~100kHz, 1=~50kHz, 0=~5kHz
+# 01100xxx – Set speed, 4=~1.6MHz (normal outputs only), 3=~150kHz, 2=~100kHz, 1=~50kHz, 0=~5kHz
 class RAW_WIRESpeed:
 	_5KHZ = 0b000
 	_50KHZ = 0b001
 	_100KHZ = 0b010
-	_400KHZ = 0b011
+	_400KHZ = 0b011 # calculated ~150kHz, the name is kept
+	_1600KHZ = 0b100
 
 # 1000wxyz – Config, w=HiZ/3.3v, x=2/3wire, y=msb/lsb, z=not used
 
@@ -149,7 +150,7 @@ class RAW_WIRE(BBIO):
 	# def cfg_pins(self, pins=0): at BitBang upper class
 	
 	# 0110000x – Set speed, low (0=~5kHz) / high (1=~50kHz) changed in v4.2
-	# 011000xx – Set speed, 3=~400kHz, 2=~100kHz, 1=~50kHz, 0=~5kHz
+	# 01100xxx – Set speed, 4=~1.6MHz (normal outputs only), 3=~150kHz, 2=~100kHz, 1=~50kHz, 0=~5kHz
 	
 	#def set_speed(self, bus_speed=0): at BitBang upper class
 	
@@ -77,3 +77,58 @@ class SPI(BBIO):
 		self.timeout(0.1)
 		return self.response(1, True)
 
+
+	def stream_transfer(self, write_data, read_count, out=None, timeout=10):
+		"""Writes write_data and reads read_count bytes with CS held low, without
+		the 4096 byte limit of write-then-read. Read bytes go to out.write() if
+		given, or are returned."""
+		self.port.write("\x07" + struct.pack(">II", len(write_data), read_count))
+		if self.response() != 1: return None
+		# the Bus Pirate takes a terminal buffer at a time and answers each one
+		for offset in range(0, len(write_data), 4096):
+			self.port.write(write_data[offset:offset + 4096])
+			for i in range(timeout):
+				ack = self.port.read(1)
+				if ack: break
+			if ack != "\x01": return None
+		data = []
+		while read_count > 0:
+			chunk = self.port.read(min(read_count, 4096))
+			if not chunk: return None
+			if out is not None: out.write(chunk)
+			else: data.append(chunk)
+			read_count -= len(chunk)
+		return "".join(data)
+
+	def flash_crc32(self, address, length, timeout=60):
+		"""CRC32 of a 25 series flash range computed on the Bus Pirate, the
+		same value as zlib.crc32() of the data. Needs AVR extended commands
+		version 2."""
+		self.port.write("\x06\x03" + struct.pack(">II", address, length))
+		if self.response(2, True) != "\x01\x01": return None
+		data = ""
+		for i in range(timeout):
+			data += self.port.read(4 - len(data))
+			if len(data) == 4: return struct.unpack(">I", data)[0]
+		return None
+
+	def flash_program(self, address, data):
+		"""Programs up to 256 bytes into one page of a 25 series flash. Returns
+		once the page was handed to the flash, it is still being written while
+		the next command is sent. Needs AVR extended commands version 3."""
+		self.port.write("\x06\x04" + struct.pack(">IH", address, len(data)) + data)
+		return self.response(2, True) == "\x01\x01"
+
+	def flash_erase(self, address, timeout=3):
+		"""Erases the 4KB sector holding address, returns once it is blank."""
+		self.port.write("\x06\x05" + struct.pack(">I", address))
+		data = ""
+		for i in range(timeout):
+			data += self.port.read(2 - len(data))
+			if len(data) == 2: return data == "\x01\x01"
+		return False
+
+	def flash_wait(self):
+		"""Waits for the last page program to end."""
+		self.port.write("\x06\x06")
+		return self.response(2, True) == "\x01\x01"
@@ -20,7 +20,7 @@ You should have received a copy of the GNU General Public License
 along with pyBusPirate.  If not, see <http://www.gnu.org/licenses/>.
 """
 from serial.serialutil import SerialException
-import sys, optparse
+import sys, optparse, zlib
 from pyBusPirateLite.SPI import *
 
 def read_list_data(size):
@@ -50,6 +50,9 @@ def parse_prog_args():
 	parser.add_option("-e", "--erase",
 						action="store_const", dest="command", const="erase",
 						help="erase SPI")
+	parser.add_option("-c", "--verify",
+						action="store_const", dest="command", const="verify",
+						help="compare the flash with file, CRC32 computed on the Bus Pirate")
 	parser.add_option("-i", "--id",
 						action="store_const", dest="command", const="id",
 						help="print Chip ID")
@@ -78,7 +81,7 @@ if __name__ == '__main__':
 
 	if opt.command == "read":
 		f=open(args[0], 'wb')
-	elif opt.command == "write":
+	elif opt.command in ("write", "verify"):
 		f=open(args[0], 'rb')
 
 	try:
@@ -147,6 +150,17 @@ if __name__ == '__main__':
 			print "%02X " % ord(each),
 		print
 
+	elif opt.command == "verify":
+		image = f.read()
+		print "Verifying %d bytes: " % len(image),
+		crc = spi.flash_crc32(0, len(image))
+		if crc is None:
+			print "no answer."
+		elif crc == zlib.crc32(image) & 0xFFFFFFFF:
+			print "OK, CRC32 %08X." % crc
+		else:
+			print "MISMATCH, flash CRC32 %08X, file %08X." % (crc, zlib.crc32(image) & 0xFFFFFFFF)
+
 	elif opt.command == "erase":
 		pass
 
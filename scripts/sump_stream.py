@@ -0,0 +1,244 @@
+#!/usr/bin/env python
+### Bus Pirate v4 SUMP stream receiver
+#
+# Puts the Bus Pirate in SUMP mode, starts a sample stream (SUMP_STREAM,
+# Bus Pirate extension) and writes it to disk run-length encoded until
+# interrupted with Ctrl-C or until the requested number of samples arrived.
+#
+# Output file format (all integers little endian):
+#
+#   "BPSR" 0x01 RATE(4 bytes, Hz)          header
+#   VALUE RUN                              VALUE (0x00-0x1F) held for RUN samples
+#   0xFE LOST                              LOST samples dropped by the device
+#
+# RUN and LOST are LEB128 varints: 7 bits per byte, least significant group
+# first, bit 7 set on every byte but the last.
+#
+# Published in the public domain.
+# For details see: http://creativecommons.org/publicdomain/zero/1.0/.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+import getopt
+import struct
+import sys
+
+SUMP_RESET = 0x00
+SUMP_ID = 0x02
+SUMP_STREAM = 0x0A
+SUMP_DIV = 0x80
+
+STREAM_OVERRUN = 0xFE
+STREAM_END = 0xFF
+
+FILE_MAGIC = b"BPSR\x01"
+FILE_GAP = 0xFE
+
+
+def usage():
+	print("Bus Pirate SUMP stream receiver")
+	print("\nsump_stream.py -d DEVICE -o FILE [options]")
+	print("\t-d --device=DEVICE\t- serial device (default /dev/buspirate)")
+	print("\t-o --output=FILE\t- output file")
+	print("\t-r --rate=HZ\t\t- sample rate (default 10000, device limits apply)")
+	print("\t-n --samples=N\t\t- stop after N samples (default: until Ctrl-C)")
+	print("\t-x --dump=FILE\t\t- print the runs stored in FILE and exit")
+
+
+def varint(value):
+	out = bytearray()
+	while True:
+		byte = value & 0x7F
+		value >>= 7
+		if value:
+			out.append(byte | 0x80)
+		else:
+			out.append(byte)
+			return bytes(out)
+
+
+def read_varint(data, pos):
+	value = 0
+	shift = 0
+	while True:
+		byte = data[pos]
+		pos += 1
+		value |= (byte & 0x7F) << shift
+		shift += 7
+		if not byte & 0x80:
+			return value, pos
+
+
+class RunWriter:
+	"""Collapses samples into (value, run) records."""
+
+	def __init__(self, out, rate):
+		self.out = out
+		self.value = None
+		self.run = 0
+		self.samples = 0
+		self.lost = 0
+		out.write(FILE_MAGIC + struct.pack("<I", rate))
+
+	def flush(self):
+		if self.run:
+			self.out.write(bytes(bytearray([self.value])) + varint(self.run))
+		self.run = 0
+
+	def sample(self, value):
+		self.samples += 1
+		if value == self.value:
+			self.run += 1
+			return
+		self.flush()
+		self.value = value
+		self.run = 1
+
+	def gap(self, lost):
+		self.flush()
+		self.value = None
+		self.lost += lost
+		self.out.write(bytes(bytearray([FILE_GAP])) + varint(lost))
+
+
+def read_exact(port, count):
+	data = bytearray()
+	while len(data) < count:
+		chunk = port.read(count - len(data))
+		if not chunk:
+			raise IOError("Bus Pirate stopped answering")
+		data += chunk
+	return bytes(data)
+
+
+def enter_sump(port):
+	# From the terminal: five zeroes then ^B enter SUMP mode, which answers
+	# with its ID right away.
+	port.write(bytes(bytearray([SUMP_RESET] * 5 + [SUMP_ID])))
+	reply = read_exact(port, 4)
+	if reply != b"1ALS":
+		raise IOError("SUMP mode not entered, got %r" % reply)
+
+
+def receive(port, writer, limit):
+	"""Parses the stream until its end marker, returns False on a bad byte."""
+	stop_sent = False
+	while True:
+		try:
+			data = bytearray(port.read(4096))
+			stop = limit and writer.samples >= limit
+		except KeyboardInterrupt:
+			data = bytearray()
+			stop = True
+		if stop and not stop_sent:
+			# Any byte ends the stream, the device answers with STREAM_END.
+			port.write(b"\x01")
+			stop_sent = True
+		pos = 0
+		while pos < len(data):
+			byte = data[pos]
+			pos += 1
+			if byte < 0x20:
+				writer.sample(byte)
+			elif byte == STREAM_OVERRUN:
+				if len(data) < pos + 2:
+					data += bytearray(read_exact(port, pos + 2 - len(data)))
+				writer.gap(data[pos] | (data[pos + 1] << 8))
+				pos += 2
+			elif byte == STREAM_END:
+				return True
+			else:
+				print("Unexpected byte 0x%02X in stream" % byte)
+				return False
+
+
+def dump(path):
+	data = bytearray(open(path, "rb").read())
+	if bytes(data[:5]) != FILE_MAGIC:
+		print("%s: not a stream file" % path)
+		return 1
+	rate = struct.unpack("<I", bytes(data[5:9]))[0]
+	print("rate %u Hz" % rate)
+	pos = 9
+	time = 0
+	while pos < len(data):
+		value = data[pos]
+		count, pos = read_varint(data, pos + 1)
+		if value == FILE_GAP:
+			print("%10u  lost %u" % (time, count))
+		else:
+			print("%10u  0x%02X x %u" % (time, value, count))
+		time += count
+	return 0
+
+
+def main():
+	try:
+		import serial
+	except ImportError:
+		serial = None
+
+	device = "/dev/buspirate"
+	output = None
+	rate = 10000
+	limit = 0
+
+	try:
+		opts, args = getopt.getopt(sys.argv[1:], "hd:o:r:n:x:", ["help", "device=", "output=", "rate=", "samples=", "dump="])
+	except getopt.GetoptError as err:
+		print(str(err))
+		usage()
+		return 2
+
+	for opt, arg in opts:
+		if opt in ("-h", "--help"):
+			usage()
+			return 0
+		elif opt in ("-d", "--device"):
+			device = arg
+		elif opt in ("-o", "--output"):
+			output = arg
+		elif opt in ("-r", "--rate"):
+			rate = int(arg)
+		elif opt in ("-n", "--samples"):
+			limit = int(arg)
+		elif opt in ("-x", "--dump"):
+			return dump(arg)
+
+	if output is None or rate <= 0:
+		usage()
+		return 2
+
+	if serial is None:
+		print("pyserial is needed to talk to the Bus Pirate")
+		return 1
+
+	port = serial.Serial(device, 115200, timeout=1)
+	enter_sump(port)
+
+	# The divider is relative to the 100MHz SUMP reference clock.
+	divider = max(int(100000000 // rate) - 1, 0)
+	port.write(struct.pack("<BI", SUMP_DIV, divider))
+	port.write(bytes(bytearray([SUMP_STREAM])))
+
+	header = read_exact(port, 8)
+	if header[:4] != b"BPS1":
+		print("No stream header, got %r" % header)
+		return 1
+	actual = struct.unpack("<I", header[4:])[0]
+	print("Streaming at %u Hz, Ctrl-C to stop" % actual)
+
+	with open(output, "wb") as out:
+		writer = RunWriter(out, actual)
+		ok = receive(port, writer, limit)
+		writer.flush()
+
+	print("%u samples, %u lost" % (writer.samples, writer.lost))
+	port.close()
+	return 0 if ok else 1
+
+
+if __name__ == "__main__":
+	sys.exit(main())